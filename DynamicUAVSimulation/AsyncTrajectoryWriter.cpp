@@ -0,0 +1,221 @@
+#include "AsyncTrajectoryWriter.h"
+
+#include <algorithm>
+#include <iostream>
+#include "Profiler.h"
+
+// Constructor - allocates the buffers and starts the writer thread
+AsyncTrajectoryWriter::AsyncTrajectoryWriter(const std::vector<TrajectorySink*>& outputs, std::size_t fleetSize,
+                                             std::size_t samplesPerSync, std::size_t bufferBytes, int bufferCount,
+                                             BackpressurePolicy policy)
+    : outputs(outputs), fleetSize(fleetSize), policy(policy) {
+    samplesPerSync = std::max<std::size_t>(samplesPerSync, 1);
+    const std::size_t periodBytes = std::max<std::size_t>(fleetSize, 1) * samplesPerSync * sizeof(TrajectorySample);
+    periodsPerBuffer = std::max<std::size_t>(bufferBytes / periodBytes, 1);
+    slotsPerUav = periodsPerBuffer * samplesPerSync;
+
+    buffers.resize(static_cast<std::size_t>(std::max(bufferCount, 2)));
+    for (Buffer& buffer : buffers) {
+        buffer.samples.resize(fleetSize * slotsPerUav);
+        buffer.counts.assign(fleetSize, 0);
+        buffer.spilled.resize(fleetSize);
+        buffer.periodEnds.assign(periodsPerBuffer * fleetSize, 0);
+        buffer.times.assign(periodsPerBuffer, 0.0);
+        freeBuffers.push_back(&buffer);
+    }
+    current = freeBuffers.back();
+    freeBuffers.pop_back();
+    writer = std::thread(&AsyncTrajectoryWriter::writeLoop, this);
+}
+
+// Destructor
+AsyncTrajectoryWriter::~AsyncTrajectoryWriter() {
+    close();
+}
+
+// Copies the sample into the next slot of its UAV. Only one thread records a given UAV at a time.
+void AsyncTrajectoryWriter::record(std::size_t index, const TrajectorySample& sample) {
+    std::uint32_t& count = current->counts[index];
+    if (count < slotsPerUav) {
+        current->samples[index * slotsPerUav + count] = sample;
+        ++count;
+    }
+    else {
+        // More samples than announced (e.g. an output interval shorter than the step)
+        current->spilled[index].push_back(sample);
+    }
+}
+
+// Ends a synchronization period; hands the buffer over when it cannot take another period.
+void AsyncTrajectoryWriter::synchronize(double time) {
+    std::uint32_t* ends = current->periodEnds.data() + current->periods * fleetSize;
+    for (std::size_t i = 0; i < fleetSize; ++i) {
+        ends[i] = current->counts[i] + static_cast<std::uint32_t>(current->spilled[i].size());
+    }
+    current->times[current->periods] = time;
+    if (++current->periods >= periodsPerBuffer) {
+        publish(policy == DropSamples);
+    }
+}
+
+// True if the buffer holds neither a period nor a sample recorded after the last one.
+bool AsyncTrajectoryWriter::Buffer::empty() const {
+    if (periods > 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] > 0 || !spilled[i].empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hands the current buffer over to the writer thread and takes a free one.
+void AsyncTrajectoryWriter::publish(bool dropWhenFull) {
+    if (current->empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeBuffers.empty() && dropWhenFull) {
+        lock.unlock();
+        std::uint64_t samples = 0;
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            samples += current->counts[i] + current->spilled[i].size();
+            current->counts[i] = 0;
+            current->spilled[i].clear();
+        }
+        current->periods = 0;
+        dropped += samples;
+        UAVSIM_PROFILE_COUNT_N(OutputDroppedSamples, samples);
+        return;
+    }
+    if (freeBuffers.empty()) {
+        UAVSIM_PROFILE_SCOPE(PhaseBackpressure);
+        bufferFreed.wait(lock, [this] { return !freeBuffers.empty(); });
+    }
+    queue.push_back(current);
+    current = freeBuffers.back();
+    freeBuffers.pop_back();
+    lock.unlock();
+    wakeUp.notify_one();
+}
+
+// Publishes the current buffer and waits until the writer thread has written everything.
+// Nothing is dropped here: flushes and checkpoints need every sample.
+void AsyncTrajectoryWriter::drain() {
+    if (!writer.joinable()) {
+        return;
+    }
+    publish(false);
+    std::unique_lock<std::mutex> lock(mutex);
+    bufferFreed.wait(lock, [this] { return queue.empty() && !writing; });
+}
+
+// Waits for the writer thread, then flushes the outputs.
+void AsyncTrajectoryWriter::flush() {
+    drain();
+    for (TrajectorySink* output : outputs) {
+        output->flush();
+    }
+}
+
+// Returns the bytes written by the outputs.
+std::uint64_t AsyncTrajectoryWriter::bytesWritten() const {
+    std::uint64_t total = 0;
+    for (const TrajectorySink* output : outputs) {
+        total += output->bytesWritten();
+    }
+    return total;
+}
+
+// Saves the state of the outputs once they have written everything recorded so far.
+void AsyncTrajectoryWriter::saveState(StateWriter& state) const {
+    // Draining only moves samples from the buffers to the outputs, which is what the state describes
+    const_cast<AsyncTrajectoryWriter*>(this)->drain();
+    for (const TrajectorySink* output : outputs) {
+        output->saveState(state);
+    }
+}
+
+// Restores the state of the outputs (before the run, while the writer thread is idle).
+bool AsyncTrajectoryWriter::restoreState(StateReader& state) {
+    for (TrajectorySink* output : outputs) {
+        if (!output->restoreState(state)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes everything still buffered and stops the writer thread.
+void AsyncTrajectoryWriter::close() {
+    if (!writer.joinable()) {
+        return;
+    }
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    writer.join();
+    if (dropped > 0) {
+        std::cerr << "Warning: " << dropped << " trajectory samples were dropped (output slower than the simulation)"
+            << std::endl;
+    }
+}
+
+// Body of the writer thread.
+void AsyncTrajectoryWriter::writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeUp.wait(lock, [this] { return !queue.empty() || stopping; });
+        if (queue.empty()) {
+            return;
+        }
+        Buffer* buffer = queue.front();
+        queue.pop_front();
+        writing = true;
+
+        lock.unlock();
+        writeBuffer(*buffer);
+        lock.lock();
+        writing = false;
+        freeBuffers.push_back(buffer);
+        bufferFreed.notify_all();
+    }
+}
+
+// Passes the samples of a buffer to the outputs, period by period, and empties it.
+void AsyncTrajectoryWriter::writeBuffer(Buffer& buffer) {
+    UAVSIM_PROFILE_SCOPE(PhaseWrite);
+    // Passes the samples [begin, end) of a UAV; the spilled samples follow the slots
+    auto recordRange = [&](TrajectorySink* output, std::size_t i, std::uint32_t begin, std::uint32_t end) {
+        const TrajectorySample* slots = buffer.samples.data() + i * slotsPerUav;
+        for (std::uint32_t k = begin; k < end; ++k) {
+            output->record(i, k < buffer.counts[i] ? slots[k] : buffer.spilled[i][k - buffer.counts[i]]);
+        }
+    };
+    for (TrajectorySink* output : outputs) {
+        const std::uint32_t* previous = nullptr;
+        for (std::size_t period = 0; period < buffer.periods; ++period) {
+            const std::uint32_t* ends = buffer.periodEnds.data() + period * fleetSize;
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                recordRange(output, i, previous != nullptr ? previous[i] : 0, ends[i]);
+            }
+            output->synchronize(buffer.times[period]);
+            previous = ends;
+        }
+        // Samples recorded after the last synchronization (a flush between two of them)
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            std::uint32_t total = buffer.counts[i] + static_cast<std::uint32_t>(buffer.spilled[i].size());
+            recordRange(output, i, previous != nullptr ? previous[i] : 0, total);
+        }
+    }
+    std::fill(buffer.counts.begin(), buffer.counts.end(), 0);
+    for (auto& spilled : buffer.spilled) {
+        spilled.clear();
+    }
+    buffer.periods = 0;
+}
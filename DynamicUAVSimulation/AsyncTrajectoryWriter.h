@@ -0,0 +1,117 @@
+#pragma once
+#ifndef ASYNCTRAJECTORYWRITER_H
+#define ASYNCTRAJECTORYWRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TrajectorySink.h"
+
+// Moves the trajectory outputs (text and binary files) off the simulation threads.
+// record() only copies the raw sample into a preallocated buffer, in a slot reserved for its UAV,
+// so the engine threads never format or write anything. At a synchronization point a full buffer
+// is handed over to a writer thread, which passes its samples to the outputs (formatting and
+// writing them) while the engine fills the next buffer. With two buffers the writer works on one
+// while the engine fills the other; more buffers absorb slow disks for longer.
+// When all buffers are waiting for the writer, the engine either waits for one (no sample is
+// lost) or drops the buffer it just filled (the run is never slowed down by the disk).
+// The buffer remembers where every synchronization period ends, and the writer thread passes the
+// samples of each period to the outputs followed by synchronize() with the time of that period, as
+// a synchronous run would: the outputs flush and close their blocks at the same points, so their
+// files are identical to a synchronous run. Outputs that need a consistent view of the fleet at every synchronization (separation
+// monitor, recorder) must stay in front of the engine.
+class AsyncTrajectoryWriter : public TrajectorySink {
+public:
+    enum BackpressurePolicy {
+        WaitForBuffer = 0, // The engine waits until the writer frees a buffer
+        DropSamples = 1    // The engine drops the samples it just buffered
+    };
+
+    /**
+    * Allocates the buffers and starts the writer thread.
+    *
+    * @param outputs The sinks written by the writer thread.
+    * @param fleetSize The number of UAVs.
+    * @param samplesPerSync The most samples a UAV records between two synchronizations.
+    * @param bufferBytes The memory of one buffer; it holds as many synchronization periods as fit.
+    * @param bufferCount The number of buffers (at least 2).
+    * @param policy What the engine does when all buffers are waiting for the writer.
+    */
+    AsyncTrajectoryWriter(const std::vector<TrajectorySink*>& outputs, std::size_t fleetSize, std::size_t samplesPerSync,
+                          std::size_t bufferBytes, int bufferCount, BackpressurePolicy policy);
+    ~AsyncTrajectoryWriter() override;
+
+    AsyncTrajectoryWriter(const AsyncTrajectoryWriter&) = delete;
+    AsyncTrajectoryWriter& operator=(const AsyncTrajectoryWriter&) = delete;
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+
+    /**
+    * Waits until every buffered sample reached the outputs, then flushes them.
+    */
+    void flush() override;
+
+    /**
+    * Ends a synchronization period; hands the buffer over to the writer thread when it is full.
+    */
+    void synchronize(double time) override;
+
+    /**
+    * Returns the bytes written by the outputs; exact once the writer is flushed.
+    */
+    std::uint64_t bytesWritten() const override;
+
+    /**
+    * Waits until every buffered sample reached the outputs, then saves their state.
+    */
+    void saveState(StateWriter& state) const override;
+    bool restoreState(StateReader& state) override;
+
+    /**
+    * Writes everything still buffered and stops the writer thread.
+    */
+    void close();
+
+    std::uint64_t getDroppedCount() const { return dropped; }
+
+private:
+    struct Buffer {
+        std::vector<TrajectorySample> samples;  // `slotsPerUav` slots per UAV
+        std::vector<std::uint32_t> counts;      // Samples in the slots of every UAV
+        std::vector<std::vector<TrajectorySample>> spilled; // Samples that did not fit the slots
+        std::vector<std::uint32_t> periodEnds;  // Samples of every UAV at the end of every period (period by period)
+        std::vector<double> times;              // Time of the synchronization ending every period
+        std::size_t periods = 0;                // Synchronization periods in the buffer
+
+        // True if the buffer holds neither a period nor a sample recorded after the last one
+        bool empty() const;
+    };
+
+    void publish(bool dropWhenFull);
+    void drain();
+    void writeLoop();
+    void writeBuffer(Buffer& buffer);
+
+    std::vector<TrajectorySink*> outputs;
+    std::size_t fleetSize;
+    std::size_t slotsPerUav;
+    std::size_t periodsPerBuffer;
+    BackpressurePolicy policy;
+    std::vector<Buffer> buffers;
+    Buffer* current = nullptr;             // Buffer filled by the engine
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wakeUp;        // Signals the writer thread
+    std::condition_variable bufferFreed;   // Signals the engine
+    std::deque<Buffer*> queue;             // Buffers waiting for the writer thread
+    std::vector<Buffer*> freeBuffers;
+    bool writing = false;
+    bool stopping = false;
+    std::uint64_t dropped = 0;
+};
+
+#endif // ASYNCTRAJECTORYWRITER_H
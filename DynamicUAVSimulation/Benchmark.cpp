@@ -0,0 +1,834 @@
+// Benchmark harness for the simulation loop.
+//
+// Runs synthetic scenarios (fleet size, command density and loiter/transit mix) through the
+// tick and event engines and reports the throughput as JSON:
+//
+//   DynamicUAVBenchmark [--uavs 1,10,100,1000,10000,100000] [--mixes transit,loiter,mixed]
+//                       [--densities 2] [--engines tick,event] [--output null|text|binary|compressed]
+//                       [--updates 10000000] [--threads 0] [--seed 1] [--separation <distance>]
+//                       [--realtime <ticks per second> [--duration 2]] [--loiter-fast-path 0|1]
+//                       [--motion-model 0|1] [--async-output 0|1] [--manifest-rows 1000000]
+//                       [--command-lines 1000000] [--assignment-size 10000] [--json <file>]
+//
+// Every scenario simulates about `--updates` UAV updates, so the number of ticks shrinks as the
+// fleet grows. With --realtime the scenarios instead run `--duration` seconds paced to the wall
+// clock at the given tick rate, and report the deadline misses and the per-tick compute time and
+// wake-up jitter percentiles: the largest fleet without misses is the capacity at that rate.
+// With --motion-model 1 the tick scenarios use the 3D model, the commands also give altitudes,
+// and the event scenarios are skipped (the closed-form propagation is planar only).
+// With --async-output 1 the text or binary output is formatted and written by a writer thread.
+// The peak RSS is the high-water mark of the process, so scenarios run from the smallest fleet to
+// the largest. The report also compares the loiter fast path (incremental rotation) with
+// UAV::standbyMode: cost per step and largest position difference over a long loiter, and the
+// load times of a `--manifest-rows` fleet manifest and of a `--command-lines` command file, each in
+// text and binary form, and the time to assign `--assignment-size` targets to as many UAVs with
+// the gap of the auction to the Hungarian method on a smaller batch (measured last, so they do not
+// raise the peak RSS of the scenarios).
+// A build with UAVSIM_FLOAT_STATE moves the planar state of the tick scenarios in single precision.
+// A build with UAVSIM_PROFILING also prints the counters and phase times of all scenarios to stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncTrajectoryWriter.h"
+#include "BinaryTrajectoryWriter.h"
+#include "CompressedTrajectoryWriter.h"
+#include "CommandFile.h"
+#include "CommandScheduler.h"
+#include "Config.h"
+#include "EventEngine.h"
+#include "FleetManifest.h"
+#include "FleetState.h"
+#include "LoiterFastPath.h"
+#include "Profiler.h"
+#include "SeparationMonitor.h"
+#include "TargetAssignment.h"
+#include "TextTrajectoryWriter.h"
+#include "TickEngine.h"
+#include "UAV.h"
+#include "UAVFleet.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::vector<int> uavs = { 1, 10, 100, 1000, 10000, 100000 };
+        std::vector<std::string> mixes = { "transit", "loiter", "mixed" };
+        std::vector<double> densities = { 2.0 }; // Commands per UAV per simulated minute
+        std::vector<std::string> engines = { "tick", "event" };
+        std::string output = "null";
+        std::string outputDir = "benchmark_output";
+        double updates = 1e7;
+        int threads = 0;
+        unsigned seed = 1;
+        double separation = 0.0; // Separation distance monitored during the runs (0 = none)
+        double realtimeRate = 0.0; // Ticks per wall-clock second (0 = as fast as possible)
+        double duration = 2.0;     // Simulated seconds of a real-time run
+        bool loiterFastPath = false;
+        int motionModel = 0;
+        bool asyncOutput = false;
+        std::size_t manifestRows = 1000000; // Rows of the timed fleet manifests (0 = skip)
+        std::size_t commandLines = 1000000; // Commands of the timed command files (0 = skip)
+        std::size_t assignmentSize = 10000; // UAVs and targets of the timed assignment (0 = skip)
+        std::string jsonFile;
+    };
+
+    struct Scenario {
+        std::string engine;
+        std::string mix;
+        int nUav;
+        double density;
+    };
+
+    struct Result {
+        Scenario scenario;
+        std::size_t commands = 0;
+        std::size_t ticks = 0;
+        std::size_t threads = 0;
+        double simulatedSeconds = 0.0;
+        double setupSeconds = 0.0;
+        double runSeconds = 0.0;
+        std::uint64_t bytesWritten = 0;
+        std::uint64_t peakRssBytes = 0;
+        std::uint64_t separationEvents = 0;
+        std::uint64_t deadlineMisses = 0;
+        double computeP50Us = 0.0;
+        double computeP99Us = 0.0;
+        double computeMaxUs = 0.0;
+        double jitterP99Us = 0.0;
+    };
+
+    // Discards all samples; measures the loop without I/O.
+    class NullSink : public TrajectorySink {
+    public:
+        void record(std::size_t, const TrajectorySample&) override {}
+        void flush() override {}
+    };
+
+    // Returns the peak resident set size of the process in bytes.
+    std::uint64_t peakResidentBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<std::uint64_t>(usage.ru_maxrss); // Bytes on macOS
+#else
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#endif
+    }
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::vector<std::string> splitList(const std::string& text) {
+        std::vector<std::string> items;
+        std::istringstream iss(text);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing value for " << arg << std::endl;
+                return false;
+            }
+            std::string value = argv[++i];
+            if (arg == "--uavs") {
+                options.uavs.clear();
+                for (const auto& item : splitList(value)) {
+                    options.uavs.push_back(std::stoi(item));
+                }
+            }
+            else if (arg == "--mixes") {
+                options.mixes = splitList(value);
+            }
+            else if (arg == "--densities") {
+                options.densities.clear();
+                for (const auto& item : splitList(value)) {
+                    options.densities.push_back(std::stod(item));
+                }
+            }
+            else if (arg == "--engines") {
+                options.engines = splitList(value);
+            }
+            else if (arg == "--output") {
+                options.output = value;
+            }
+            else if (arg == "--output-dir") {
+                options.outputDir = value;
+            }
+            else if (arg == "--updates") {
+                options.updates = std::stod(value);
+            }
+            else if (arg == "--threads") {
+                options.threads = std::stoi(value);
+            }
+            else if (arg == "--seed") {
+                options.seed = static_cast<unsigned>(std::stoul(value));
+            }
+            else if (arg == "--separation") {
+                options.separation = std::stod(value);
+            }
+            else if (arg == "--realtime") {
+                options.realtimeRate = std::stod(value);
+            }
+            else if (arg == "--duration") {
+                options.duration = std::stod(value);
+            }
+            else if (arg == "--loiter-fast-path") {
+                options.loiterFastPath = std::stoi(value) != 0;
+            }
+            else if (arg == "--motion-model") {
+                options.motionModel = std::stoi(value);
+            }
+            else if (arg == "--async-output") {
+                options.asyncOutput = std::stoi(value) != 0;
+            }
+            else if (arg == "--manifest-rows") {
+                options.manifestRows = static_cast<std::size_t>(std::stoull(value));
+            }
+            else if (arg == "--command-lines") {
+                options.commandLines = static_cast<std::size_t>(std::stoull(value));
+            }
+            else if (arg == "--assignment-size") {
+                options.assignmentSize = static_cast<std::size_t>(std::stoull(value));
+            }
+            else if (arg == "--json") {
+                options.jsonFile = value;
+            }
+            else {
+                std::cerr << "Error: Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        if (options.output != "null" && options.output != "text" && options.output != "binary" &&
+            options.output != "compressed") {
+            std::cerr << "Error: --output must be null, text, binary or compressed" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Builds the configuration of a scenario. The run length gives about `updates` UAV updates.
+    Config scenarioConfig(const Scenario& scenario, const Options& options) {
+        Config config;
+        config.Dt = 0.1;
+        config.N_uav = scenario.nUav;
+        config.R = 50.0;
+        config.X0 = 0.0;
+        config.Y0 = 0.0;
+        config.Z0 = 100.0;
+        config.V0 = 20.0;
+        config.Az = 0.0;
+        double ticks = std::clamp(options.updates / scenario.nUav, 20.0, 100000.0);
+        config.TimeLim = std::floor(ticks) * config.Dt;
+        config.Threads = options.threads;
+        config.LoiterFastPath = options.loiterFastPath;
+        config.MotionModel = options.motionModel;
+        if (options.realtimeRate > 0.0) {
+            config.Dt = 1.0 / options.realtimeRate;
+            config.TimeLim = options.duration;
+            config.RealTimeFactor = 1.0;
+        }
+        return config;
+    }
+
+    // Start position of a UAV: the fleet is spread on a square lattice centered on the origin,
+    // 4 turning radii apart, so large fleets do not start stacked on a single point.
+    void startPosition(int num, const Scenario& scenario, const Config& config, double& x, double& y) {
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(scenario.nUav))));
+        const double spacing = 4.0 * config.R;
+        const double offset = 0.5 * (side - 1) * spacing;
+        x = config.X0 + ((num - 1) % side) * spacing - offset;
+        y = config.Y0 + ((num - 1) / side) * spacing - offset;
+    }
+
+    // Generates the commands of a scenario.
+    // Transit targets are far enough that UAVs rarely arrive before the next command; loiter
+    // targets are a few radii from the start point of the UAV, so UAVs spend most of the run circling.
+    // Command times are whole seconds, like the hand written command files.
+    std::vector<Command> generateCommands(const Scenario& scenario, const Config& config, std::mt19937_64& rng) {
+        const double farSpread = config.V0 * std::max(config.TimeLim, 60.0);
+        const double nearSpread = 3.0 * config.R;
+        const int lastSecond = std::max(1, static_cast<int>(config.TimeLim) - 1);
+        std::uniform_int_distribution<int> uavDist(1, scenario.nUav);
+        std::uniform_int_distribution<int> timeDist(1, lastSecond);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        std::bernoulli_distribution loiterPick(scenario.mix == "loiter" ? 1.0 : scenario.mix == "mixed" ? 0.5 : 0.0);
+
+        auto makeCommand = [&](double time, int num) {
+            double x = config.X0;
+            double y = config.Y0;
+            double spread = farSpread;
+            if (loiterPick(rng)) {
+                startPosition(num, scenario, config, x, y);
+                spread = nearSpread;
+            }
+            Command command = { time, num, x + spread * unit(rng), y + spread * unit(rng) };
+            if (config.MotionModel == 1) {
+                command.z = config.Z0 + 100.0 * unit(rng);
+            }
+            return command;
+        };
+
+        std::vector<Command> commands;
+        // Every UAV gets a first command, then the density adds commands at random times
+        for (int num = 1; num <= scenario.nUav; ++num) {
+            commands.push_back(makeCommand(1.0, num));
+        }
+        std::size_t extra = static_cast<std::size_t>(scenario.density * scenario.nUav * config.TimeLim / 60.0);
+        for (std::size_t i = 0; i < extra; ++i) {
+            commands.push_back(makeCommand(static_cast<double>(timeDist(rng)), uavDist(rng)));
+        }
+        return commands;
+    }
+
+    // Copies the real-time statistics of an engine.
+    void collectPacing(const Pacer& pacer, Result& result) {
+        result.deadlineMisses = pacer.getDeadlineMisses();
+        result.computeP50Us = pacer.getComputeTimes().percentile(0.5) / 1000.0;
+        result.computeP99Us = pacer.getComputeTimes().percentile(0.99) / 1000.0;
+        result.computeMaxUs = pacer.getComputeTimes().max() / 1000.0;
+        result.jitterP99Us = pacer.getJitter().percentile(0.99) / 1000.0;
+    }
+
+    // Counts the steps the engines take for a configuration (same loops as the engines).
+    std::size_t countTicks(const Config& config) {
+        std::size_t ticks = 0;
+        for (double time = 0.0; time <= config.TimeLim; time += config.Dt) {
+            ++ticks;
+        }
+        return ticks;
+    }
+
+    Result runScenario(const Scenario& scenario, const Options& options, std::mt19937_64& rng) {
+        Result result;
+        result.scenario = scenario;
+
+        Clock::time_point setupStart = Clock::now();
+        Config config = scenarioConfig(scenario, options);
+        std::vector<Command> commands = generateCommands(scenario, config, rng);
+        result.commands = commands.size();
+
+        UAVFleet fleet;
+        fleet.resize(config.N_uav);
+        for (int i = 0; i < config.N_uav; ++i) {
+            fleet.num[i] = i + 1;
+            startPosition(i + 1, scenario, config, fleet.x[i], fleet.y[i]);
+            fleet.azimuth[i] = config.Az;
+            fleet.z[i] = config.Z0;
+            fleet.v[i] = config.V0;
+            fleet.r[i] = config.R;
+        }
+        CommandScheduler scheduler(commands, config.N_uav);
+
+        NullSink nullSink;
+        TextTrajectoryWriter textWriter(config.OutputBufferBytes, config.OutputFlushInterval, config.MotionModel == 1);
+        BinaryTrajectoryWriter binaryWriter(config.BinaryPrecision);
+        CompressedTrajectoryWriter compressedWriter(static_cast<std::size_t>(config.CompressedBlockSamples),
+            TrajectoryResolution(), config.MotionModel == 1);
+        std::vector<TrajectorySink*> sinks;
+        if (options.output == "text") {
+            std::filesystem::create_directories(options.outputDir);
+            std::vector<std::string> filenames;
+            for (int i = 0; i < config.N_uav; ++i) {
+                filenames.push_back(options.outputDir + "/UAV" + std::to_string(i + 1) + ".txt");
+            }
+            if (textWriter.open(filenames)) {
+                sinks.push_back(&textWriter);
+            }
+        }
+        else if (options.output == "binary") {
+            std::filesystem::create_directories(options.outputDir);
+            std::size_t capacity = BinaryTrajectoryWriter::recordsForDuration(config.TimeLim, config.Dt);
+            if (binaryWriter.open(options.outputDir + "/UAVTrajectories.bin", config.N_uav, config.Dt, capacity)) {
+                sinks.push_back(&binaryWriter);
+            }
+        }
+        else if (options.output == "compressed") {
+            std::filesystem::create_directories(options.outputDir);
+            std::vector<int> nums(fleet.num.begin(), fleet.num.end());
+            if (compressedWriter.open(options.outputDir + "/UAVTrajectories.uavz", nums)) {
+                sinks.push_back(&compressedWriter);
+            }
+        }
+        else {
+            sinks.push_back(&nullSink);
+        }
+        std::unique_ptr<AsyncTrajectoryWriter> asyncWriter;
+        if (options.asyncOutput && options.output != "null" && !sinks.empty()) {
+            asyncWriter.reset(new AsyncTrajectoryWriter(sinks, fleet.size(), 1, config.AsyncOutputBufferBytes,
+                config.AsyncOutputBuffers, AsyncTrajectoryWriter::WaitForBuffer));
+            sinks = { asyncWriter.get() };
+        }
+        std::vector<int> nums(fleet.num.begin(), fleet.num.end());
+        SeparationMonitor separationMonitor(nums, options.separation, 0.0);
+        if (options.separation > 0.0) {
+            std::filesystem::create_directories(options.outputDir);
+            if (separationMonitor.open(options.outputDir + "/SeparationEvents.txt")) {
+                sinks.push_back(&separationMonitor);
+            }
+        }
+        result.setupSeconds = secondsSince(setupStart);
+
+        Clock::time_point runStart = Clock::now();
+        if (scenario.engine == "event") {
+            EventEngine engine(config, fleet, scheduler, sinks);
+            engine.run();
+            result.threads = engine.getThreadCount();
+            collectPacing(engine.getPacer(), result);
+        }
+        else {
+            TickEngine engine(config, fleet, scheduler, sinks);
+            engine.run();
+            result.threads = engine.getThreadCount();
+            collectPacing(engine.getPacer(), result);
+        }
+        if (asyncWriter) {
+            asyncWriter->close();
+        }
+        textWriter.close();
+        binaryWriter.close();
+        compressedWriter.close();
+        separationMonitor.close(config.TimeLim);
+        result.runSeconds = secondsSince(runStart);
+        result.separationEvents = separationMonitor.getEventCount();
+
+        result.ticks = countTicks(config);
+        result.simulatedSeconds = config.TimeLim;
+        result.bytesWritten = textWriter.bytesWritten() + binaryWriter.bytesWritten() + compressedWriter.bytesWritten();
+        result.peakRssBytes = peakResidentBytes();
+        return result;
+    }
+
+    // Measures the cost of UAV::navigateToTarget for UAVs in transit and UAVs loitering.
+    // Returns nanoseconds per call.
+    double timeNavigateToTarget(bool loiter, std::mt19937_64& rng) {
+        const std::size_t fleetSize = 4096;
+        const int rounds = 200;
+        const double dt = 0.1;
+        UAVFleet fleet;
+        fleet.resize(fleetSize);
+        std::vector<double> destX(fleetSize), destY(fleetSize);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            fleet.num[i] = static_cast<int>(i + 1);
+            fleet.v[i] = 20.0;
+            fleet.r[i] = 50.0;
+            fleet.cruising[i] = 0; // Every UAV has a command; navigateToTarget moves it by itself
+            fleet.azimuth[i] = unit(rng) * 3.14159265358979;
+            // Loitering UAVs start on their circle, transiting UAVs far away from their target
+            double distance = loiter ? 50.0 : 1e6;
+            double angle = unit(rng) * 3.14159265358979;
+            destX[i] = 1000.0 * unit(rng);
+            destY[i] = 1000.0 * unit(rng);
+            fleet.x[i] = destX[i] + distance * std::cos(angle);
+            fleet.y[i] = destY[i] + distance * std::sin(angle);
+        }
+
+        double sink = 0.0;
+        Clock::time_point start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                UAV uav(fleet, i);
+                uav.navigateToTarget(dt, destX[i], destY[i]);
+            }
+            sink += fleet.x[round % fleetSize];
+        }
+        double seconds = secondsSince(start);
+        volatile double observed = sink; // Keeps the loop from being optimized away
+        (void)observed;
+        return seconds * 1e9 / (static_cast<double>(rounds) * fleetSize);
+    }
+
+    struct LoiterComparison {
+        double standbyModeNs = 0.0;
+        double fastPathNs = 0.0;
+        double maxErrorMeters = 0.0; // Largest position difference between the two
+    };
+
+    // Flies the same loitering fleet with UAV::standbyMode and with the fast path for a long time
+    // (a few hundred re-synchronizations) and compares cost and positions.
+    LoiterComparison compareLoiterFastPath(std::mt19937_64& rng) {
+        const std::size_t fleetSize = 1024;
+        const int steps = 20000;
+        const double dt = 0.01;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        UAVFleet exact;
+        exact.resize(fleetSize);
+        std::vector<double> destX(fleetSize), destY(fleetSize);
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            exact.num[i] = static_cast<int>(i + 1);
+            exact.v[i] = 10.0 + 40.0 * unit(rng);
+            exact.r[i] = 20.0 + 10000.0 * unit(rng) * unit(rng); // Mostly small radii, some up to 10 km
+            exact.azimuth[i] = 6.28 * unit(rng);
+            destX[i] = 1000.0 * unit(rng);
+            destY[i] = 1000.0 * unit(rng);
+            exact.standbyModeFlag[i] = 1;
+        }
+        UAVFleet fast = exact;
+        LoiterFastPath loiter(fleetSize, Config().LoiterRenormalizeSteps);
+
+        LoiterComparison comparison;
+        Clock::time_point start = Clock::now();
+        for (int step = 0; step < steps; ++step) {
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                UAV uav(exact, i);
+                uav.standbyMode(destX[i], destY[i], dt);
+            }
+        }
+        comparison.standbyModeNs = secondsSince(start) * 1e9 / (static_cast<double>(steps) * fleetSize);
+
+        start = Clock::now();
+        for (int step = 0; step < steps; ++step) {
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                loiter.step(fast, i, dt, destX[i], destY[i]);
+            }
+        }
+        comparison.fastPathNs = secondsSince(start) * 1e9 / (static_cast<double>(steps) * fleetSize);
+
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            comparison.maxErrorMeters = std::max(comparison.maxErrorMeters,
+                std::hypot(fast.x[i] - exact.x[i], fast.y[i] - exact.y[i]));
+        }
+        return comparison;
+    }
+
+    struct ManifestTiming {
+        double csvSeconds = 0.0;
+        double binarySeconds = 0.0;
+        std::size_t csvBytes = 0;
+        bool ok = true;
+    };
+
+    // Writes a random fleet as CSV and binary manifests in the output directory and times loading them.
+    ManifestTiming timeFleetManifest(const Options& options, std::mt19937_64& rng) {
+        ManifestTiming timing;
+        std::uniform_real_distribution<double> position(-50000.0, 50000.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        UAVFleet fleet(options.manifestRows);
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            fleet.x[i] = position(rng);
+            fleet.y[i] = position(rng);
+            fleet.z[i] = 100.0 + 900.0 * unit(rng);
+            fleet.v[i] = 10.0 + 40.0 * unit(rng);
+            fleet.azimuth[i] = 6.28 * unit(rng);
+            fleet.r[i] = 50.0 + 450.0 * unit(rng);
+        }
+
+        std::filesystem::create_directories(options.outputDir);
+        const std::string csvFile = options.outputDir + "/FleetManifest.csv";
+        const std::string binaryFile = options.outputDir + "/FleetManifest.bin";
+        {
+            std::ofstream file(csvFile, std::ios_base::binary | std::ios_base::trunc);
+            file << "X0,Y0,Z0,V0,Az,R\n" << std::setprecision(17);
+            for (std::size_t i = 0; i < fleet.size(); ++i) {
+                file << fleet.x[i] << ',' << fleet.y[i] << ',' << fleet.z[i] << ','
+                     << fleet.v[i] << ',' << fleet.azimuth[i] << ',' << fleet.r[i] << '\n';
+            }
+            timing.csvBytes = static_cast<std::size_t>(file.tellp());
+        }
+        timing.ok = writeFleetManifest(binaryFile, fleet);
+
+        Config config = Config();
+        UAVFleet loaded;
+        Clock::time_point start = Clock::now();
+        timing.ok = loadFleetManifest(csvFile, config, loaded) && timing.ok;
+        timing.csvSeconds = secondsSince(start);
+        timing.ok = timing.ok && loaded.x == fleet.x && loaded.r == fleet.r;
+
+        start = Clock::now();
+        timing.ok = loadFleetManifest(binaryFile, config, loaded) && timing.ok;
+        timing.binarySeconds = secondsSince(start);
+        timing.ok = timing.ok && loaded.x == fleet.x && loaded.r == fleet.r;
+        return timing;
+    }
+
+    struct CommandFileTiming {
+        double textSeconds = 0.0;
+        double binarySeconds = 0.0;
+        double schedulerSeconds = 0.0; // Bucketing and sorting the loaded commands
+        std::size_t textBytes = 0;
+        bool ok = true;
+    };
+
+    // Writes a time-ordered random mission as text and binary command files in the output directory
+    // and times loading them.
+    CommandFileTiming timeCommandFile(const Options& options, std::mt19937_64& rng) {
+        const int nUav = 10000;
+        CommandFileTiming timing;
+        std::uniform_real_distribution<double> position(-50000.0, 50000.0);
+        std::uniform_int_distribution<int> uav(1, nUav);
+        std::vector<Command> commands(options.commandLines);
+        for (std::size_t i = 0; i < commands.size(); ++i) {
+            commands[i] = { 0.001 * static_cast<double>(i + 1), uav(rng), position(rng), position(rng) };
+        }
+
+        std::filesystem::create_directories(options.outputDir);
+        const std::string textFile = options.outputDir + "/SimCmds.txt";
+        const std::string binaryFile = options.outputDir + "/SimCmds.bin";
+        {
+            std::ofstream file(textFile, std::ios_base::binary | std::ios_base::trunc);
+            file << std::fixed;
+            for (const auto& command : commands) {
+                file << std::setprecision(3) << command.time << ' ' << command.num << ' '
+                     << std::setprecision(2) << command.x << ' ' << command.y << '\n';
+            }
+            timing.textBytes = static_cast<std::size_t>(file.tellp());
+        }
+        timing.ok = writeCommandFile(binaryFile, commands);
+
+        std::vector<Command> loaded;
+        Clock::time_point start = Clock::now();
+        timing.ok = loadCommandFile(textFile, loaded, static_cast<std::size_t>(std::max(0, options.threads))) && timing.ok;
+        timing.textSeconds = secondsSince(start);
+        timing.ok = timing.ok && loaded.size() == commands.size();
+
+        loaded.clear();
+        start = Clock::now();
+        timing.ok = loadCommandFile(binaryFile, loaded) && timing.ok;
+        timing.binarySeconds = secondsSince(start);
+        timing.ok = timing.ok && loaded.size() == commands.size();
+
+        start = Clock::now();
+        CommandScheduler scheduler(loaded, nUav);
+        timing.schedulerSeconds = secondsSince(start);
+        return timing;
+    }
+
+    struct AssignmentTiming {
+        double seconds = 0.0;
+        double totalCost = 0.0;
+        std::size_t assigned = 0;
+        std::size_t exactSize = 500; // UAVs and targets of the batch solved both ways
+        double exactCost = 0.0;
+        double auctionCost = 0.0;
+    };
+
+    // Spreads UAVs (speed and turning radius of the scenarios) and targets over the same square.
+    void randomAssignment(std::size_t size, double halfWidth, std::mt19937_64& rng, UAVFleet& fleet,
+                          std::vector<std::size_t>& uavs, std::vector<Command>& targets) {
+        std::uniform_real_distribution<double> position(-halfWidth, halfWidth);
+        std::uniform_real_distribution<double> speed(20.0, 40.0);
+        std::uniform_real_distribution<double> radius(50.0, 150.0);
+        fleet.resize(size);
+        uavs.resize(size);
+        targets.resize(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            fleet.x[i] = position(rng);
+            fleet.y[i] = position(rng);
+            fleet.v[i] = speed(rng);
+            fleet.r[i] = radius(rng);
+            uavs[i] = i;
+            targets[i] = { 1.0, 0, position(rng), position(rng) };
+        }
+    }
+
+    // Times the assignment of a large batch (auction) and compares the auction with the Hungarian
+    // method on a batch small enough for it.
+    AssignmentTiming timeAssignment(const Options& options, std::mt19937_64& rng) {
+        const Config defaults = Config();
+        AssignmentTiming timing;
+        TargetAssigner assigner(static_cast<std::size_t>(defaults.AssignmentExactLimit),
+                                static_cast<std::size_t>(defaults.AssignmentCandidates));
+        UAVFleet fleet;
+        std::vector<std::size_t> uavs;
+        std::vector<Command> targets;
+        std::vector<std::size_t> assignment;
+
+        randomAssignment(options.assignmentSize, 50000.0, rng, fleet, uavs, targets);
+        Clock::time_point start = Clock::now();
+        timing.totalCost = assigner.assign(fleet, uavs, targets, assignment);
+        timing.seconds = secondsSince(start);
+        timing.assigned = static_cast<std::size_t>(std::count_if(assignment.begin(), assignment.end(),
+            [](std::size_t index) { return index != TargetAssigner::unassigned; }));
+
+        randomAssignment(timing.exactSize, 5000.0, rng, fleet, uavs, targets);
+        timing.exactCost = assigner.assign(fleet, uavs, targets, assignment, TargetAssigner::Exact);
+        timing.auctionCost = assigner.assign(fleet, uavs, targets, assignment, TargetAssigner::Auction);
+        return timing;
+    }
+
+    void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results,
+                   double transitNs, double loiterNs, const LoiterComparison& loiterFastPath,
+                   const ManifestTiming& manifest, const CommandFileTiming& commandFile,
+                   const AssignmentTiming& assignment) {
+        out << std::setprecision(6);
+        out << "{\n";
+        out << "  \"output\": \"" << options.output << "\",\n";
+        out << "  \"updates_per_scenario\": " << options.updates << ",\n";
+        out << "  \"separation_distance\": " << options.separation << ",\n";
+        out << "  \"realtime_rate\": " << options.realtimeRate << ",\n";
+        out << "  \"motion_model\": " << options.motionModel << ",\n";
+        out << "  \"state_scalar\": \"" << (floatState ? "float" : "double") << "\",\n";
+        out << "  \"async_output\": " << (options.asyncOutput ? "true" : "false") << ",\n";
+        out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "  \"navigate_to_target_ns\": { \"transit\": " << transitNs << ", \"loiter\": " << loiterNs << " },\n";
+        out << "  \"loiter_fast_path\": { \"enabled\": " << (options.loiterFastPath ? "true" : "false")
+            << ", \"standby_mode_ns\": " << loiterFastPath.standbyModeNs
+            << ", \"fast_path_ns\": " << loiterFastPath.fastPathNs
+            << ", \"max_error_m\": " << loiterFastPath.maxErrorMeters << " },\n";
+        if (options.manifestRows > 0) {
+            out << "  \"fleet_manifest\": { \"rows\": " << options.manifestRows
+                << ", \"csv_bytes\": " << manifest.csvBytes
+                << ", \"csv_load_seconds\": " << manifest.csvSeconds
+                << ", \"binary_load_seconds\": " << manifest.binarySeconds
+                << ", \"round_trip_ok\": " << (manifest.ok ? "true" : "false") << " },\n";
+        }
+        if (options.commandLines > 0) {
+            out << "  \"command_file\": { \"commands\": " << options.commandLines
+                << ", \"text_bytes\": " << commandFile.textBytes
+                << ", \"text_load_seconds\": " << commandFile.textSeconds
+                << ", \"binary_load_seconds\": " << commandFile.binarySeconds
+                << ", \"scheduler_seconds\": " << commandFile.schedulerSeconds
+                << ", \"ok\": " << (commandFile.ok ? "true" : "false") << " },\n";
+        }
+        if (options.assignmentSize > 0) {
+            out << "  \"target_assignment\": { \"uavs\": " << options.assignmentSize
+                << ", \"targets\": " << options.assignmentSize
+                << ", \"seconds\": " << assignment.seconds
+                << ", \"assigned\": " << assignment.assigned
+                << ", \"total_cost_seconds\": " << assignment.totalCost
+                << ", \"exact_batch\": " << assignment.exactSize
+                << ", \"auction_gap_percent\": "
+                << (assignment.exactCost > 0.0 ? 100.0 * (assignment.auctionCost - assignment.exactCost) / assignment.exactCost : 0.0)
+                << " },\n";
+        }
+        out << "  \"scenarios\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            double updates = static_cast<double>(r.ticks) * r.scenario.nUav;
+            out << "    { \"engine\": \"" << r.scenario.engine << "\""
+                << ", \"mix\": \"" << r.scenario.mix << "\""
+                << ", \"n_uav\": " << r.scenario.nUav
+                << ", \"commands_per_uav_minute\": " << r.scenario.density
+                << ", \"commands\": " << r.commands
+                << ", \"threads\": " << r.threads
+                << ", \"ticks\": " << r.ticks
+                << ", \"simulated_seconds\": " << r.simulatedSeconds
+                << ", \"setup_seconds\": " << r.setupSeconds
+                << ", \"run_seconds\": " << r.runSeconds
+                << ", \"ticks_per_second\": " << (r.runSeconds > 0.0 ? r.ticks / r.runSeconds : 0.0)
+                << ", \"uav_updates_per_second\": " << (r.runSeconds > 0.0 ? updates / r.runSeconds : 0.0)
+                << ", \"bytes_written\": " << r.bytesWritten
+                << ", \"peak_rss_bytes\": " << r.peakRssBytes
+                << ", \"separation_events\": " << r.separationEvents;
+            if (options.realtimeRate > 0.0) {
+                out << ", \"deadline_misses\": " << r.deadlineMisses
+                    << ", \"compute_p50_us\": " << r.computeP50Us
+                    << ", \"compute_p99_us\": " << r.computeP99Us
+                    << ", \"compute_max_us\": " << r.computeMaxUs
+                    << ", \"jitter_p99_us\": " << r.jitterP99Us;
+            }
+            out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    std::sort(options.uavs.begin(), options.uavs.end());
+    std::mt19937_64 rng(options.seed);
+
+    double transitNs = timeNavigateToTarget(false, rng);
+    double loiterNs = timeNavigateToTarget(true, rng);
+    LoiterComparison loiterFastPath = compareLoiterFastPath(rng);
+
+    std::vector<Result> results;
+    for (int nUav : options.uavs) {
+        if (nUav <= 0) {
+            continue;
+        }
+        for (double density : options.densities) {
+            for (const auto& mix : options.mixes) {
+                for (const auto& engine : options.engines) {
+                    if (engine == "event" && options.motionModel == 1) {
+                        continue;
+                    }
+                    Scenario scenario = { engine, mix, nUav, density };
+                    std::cerr << "Running " << engine << " " << mix << " N_uav=" << nUav
+                              << " density=" << density << std::endl;
+                    results.push_back(runScenario(scenario, options, rng));
+                }
+            }
+        }
+    }
+
+    ManifestTiming manifest;
+    if (options.manifestRows > 0) {
+        std::cerr << "Loading a fleet manifest of " << options.manifestRows << " UAVs" << std::endl;
+        manifest = timeFleetManifest(options, rng);
+    }
+    CommandFileTiming commandFile;
+    if (options.commandLines > 0) {
+        std::cerr << "Loading a command file of " << options.commandLines << " commands" << std::endl;
+        commandFile = timeCommandFile(options, rng);
+    }
+
+    AssignmentTiming assignment;
+    if (options.assignmentSize > 0) {
+        std::cerr << "Assigning " << options.assignmentSize << " targets to " << options.assignmentSize << " UAVs" << std::endl;
+        assignment = timeAssignment(options, rng);
+    }
+
+    if (options.jsonFile.empty()) {
+        writeJson(std::cout, options, results, transitNs, loiterNs, loiterFastPath, manifest, commandFile, assignment);
+    }
+    else {
+        std::ofstream file(options.jsonFile);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << options.jsonFile << std::endl;
+            return 1;
+        }
+        writeJson(file, options, results, transitNs, loiterNs, loiterFastPath, manifest, commandFile, assignment);
+    }
+    if (Profiler::enabled) {
+        Profiler::writeReport(std::cerr, false);
+    }
+    return 0;
+}
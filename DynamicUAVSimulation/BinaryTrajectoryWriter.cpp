@@ -0,0 +1,171 @@
+#include "BinaryTrajectoryWriter.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Checkpoint.h"
+#include "Profiler.h"
+
+namespace {
+    // UAV blocks start on a page boundary
+    const std::size_t blockAlignment = 4096;
+
+    std::size_t alignUp(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+// Constructor
+BinaryTrajectoryWriter::BinaryTrajectoryWriter(int precisionBits)
+    : precisionBits(precisionBits == 32 ? 32 : 64),
+      recordSize(sizeof(double) + 3 * (precisionBits == 32 ? sizeof(float) : sizeof(double))) {}
+
+// Destructor
+BinaryTrajectoryWriter::~BinaryTrajectoryWriter() {
+    close();
+}
+
+// Returns the number of records needed per UAV to cover a run of the given length.
+std::size_t BinaryTrajectoryWriter::recordsForDuration(double timeLim, double dt) {
+    if (dt <= 0.0 || timeLim < 0.0) {
+        return 1;
+    }
+    // One record per step from t=0 to t=TimeLim inclusive, plus slack for the
+    // rounding error of the accumulated simulation time.
+    return static_cast<std::size_t>(std::floor(timeLim / dt)) + 3;
+}
+
+// Creates the output file and preallocates a block for every UAV.
+bool BinaryTrajectoryWriter::open(const std::string& filename, std::size_t nUav, double dt, std::size_t capacity, bool resume) {
+    close();
+    this->filename = filename;
+    this->capacity = capacity;
+    this->nUav = nUav;
+
+    std::size_t countsOffset = sizeof(BinaryTrajectoryHeader);
+    dataOffset = alignUp(countsOffset + nUav * sizeof(std::uint64_t), blockAlignment);
+    std::size_t fileSize = dataOffset + nUav * capacity * recordSize;
+
+    if (resume) {
+        // The records written before the checkpoint are kept; restoreState() sets the counts
+        BinaryTrajectoryHeader header;
+        if (!file.openReadWrite(filename) || file.size() < fileSize) {
+            std::cerr << "Error: " << filename << " does not match the simulation parameters" << std::endl;
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "UAVTRAJ", 8) != 0 || header.nUav != nUav || header.recordSize != recordSize ||
+            header.capacity != capacity || header.dataOffset != dataOffset) {
+            std::cerr << "Error: " << filename << " does not match the simulation parameters" << std::endl;
+            file.close();
+            return false;
+        }
+        counts = reinterpret_cast<std::uint64_t*>(file.data() + countsOffset);
+        blocks = file.data() + dataOffset;
+        droppedRecords = 0;
+        return true;
+    }
+
+    if (!file.create(filename, fileSize)) {
+        return false;
+    }
+
+    BinaryTrajectoryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "UAVTRAJ", 8);
+    header.version = 1;
+    header.nUav = static_cast<std::uint32_t>(nUav);
+    header.recordSize = static_cast<std::uint32_t>(recordSize);
+    header.fieldCount = 4;
+    header.dt = dt;
+    header.capacity = capacity;
+    header.countsOffset = countsOffset;
+    header.dataOffset = dataOffset;
+    const char* fields = precisionBits == 32 ? "time:<f8,x:<f4,y:<f4,azimuth:<f4" : "time:<f8,x:<f8,y:<f8,azimuth:<f8";
+    std::strncpy(header.fields, fields, sizeof(header.fields) - 1);
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    counts = reinterpret_cast<std::uint64_t*>(file.data() + countsOffset);
+    std::memset(counts, 0, nUav * sizeof(std::uint64_t));
+    blocks = file.data() + dataOffset;
+    droppedRecords = 0;
+    return true;
+}
+
+// Appends one record to the block of the UAV.
+void BinaryTrajectoryWriter::record(std::size_t index, const TrajectorySample& sample) {
+    std::uint64_t count = counts[index];
+    if (count >= capacity) {
+        ++droppedRecords;
+        return;
+    }
+
+    char* slot = blocks + (index * capacity + count) * recordSize;
+    std::memcpy(slot, &sample.time, sizeof(double));
+    slot += sizeof(double);
+    if (precisionBits == 32) {
+        float values[3] = { static_cast<float>(sample.x), static_cast<float>(sample.y), static_cast<float>(sample.azimuth) };
+        std::memcpy(slot, values, sizeof(values));
+    }
+    else {
+        double values[3] = { sample.x, sample.y, sample.azimuth };
+        std::memcpy(slot, values, sizeof(values));
+    }
+    counts[index] = count + 1;
+    UAVSIM_PROFILE_COUNT_N(OutputBytes, recordSize);
+}
+
+// Schedules the dirty pages for writing.
+void BinaryTrajectoryWriter::flush() {
+    UAVSIM_PROFILE_COUNT(OutputSyncCalls);
+    file.flush();
+}
+
+// Returns the size of the header and of the valid records.
+std::uint64_t BinaryTrajectoryWriter::bytesWritten() const {
+    std::uint64_t total = closedBytes;
+    if (blocks != nullptr) {
+        total += dataOffset;
+        for (std::size_t i = 0; i < nUav; ++i) {
+            total += counts[i] * recordSize;
+        }
+    }
+    return total;
+}
+
+// Saves the record count of every UAV.
+void BinaryTrajectoryWriter::saveState(StateWriter& state) const {
+    std::vector<std::uint64_t> recordCounts(counts, counts + (counts != nullptr ? nUav : 0));
+    state.writeVector(recordCounts);
+    state.write<std::uint64_t>(droppedRecords.load());
+}
+
+// Restores the record counts.
+bool BinaryTrajectoryWriter::restoreState(StateReader& state) {
+    std::vector<std::uint64_t> recordCounts;
+    std::uint64_t dropped = 0;
+    if (!state.readVector(recordCounts) || !state.read(dropped) || recordCounts.size() != nUav || counts == nullptr) {
+        return false;
+    }
+    std::copy(recordCounts.begin(), recordCounts.end(), counts);
+    droppedRecords = static_cast<std::size_t>(dropped);
+    return true;
+}
+
+// Flushes the mapping and closes the file.
+void BinaryTrajectoryWriter::close() {
+    if (blocks == nullptr) {
+        return;
+    }
+    closedBytes = bytesWritten();
+    if (droppedRecords > 0) {
+        std::cerr << "Warning: " << droppedRecords << " records did not fit in " << filename << std::endl;
+    }
+    file.flush();
+    file.close();
+    counts = nullptr;
+    blocks = nullptr;
+}
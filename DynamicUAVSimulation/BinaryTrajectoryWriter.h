@@ -0,0 +1,100 @@
+#pragma once
+#ifndef BINARYTRAJECTORYWRITER_H
+#define BINARYTRAJECTORYWRITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MappedFile.h"
+#include "TrajectorySink.h"
+
+// On-disk header of the binary trajectory file (all values little-endian).
+//
+// The header is followed by a table of nUav uint64 record counts (at countsOffset) and then by
+// one block per UAV (at dataOffset). Every block reserves room for `capacity` records of
+// `recordSize` bytes and the first count[i] records of block i are valid. A record holds the
+// fields listed in `fields` ("name:type" pairs in numpy notation), packed without padding, so
+// the data can be loaded with numpy.memmap(dtype, offset=dataOffset, shape=(nUav, capacity)).
+struct BinaryTrajectoryHeader {
+    char magic[8];              // "UAVTRAJ" followed by a NUL
+    std::uint32_t version;      // Format version
+    std::uint32_t nUav;         // Number of UAV blocks
+    std::uint32_t recordSize;   // Size of a record in bytes
+    std::uint32_t fieldCount;   // Number of fields in a record
+    double dt;                  // Simulation time step
+    std::uint64_t capacity;     // Records reserved in every UAV block
+    std::uint64_t countsOffset; // Offset of the record count table
+    std::uint64_t dataOffset;   // Offset of the first UAV block
+    char fields[200];           // Comma separated field list, NUL padded
+};
+
+static_assert(sizeof(BinaryTrajectoryHeader) == 256, "BinaryTrajectoryHeader must stay 256 bytes");
+
+// Writes all UAV trajectories into a single preallocated, memory-mapped binary file.
+// The time field is always float64; position and azimuth are float32 or float64.
+class BinaryTrajectoryWriter : public TrajectorySink {
+public:
+    /**
+    * @param precisionBits 32 to store position and azimuth as float32, 64 for float64.
+    */
+    explicit BinaryTrajectoryWriter(int precisionBits);
+    ~BinaryTrajectoryWriter() override;
+
+    BinaryTrajectoryWriter(const BinaryTrajectoryWriter&) = delete;
+    BinaryTrajectoryWriter& operator=(const BinaryTrajectoryWriter&) = delete;
+
+    /**
+    * Creates the output file and preallocates a block for every UAV.
+    *
+    * @param filename The name of the file to create.
+    * @param nUav The number of UAVs.
+    * @param dt The simulation time step, stored in the header.
+    * @param capacity The number of records reserved per UAV.
+    * @param resume Reopen the existing file of the same layout instead (to resume from a checkpoint).
+    * @return True if the file was created, false otherwise.
+    */
+    bool open(const std::string& filename, std::size_t nUav, double dt, std::size_t capacity, bool resume = false);
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+    void flush() override;
+    std::uint64_t bytesWritten() const override;
+
+    /**
+    * Saves the record count of every UAV.
+    */
+    void saveState(StateWriter& state) const override;
+
+    /**
+    * Restores the record counts; records after the checkpoint are written again by the resumed run.
+    */
+    bool restoreState(StateReader& state) override;
+
+    /**
+    * Flushes the mapping and closes the file.
+    */
+    void close();
+
+    /**
+    * Returns the number of records needed per UAV to cover a run of the given length.
+    *
+    * @param timeLim The simulated time.
+    * @param dt The interval between two records.
+    */
+    static std::size_t recordsForDuration(double timeLim, double dt);
+
+private:
+    int precisionBits;
+    std::size_t recordSize;
+    std::size_t capacity = 0;
+    std::size_t nUav = 0;
+    std::size_t dataOffset = 0;
+    std::uint64_t closedBytes = 0; // Bytes written to files that were closed
+    std::uint64_t* counts = nullptr;
+    char* blocks = nullptr;
+    std::atomic<std::size_t> droppedRecords{ 0 };
+    std::string filename;
+    MappedFile file;
+};
+
+#endif // BINARYTRAJECTORYWRITER_H
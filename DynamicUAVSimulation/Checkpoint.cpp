@@ -0,0 +1,138 @@
+#include "Checkpoint.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "Manager.h"
+#include "Profiler.h"
+
+namespace {
+    // File layout: header, then the serialized state
+    struct CheckpointHeader {
+        char magic[8];           // "UAVCKPT" followed by a NUL
+        std::uint32_t version;   // Format version
+        std::uint32_t byteOrder; // 0x01020304 written in the native byte order
+        double time;             // Simulation time of the state
+        std::uint64_t size;      // Size of the state in bytes
+    };
+
+    const std::uint32_t checkpointVersion = 5;
+    const std::uint32_t byteOrderMark = 0x01020304;
+}
+
+// Constructor - starts the writer thread
+Checkpointer::Checkpointer(const std::string& filename, double interval)
+    : filename(filename), interval(interval), nextTime(interval) {
+    writer = std::thread(&Checkpointer::writeLoop, this);
+}
+
+// Destructor
+Checkpointer::~Checkpointer() {
+    finish();
+}
+
+// Hands a serialized state over to the writer thread and schedules the next checkpoint.
+void Checkpointer::submit(double time, StateWriter& state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.swap(state.data());
+        pendingTime = time;
+        hasPending = true;
+    }
+    state.data().clear();
+    wakeUp.notify_one();
+    while (nextTime <= time) {
+        nextTime += interval;
+    }
+}
+
+// Waits until the pending checkpoint is on disk and stops the writer thread.
+void Checkpointer::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+// Body of the writer thread.
+void Checkpointer::writeLoop() {
+    std::vector<char> state;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeUp.wait(lock, [this] { return hasPending || stopping; });
+        if (!hasPending) {
+            return;
+        }
+        state.swap(pending);
+        double time = pendingTime;
+        hasPending = false;
+
+        lock.unlock();
+        bool ok = writeFile(time, state);
+        lock.lock();
+        if (ok) {
+            ++written;
+        }
+    }
+}
+
+// Writes a checkpoint through a temporary file.
+bool Checkpointer::writeFile(double time, const std::vector<char>& state) {
+    CheckpointHeader header = {};
+    std::memcpy(header.magic, "UAVCKPT", 8);
+    header.version = checkpointVersion;
+    header.byteOrder = byteOrderMark;
+    header.time = time;
+    header.size = state.size();
+
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios_base::binary | std::ios_base::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << temporary << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(state.data(), static_cast<std::streamsize>(state.size()));
+        UAVSIM_PROFILE_COUNT_N(CheckpointBytes, sizeof(header) + state.size());
+        if (!file) {
+            std::cerr << "Failed to write checkpoint: " << temporary << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, filename, error);
+    if (error) {
+        std::cerr << "Failed to replace checkpoint " << filename << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Reads a checkpoint file.
+bool Checkpointer::load(const std::string& filename, double& time, std::vector<char>& state) {
+    std::ifstream file(resolveInputPath(filename), std::ios_base::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open checkpoint " << filename << std::endl;
+        return false;
+    }
+    CheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "UAVCKPT", 8) != 0 || header.version != checkpointVersion ||
+        header.byteOrder != byteOrderMark) {
+        std::cerr << "Error: " << filename << " is not a checkpoint of this build" << std::endl;
+        return false;
+    }
+    state.resize(static_cast<std::size_t>(header.size));
+    if (!file.read(state.data(), static_cast<std::streamsize>(state.size()))) {
+        std::cerr << "Error: Checkpoint " << filename << " is truncated" << std::endl;
+        return false;
+    }
+    time = header.time;
+    return true;
+}
@@ -0,0 +1,178 @@
+#pragma once
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Serialized simulation state, built at a synchronization point of the engine.
+// Values are stored as raw bytes in the native byte order: a checkpoint is meant to be resumed
+// by the same build on the same machine, not exchanged between platforms.
+class StateWriter {
+public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Writes the element count followed by the elements.
+    template <typename T, typename Allocator>
+    void writeVector(const std::vector<T, Allocator>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        write<std::uint64_t>(values.size());
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write<std::uint64_t>(value.size());
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    std::vector<char>& data() { return buffer; }
+
+private:
+    std::vector<char> buffer;
+};
+
+// Reads a state written by StateWriter. Every read checks the remaining size; once a read
+// fails, all further reads fail and ok() returns false.
+class StateReader {
+public:
+    StateReader(const char* data, std::size_t size) : position(data), end(data + size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        if (!take(sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&value, position - sizeof(T), sizeof(T));
+        return true;
+    }
+
+    template <typename T, typename Allocator>
+    bool readVector(std::vector<T, Allocator>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        std::uint64_t count = 0;
+        if (!read(count) || count > static_cast<std::uint64_t>(end - position) / sizeof(T)) {
+            valid = false;
+            return false;
+        }
+        values.resize(static_cast<std::size_t>(count));
+        std::size_t bytes = static_cast<std::size_t>(count) * sizeof(T);
+        take(bytes);
+        if (bytes > 0) {
+            std::memcpy(values.data(), position - bytes, bytes);
+        }
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        std::uint64_t count = 0;
+        if (!read(count) || count > static_cast<std::uint64_t>(end - position)) {
+            valid = false;
+            return false;
+        }
+        value.assign(position, static_cast<std::size_t>(count));
+        position += count;
+        return true;
+    }
+
+    bool ok() const { return valid; }
+    bool atEnd() const { return position == end; }
+
+private:
+    bool take(std::size_t bytes) {
+        if (!valid || bytes > static_cast<std::size_t>(end - position)) {
+            valid = false;
+            return false;
+        }
+        position += bytes;
+        return true;
+    }
+
+    const char* position;
+    const char* end;
+    bool valid = true;
+};
+
+// Writes checkpoints at regular simulation-time intervals without stalling the engine.
+// The engine serializes its state into memory (a plain copy) and hands the buffer over; a writer
+// thread puts it on disk through a temporary file that replaces the previous checkpoint, so a
+// crash while writing leaves the previous checkpoint intact. If the writer is still busy when
+// the next checkpoint comes, the pending one is replaced: the file always gets the latest state.
+class Checkpointer {
+public:
+    /**
+    * @param filename The checkpoint file.
+    * @param interval Simulation seconds between two checkpoints.
+    */
+    Checkpointer(const std::string& filename, double interval);
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+    * Returns true when a checkpoint is due at the given simulation time.
+    */
+    bool isDue(double time) const { return interval > 0.0 && time >= nextTime; }
+
+    /**
+    * Hands a serialized state over to the writer thread and schedules the next checkpoint.
+    *
+    * @param time The simulation time of the state.
+    * @param state The state. Its buffer is swapped with a spare one, so its memory is reused.
+    */
+    void submit(double time, StateWriter& state);
+
+    /**
+    * Waits until the pending checkpoint is on disk and stops the writer thread.
+    */
+    void finish();
+
+    /**
+    * Sets the simulation time of the next checkpoint (after a resume).
+    */
+    void startAt(double time) { nextTime = time + interval; }
+
+    std::size_t getWrittenCount() const { return written; }
+
+    /**
+    * Reads a checkpoint file.
+    *
+    * @param filename The checkpoint file, relative to the current directory.
+    * @param time Receives the simulation time of the state.
+    * @param state Receives the serialized state.
+    * @return True if the file is a valid checkpoint, false otherwise.
+    */
+    static bool load(const std::string& filename, double& time, std::vector<char>& state);
+
+private:
+    void writeLoop();
+    bool writeFile(double time, const std::vector<char>& state);
+
+    std::string filename;
+    double interval;
+    double nextTime;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<char> pending;  // State waiting for the writer thread
+    double pendingTime = 0.0;
+    bool hasPending = false;
+    bool stopping = false;
+    std::size_t written = 0;
+};
+
+#endif // CHECKPOINT_H
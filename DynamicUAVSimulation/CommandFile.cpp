@@ -0,0 +1,220 @@
+#include "CommandFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include "Manager.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+namespace {
+    // Binary command file layout: header, then one record per command
+    struct CommandFileHeader {
+        char magic[8];           // "UAVCMDS" followed by a NUL
+        std::uint32_t version;   // Format version
+        std::uint32_t byteOrder; // 0x01020304 written in the native byte order
+        std::uint64_t count;     // Number of commands
+    };
+
+    struct CommandRecord {
+        double time;
+        double x;
+        double y;
+        double z; // NaN when the command keeps the altitude
+        double v; // NaN when the command keeps the speed
+        std::int32_t num;
+        std::int32_t reserved; // Zero, keeps the record free of padding
+    };
+
+    const std::uint32_t commandFileVersion = 2;
+    const std::uint32_t byteOrderMark = 0x01020304;
+
+    // Text files smaller than this are parsed by the calling thread alone
+    const std::size_t bytesPerChunk = 1 << 20;
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Parses one value after optional spaces with the rules of operator>>: a leading '+' is
+    // accepted, while "inf" and "nan" (which from_chars would accept) are not.
+    template <typename T>
+    bool parseValue(const char*& position, const char* end, T& value) {
+        while (position != end && isSpace(*position)) {
+            ++position;
+        }
+        const char* start = position;
+        if (start != end && *start == '+') {
+            ++start; // from_chars does not accept a '+'
+        }
+        const char* digits = start;
+        if (digits != end && *digits == '-' && start == position) {
+            ++digits;
+        }
+        if (digits == end || !((*digits >= '0' && *digits <= '9') || *digits == '.')) {
+            return false;
+        }
+        std::from_chars_result result = std::from_chars(start, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        // operator>> fails on an exponent without digits ("1.5e"), from_chars stops before it
+        if (std::is_floating_point<T>::value && result.ptr != end && (*result.ptr == 'e' || *result.ptr == 'E')) {
+            return false;
+        }
+        position = result.ptr;
+        return true;
+    }
+
+    // Returns the offset of the first line of a chunk: chunks split the file evenly, moved forward
+    // to the next line start, so every line belongs to exactly one chunk.
+    std::size_t chunkStart(const char* data, std::size_t size, std::size_t parts, std::size_t part) {
+        if (part == 0) {
+            return 0;
+        }
+        if (part >= parts) {
+            return size;
+        }
+        std::size_t position = size / parts * part;
+        const char* newline = static_cast<const char*>(std::memchr(data + position - 1, '\n', size - position + 1));
+        return newline != nullptr ? static_cast<std::size_t>(newline + 1 - data) : size;
+    }
+
+    void parseChunk(const char* position, const char* end, std::vector<Command>& commands) {
+        while (position < end) {
+            const char* newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+            const char* lineEnd = newline != nullptr ? newline : end;
+            Command command;
+            if (parseCommandLine(position, lineEnd, command)) {
+                commands.push_back(command);
+            }
+            position = newline != nullptr ? newline + 1 : end;
+        }
+    }
+
+    void loadTextCommands(const char* data, std::size_t size, std::size_t threads, std::vector<Command>& commands) {
+        std::size_t parts = std::max<std::size_t>(1, std::min(threads, size / bytesPerChunk));
+        if (parts == 1) {
+            parseChunk(data, data + size, commands);
+            return;
+        }
+
+        std::vector<std::vector<Command>> chunks(parts);
+        ThreadPool pool(parts);
+        pool.runOnEachThread([data, size, parts, &chunks](std::size_t part) {
+            std::size_t begin = chunkStart(data, size, parts, part);
+            std::size_t end = chunkStart(data, size, parts, part + 1);
+            parseChunk(data + begin, data + end, chunks[part]);
+            });
+
+        std::size_t total = commands.size();
+        for (const auto& chunk : chunks) {
+            total += chunk.size();
+        }
+        commands.reserve(total);
+        for (const auto& chunk : chunks) {
+            commands.insert(commands.end(), chunk.begin(), chunk.end());
+        }
+    }
+
+    bool loadBinaryCommands(const MappedFile& file, const std::string& filename, std::vector<Command>& commands) {
+        CommandFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.version != commandFileVersion || header.byteOrder != byteOrderMark) {
+            std::cerr << "Error: Command file " << filename << " was written by an incompatible build" << std::endl;
+            return false;
+        }
+        if (header.count > (file.size() - sizeof(header)) / sizeof(CommandRecord)) {
+            std::cerr << "Error: Command file " << filename << " is truncated" << std::endl;
+            return false;
+        }
+
+        std::size_t count = static_cast<std::size_t>(header.count);
+        std::size_t first = commands.size();
+        commands.resize(first + count);
+        const char* data = file.data() + sizeof(header);
+        for (std::size_t i = 0; i < count; ++i) {
+            CommandRecord record;
+            std::memcpy(&record, data + i * sizeof(record), sizeof(record));
+            commands[first + i] = { record.time, record.num, record.x, record.y, record.z, record.v };
+        }
+        return true;
+    }
+}
+
+// Parses one text command line.
+bool parseCommandLine(const char* begin, const char* end, Command& command) {
+    if (!(parseValue(begin, end, command.time) && parseValue(begin, end, command.num) &&
+        parseValue(begin, end, command.x) && parseValue(begin, end, command.y))) {
+        return false;
+    }
+    // Optional altitude, then speed; NaN when absent
+    const double absent = std::numeric_limits<double>::quiet_NaN();
+    if (!parseValue(begin, end, command.z)) {
+        command.z = absent;
+        command.v = absent;
+    }
+    else if (!parseValue(begin, end, command.v)) {
+        command.v = absent;
+    }
+    return true;
+}
+
+// Reads a command file, text or binary (recognized by its content).
+bool loadCommandFile(const std::string& filename, std::vector<Command>& commands, std::size_t threads) {
+    MappedFile file;
+    if (!file.openReadOnly(resolveInputPath(filename).string())) {
+        return false;
+    }
+    if (file.size() >= sizeof(CommandFileHeader) && std::memcmp(file.data(), "UAVCMDS", 8) == 0) {
+        return loadBinaryCommands(file, filename, commands);
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    loadTextCommands(file.data(), file.size(), threads, commands);
+    return true;
+}
+
+// Writes commands as a binary command file, sorted by UAV and time.
+bool writeCommandFile(const std::string& filename, const std::vector<Command>& commands) {
+    // The stable sort keeps the file order of commands with the same UAV and time, which decides
+    // the one that wins. Commands with a time that is not positive can never become active.
+    std::vector<Command> sorted;
+    sorted.reserve(commands.size());
+    std::copy_if(commands.begin(), commands.end(), std::back_inserter(sorted),
+        [](const Command& command) { return command.time > 0.0; });
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Command& a, const Command& b) {
+        return a.num != b.num ? a.num < b.num : a.time < b.time;
+        });
+
+    std::ofstream file(filename, std::ios_base::binary | std::ios_base::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+    CommandFileHeader header = {};
+    std::memcpy(header.magic, "UAVCMDS", 8);
+    header.version = commandFileVersion;
+    header.byteOrder = byteOrderMark;
+    header.count = sorted.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<CommandRecord> records(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        records[i] = { sorted[i].time, sorted[i].x, sorted[i].y, sorted[i].z, sorted[i].v, sorted[i].num, 0 };
+    }
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CommandRecord)));
+    if (!file) {
+        std::cerr << "Failed to write command file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef COMMANDFILE_H
+#define COMMANDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "CommandScheduler.h"
+
+// Command files.
+//
+// Text files (SimCmds.txt) hold one "<time> <num> <x> <y> [<z> [<v>]]" command per line; lines
+// that do not start with at least four such values are skipped. The altitude z and the speed v are
+// setpoints of the 3D motion model (MotionModel=1); the planar model ignores them. They are memory-mapped and parsed in place with
+// std::from_chars; large files are split into chunks at line boundaries and parsed by several
+// threads, then the chunks are joined in file order.
+//
+// Binary files ("UAVCMDS" header, then fixed-size records) hold the same commands sorted by UAV
+// and time, keeping the file order of commands with the same UAV and time, so they load with a
+// single pass and give the scheduler buckets that are already sorted. writeCommandFile() converts
+// any command list to this format without changing which command wins.
+
+/**
+* Parses one text command line.
+*
+* @param begin The first character of the line.
+* @param end One past the last character of the line (the line break is optional).
+* @param command Receives the command.
+* @return True if the line starts with a command, false otherwise.
+*/
+bool parseCommandLine(const char* begin, const char* end, Command& command);
+
+/**
+* Reads a command file, text or binary (recognized by its content).
+*
+* @param filename The command file, relative to the current directory.
+* @param commands Receives the commands, in file order.
+* @param threads The number of threads parsing a large text file (0 = one per core).
+* @return True if the file was read, false otherwise.
+*/
+bool loadCommandFile(const std::string& filename, std::vector<Command>& commands, std::size_t threads = 0);
+
+/**
+* Writes commands as a binary command file, sorted by UAV and time.
+*
+* @param filename The file to create.
+* @param commands The commands, in file order.
+* @return True if the file was written, false otherwise.
+*/
+bool writeCommandFile(const std::string& filename, const std::vector<Command>& commands);
+
+#endif // COMMANDFILE_H
@@ -0,0 +1,15 @@
+#include "CommandQueue.h"
+
+namespace {
+    std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t power = 1;
+        while (power < value) {
+            power <<= 1;
+        }
+        return power;
+    }
+}
+
+// Constructor - allocates all the slots
+CommandQueue::CommandQueue(std::size_t capacity)
+    : slots(roundUpToPowerOfTwo(capacity > 0 ? capacity : 1)), mask(slots.size() - 1) {}
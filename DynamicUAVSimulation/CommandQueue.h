@@ -0,0 +1,64 @@
+#pragma once
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "CommandScheduler.h"
+
+// Bounded lock-free queue of commands between one producer thread and one consumer thread.
+// The slots are allocated once; the producer only writes the tail index and the consumer only
+// writes the head index, each on its own cache line, so neither side ever blocks the other.
+class CommandQueue {
+public:
+    /**
+    * @param capacity The minimum number of queued commands. It is rounded up to a power of two.
+    */
+    explicit CommandQueue(std::size_t capacity);
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+    * Appends a command. Producer thread only.
+    *
+    * @param command The command to append.
+    * @return True if the command was queued, false if the queue is full.
+    */
+    bool push(const Command& command) {
+        std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[tail & mask] = command;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * Removes the oldest command. Consumer thread only.
+    *
+    * @param command Receives the command.
+    * @return True if a command was removed, false if the queue is empty.
+    */
+    bool pop(Command& command) {
+        std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        command = slots[head & mask];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    std::vector<Command> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> headIndex{ 0 }; // Next slot to read
+    alignas(64) std::atomic<std::size_t> tailIndex{ 0 }; // Next slot to write
+};
+
+#endif // COMMANDQUEUE_H
@@ -0,0 +1,122 @@
+#include "CommandScheduler.h"
+
+#include <algorithm>
+#include <utility>
+#include "Checkpoint.h"
+#include "Profiler.h"
+
+// Builds the per-UAV buckets.
+CommandScheduler::CommandScheduler(const std::vector<Command>& commands, int nUav)
+    : buckets(std::make_shared<std::vector<std::vector<Command>>>(nUav > 0 ? nUav : 0)),
+      cursors(buckets->size(), 0), nextTimes(buckets->size(), std::numeric_limits<double>::infinity()) {
+    auto accepted = [nUav](const Command& command) {
+        return command.num >= 1 && command.num <= nUav && command.time > 0.0;
+    };
+    std::vector<std::vector<Command>>& all = *buckets;
+    std::vector<std::size_t> counts(all.size(), 0);
+    for (const auto& command : commands) {
+        if (accepted(command)) {
+            ++counts[command.num - 1];
+        }
+    }
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        all[i].reserve(counts[i]);
+    }
+    for (const auto& command : commands) {
+        if (accepted(command)) {
+            all[command.num - 1].push_back(command);
+        }
+    }
+
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        std::vector<Command>& bucket = all[i];
+        auto earlier = [](const Command& a, const Command& b) { return a.time < b.time; };
+        // Files listing the commands in time order (and binary command files) need no sort
+        if (!std::is_sorted(bucket.begin(), bucket.end(), earlier)) {
+            std::stable_sort(bucket.begin(), bucket.end(), earlier);
+        }
+        // Among several commands with the same time the last one activated wins: put the one
+        // listed first in the file last, as it always did.
+        for (auto run = bucket.begin(); run != bucket.end();) {
+            auto runEnd = std::upper_bound(run, bucket.end(), *run, earlier);
+            std::reverse(run, runEnd);
+            run = runEnd;
+        }
+        if (!bucket.empty()) {
+            nextTimes[i] = bucket.front().time;
+        }
+    }
+}
+
+// Moves the cursor of a UAV past every command whose time is before the current time.
+void CommandScheduler::activate(std::size_t index, double currentTime) {
+    // Several commands of the same UAV may have started during the last step
+    const std::vector<Command>& bucket = (*buckets)[index];
+    std::size_t& cursor = cursors[index];
+    while (cursor < bucket.size() && bucket[cursor].time < currentTime) {
+        UAVSIM_PROFILE_COUNT(CommandActivations);
+        ++cursor;
+    }
+    nextTimes[index] = cursor < bucket.size() ? bucket[cursor].time : std::numeric_limits<double>::infinity();
+}
+
+// Returns the buckets for modification, copying them first if other schedulers share them.
+std::vector<std::vector<Command>>& CommandScheduler::ownBuckets() {
+    if (buckets.use_count() > 1) {
+        buckets = std::make_shared<std::vector<std::vector<Command>>>(*buckets);
+    }
+    return *buckets;
+}
+
+// Adds a command while the simulation runs.
+bool CommandScheduler::insert(Command command, double currentTime) {
+    // Same rules as the commands known in advance
+    if (command.num < 1 || static_cast<std::size_t>(command.num) > buckets->size() || !(command.time > 0.0)) {
+        return false;
+    }
+    command.time = std::max(command.time, currentTime);
+    // Active commands are never moved. Among pending commands with the same time the new one goes
+    // first, like a command listed later in the file, so the earlier one still wins.
+    std::size_t index = static_cast<std::size_t>(command.num) - 1;
+    std::vector<Command>& bucket = ownBuckets()[index];
+    auto position = std::lower_bound(bucket.begin() + cursors[index], bucket.end(), command.time,
+        [](const Command& pending, double time) { return pending.time < time; });
+    bucket.insert(position, command);
+    nextTimes[index] = bucket[cursors[index]].time;
+    return true;
+}
+
+// Returns the latest active command of a UAV.
+const Command* CommandScheduler::activeCommand(std::size_t index) const {
+    if (cursors[index] == 0) {
+        return nullptr;
+    }
+    return &(*buckets)[index][cursors[index] - 1];
+}
+
+// Saves the commands and cursors of every UAV into a checkpoint.
+// The buckets are saved too, since streamed commands may have been added to them.
+void CommandScheduler::saveState(StateWriter& state) const {
+    state.write<std::uint64_t>(buckets->size());
+    for (const auto& bucket : *buckets) {
+        state.writeVector(bucket);
+    }
+    state.writeVector(cursors);
+    state.writeVector(nextTimes);
+}
+
+// Restores the scheduler saved by saveState().
+bool CommandScheduler::restoreState(StateReader& state) {
+    std::uint64_t count = 0;
+    if (!state.read(count) || count != buckets->size()) {
+        return false;
+    }
+    std::vector<std::vector<Command>> restored(buckets->size());
+    for (auto& bucket : restored) {
+        state.readVector(bucket);
+    }
+    state.readVector(cursors);
+    state.readVector(nextTimes);
+    buckets = std::make_shared<std::vector<std::vector<Command>>>(std::move(restored));
+    return state.ok() && cursors.size() == buckets->size() && nextTimes.size() == buckets->size();
+}
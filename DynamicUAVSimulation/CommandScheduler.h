@@ -0,0 +1,104 @@
+#pragma once
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class StateReader;
+class StateWriter;
+
+// Structure to hold command data
+struct Command {
+    double time; // Command execution time
+    int num;     // Number of the UAV
+    double x;    // X coordinate of the new destination
+    double y;    // Y coordinate of the new destination
+    double z = std::numeric_limits<double>::quiet_NaN(); // Altitude setpoint (NaN = keep the current one, 3D motion model)
+    double v = std::numeric_limits<double>::quiet_NaN(); // Speed setpoint (NaN = keep the current one, 3D motion model)
+};
+
+// Time-indexed command scheduler.
+// Commands are bucketed per UAV and sorted by time. Every UAV has a cursor on its next pending
+// command, so advancing the clock costs one comparison per UAV and only does work when a command
+// becomes active. Different UAVs can be advanced concurrently.
+// Copies of a scheduler share its buckets and only have their own cursors, so copying a prepared
+// scheduler for every run costs O(number of UAVs); a copy that inserts commands or restores a
+// checkpoint gets its own buckets first.
+class CommandScheduler {
+public:
+    /**
+    * Builds the per-UAV buckets.
+    * Commands addressed to unknown UAVs or with a time that is not positive are ignored,
+    * since they could never become active.
+    *
+    * @param commands The commands, in file order.
+    * @param nUav The number of UAVs.
+    */
+    CommandScheduler(const std::vector<Command>& commands, int nUav);
+
+    /**
+    * Activates every command of a UAV whose time is before the current time.
+    *
+    * @param index The zero-based index of the UAV.
+    * @param currentTime The current simulation time.
+    * @return The latest active command of the UAV, or nullptr if no command is active yet.
+    */
+    const Command* advance(std::size_t index, double currentTime) {
+        if (nextTimes[index] < currentTime) {
+            activate(index, currentTime);
+        }
+        return activeCommand(index);
+    }
+
+    /**
+    * Adds a command while the simulation runs (streamed commands).
+    * The command is placed among the pending commands of its UAV; a command time before
+    * currentTime is raised to currentTime, so late commands take effect at the next step.
+    * Must not be called while advance() runs.
+    *
+    * @param command The command to add.
+    * @param currentTime The current simulation time.
+    * @return True if the command was added, false if it addresses an unknown UAV or can never become active.
+    */
+    bool insert(Command command, double currentTime);
+
+    /**
+    * Returns the latest active command of a UAV.
+    *
+    * @param index The zero-based index of the UAV.
+    * @return The active command, or nullptr if no command is active yet.
+    */
+    const Command* activeCommand(std::size_t index) const;
+
+    /**
+    * Returns all commands of a UAV, sorted by the time they become active.
+    *
+    * @param index The zero-based index of the UAV.
+    */
+    const std::vector<Command>& commandsOf(std::size_t index) const { return (*buckets)[index]; }
+
+    /**
+    * Saves the commands and cursors of every UAV into a checkpoint.
+    */
+    void saveState(StateWriter& state) const;
+
+    /**
+    * Restores the scheduler saved by saveState(). The number of UAVs must be the same.
+    *
+    * @return True if the scheduler was restored, false otherwise.
+    */
+    bool restoreState(StateReader& state);
+
+private:
+    void activate(std::size_t index, double currentTime);
+    std::vector<std::vector<Command>>& ownBuckets();
+
+    std::shared_ptr<std::vector<std::vector<Command>>> buckets; // Commands of every UAV, sorted by time
+    std::vector<std::size_t> cursors;          // Number of active commands of every UAV
+    std::vector<double> nextTimes;             // Time of the next pending command of every UAV
+};
+
+#endif // COMMANDSCHEDULER_H
@@ -0,0 +1,137 @@
+#include "CommandStream.h"
+
+#include <chrono>
+#include <iostream>
+#include "CommandFile.h"
+#include "Manager.h"
+#include "TargetDispatcher.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    int openForReading(const std::string& path) {
+#ifdef _WIN32
+        return _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        // Non-blocking, so opening a FIFO does not wait for a writer and reading never blocks
+        return ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+#endif
+    }
+
+    // Returns the number of bytes read, 0 or less when nothing is available yet.
+    long readSome(int descriptor, char* buffer, std::size_t size) {
+#ifdef _WIN32
+        return _read(descriptor, buffer, static_cast<unsigned>(size));
+#else
+        return static_cast<long>(::read(descriptor, buffer, size));
+#endif
+    }
+
+    void closeDescriptor(int descriptor) {
+#ifdef _WIN32
+        _close(descriptor);
+#else
+        ::close(descriptor);
+#endif
+    }
+}
+
+// Constructor
+CommandStream::CommandStream(std::size_t queueCapacity, double pollInterval)
+    : queue(queueCapacity), pollInterval(pollInterval > 0.0 ? pollInterval : 0.001) {}
+
+// Destructor - stops the reader thread
+CommandStream::~CommandStream() {
+    close();
+}
+
+// Opens the stream and starts the reader thread.
+bool CommandStream::open(const std::string& filename) {
+    close();
+    descriptor = openForReading(resolveInputPath(filename).string());
+    if (descriptor < 0) {
+        std::cerr << "Error: Unable to open command stream " << filename << std::endl;
+        return false;
+    }
+    stopRequested.store(false);
+    reader = std::thread(&CommandStream::readLoop, this);
+    return true;
+}
+
+// Stops the reader thread and closes the stream.
+void CommandStream::close() {
+    stopRequested.store(true, std::memory_order_release);
+    if (reader.joinable()) {
+        reader.join();
+    }
+    if (descriptor >= 0) {
+        closeDescriptor(descriptor);
+        descriptor = -1;
+    }
+}
+
+// Moves every queued command into the scheduler, and the targets into the dispatcher.
+std::size_t CommandStream::drainInto(CommandScheduler& scheduler, double currentTime, TargetDispatcher* dispatcher) {
+    std::size_t added = 0;
+    Command command;
+    while (queue.pop(command)) {
+        if (command.num == 0 && dispatcher != nullptr && command.time > 0.0) {
+            dispatcher->add(command);
+            ++added;
+        }
+        else if (scheduler.insert(command, currentTime)) {
+            ++added;
+        }
+        else {
+            ++ignored;
+        }
+    }
+    received += added;
+    return added;
+}
+
+// Body of the reader thread.
+void CommandStream::readLoop() {
+    const auto pause = std::chrono::duration<double>(pollInterval);
+    std::string pending; // Data after the last complete line
+    char buffer[4096];
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        long count = readSome(descriptor, buffer, sizeof(buffer));
+        if (count <= 0) {
+            // End of the file for now (or no FIFO writer): wait for more data
+            std::this_thread::sleep_for(pause);
+            continue;
+        }
+        pending.append(buffer, static_cast<std::size_t>(count));
+
+        // Only complete lines are parsed; a partial last line waits for the rest of its data
+        std::size_t start = 0;
+        std::size_t newline;
+        while ((newline = pending.find('\n', start)) != std::string::npos) {
+            queueLine(pending.substr(start, newline - start));
+            start = newline + 1;
+        }
+        pending.erase(0, start);
+    }
+}
+
+// Parses a line and queues the command, waiting while the queue is full.
+void CommandStream::queueLine(const std::string& line) {
+    Command command;
+    if (!parseCommandLine(line.data(), line.data() + line.size(), command)) {
+        return;
+    }
+    const auto pause = std::chrono::duration<double>(pollInterval);
+    while (!queue.push(command)) {
+        if (stopRequested.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::this_thread::sleep_for(pause);
+    }
+}
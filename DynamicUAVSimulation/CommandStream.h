@@ -0,0 +1,75 @@
+#pragma once
+#ifndef COMMANDSTREAM_H
+#define COMMANDSTREAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include "CommandQueue.h"
+#include "CommandScheduler.h"
+
+class TargetDispatcher;
+
+// Commands received while the simulation runs.
+// A reader thread follows a file like `tail -f` (or reads a FIFO on POSIX systems), parses every
+// complete line in the SimCmds.txt format and pushes the commands into a lock-free queue. The
+// engine drains the queue into its scheduler at every synchronization point, so new commands are
+// picked up within one synchronization interval plus one poll interval, without reloading anything.
+class CommandStream {
+public:
+    /**
+    * @param queueCapacity The number of commands buffered between the reader and the engine.
+    * @param pollInterval Wall-clock seconds the reader waits when no new data is available.
+    */
+    CommandStream(std::size_t queueCapacity, double pollInterval);
+    ~CommandStream();
+
+    CommandStream(const CommandStream&) = delete;
+    CommandStream& operator=(const CommandStream&) = delete;
+
+    /**
+    * Opens the stream and starts the reader thread.
+    *
+    * @param filename The file or FIFO to follow, relative to the current directory.
+    * @return True if the stream was opened, false otherwise.
+    */
+    bool open(const std::string& filename);
+
+    /**
+    * Stops the reader thread and closes the stream.
+    */
+    void close();
+
+    /**
+    * Moves every queued command into the scheduler, and the commands addressed to UAV 0 (targets)
+    * into the target dispatcher.
+    * Called by the engine at a synchronization point.
+    *
+    * @param scheduler The scheduler receiving the commands.
+    * @param currentTime The current simulation time; older commands take effect now.
+    * @param dispatcher The dispatcher receiving the targets, or nullptr to ignore them.
+    * @return The number of commands and targets added.
+    */
+    std::size_t drainInto(CommandScheduler& scheduler, double currentTime, TargetDispatcher* dispatcher = nullptr);
+
+    std::size_t getReceivedCount() const { return received; }
+    std::size_t getIgnoredCount() const { return ignored; }
+
+private:
+    // Body of the reader thread.
+    void readLoop();
+
+    // Parses a line and queues the command, waiting while the queue is full.
+    void queueLine(const std::string& line);
+
+    CommandQueue queue;
+    double pollInterval;
+    int descriptor = -1;
+    std::thread reader;
+    std::atomic<bool> stopRequested{ false };
+    std::size_t received = 0; // Commands added to the scheduler
+    std::size_t ignored = 0;  // Commands addressed to unknown UAVs or with a time that is not positive
+};
+
+#endif // COMMANDSTREAM_H
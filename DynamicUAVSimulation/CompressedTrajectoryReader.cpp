@@ -0,0 +1,148 @@
+#include "CompressedTrajectoryReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Maps the file and loads its block index.
+bool CompressedTrajectoryReader::open(const std::string& filename) {
+    file.close();
+    nums.clear();
+    blocks.clear();
+    if (!file.openReadOnly(filename)) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    CompressedTrajectoryHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: " << filename << " is not a compressed trajectory file" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    blocksOffset = sizeof(header) + static_cast<std::size_t>(header.nUav) * sizeof(std::int32_t);
+    if (std::memcmp(header.magic, "UAVZTRJ", 8) != 0 || header.version != 1 || file.size() < blocksOffset ||
+        !(header.timeResolution > 0.0) || !(header.positionResolution > 0.0) || !(header.angleResolution > 0.0)) {
+        std::cerr << "Error: " << filename << " is not a compressed trajectory file" << std::endl;
+        return false;
+    }
+    resolution.time = header.timeResolution;
+    resolution.position = header.positionResolution;
+    resolution.angle = header.angleResolution;
+    altitude = (header.flags & CompressedTrajectoryHeader::Altitude) != 0;
+
+    std::vector<std::int32_t> numbers(header.nUav);
+    std::memcpy(numbers.data(), file.data() + sizeof(header), numbers.size() * sizeof(std::int32_t));
+    nums.assign(numbers.begin(), numbers.end());
+    blocks.resize(nums.size());
+
+    if (!loadIndex() && !scanBlocks()) {
+        std::cerr << "Warning: " << filename << " was not closed; its last block is incomplete" << std::endl;
+    }
+    return true;
+}
+
+// Loads the block index written at the end of a closed file.
+bool CompressedTrajectoryReader::loadIndex() {
+    CompressedTrajectoryTrailer trailer;
+    if (file.size() < blocksOffset + sizeof(trailer)) {
+        return false;
+    }
+    std::memcpy(&trailer, file.data() + file.size() - sizeof(trailer), sizeof(trailer));
+    if (std::memcmp(trailer.magic, "UAVZIDX", 8) != 0 || trailer.indexOffset < blocksOffset ||
+        trailer.blockCount > (file.size() - sizeof(trailer)) / sizeof(CompressedBlockIndexEntry) ||
+        trailer.indexOffset + trailer.blockCount * sizeof(CompressedBlockIndexEntry) + sizeof(trailer) != file.size()) {
+        return false;
+    }
+    const char* entries = file.data() + trailer.indexOffset;
+    for (std::uint64_t i = 0; i < trailer.blockCount; ++i) {
+        CompressedBlockIndexEntry entry;
+        std::memcpy(&entry, entries + i * sizeof(entry), sizeof(entry));
+        if (entry.uav >= blocks.size() || entry.offset + sizeof(CompressedBlockHeader) > trailer.indexOffset) {
+            for (auto& list : blocks) {
+                list.clear();
+            }
+            return false;
+        }
+        blocks[entry.uav].push_back(entry);
+    }
+    return true;
+}
+
+// Builds the block index by walking the blocks (file of an unfinished run).
+// Returns false if the file ends with an incomplete block.
+bool CompressedTrajectoryReader::scanBlocks() {
+    std::size_t position = blocksOffset;
+    while (position + sizeof(CompressedBlockHeader) <= file.size()) {
+        CompressedBlockHeader header;
+        std::memcpy(&header, file.data() + position, sizeof(header));
+        std::size_t next = position + sizeof(header) + header.payloadBytes;
+        if (std::memcmp(header.magic, "UAVB", 4) != 0 || header.uav >= blocks.size() || next > file.size()) {
+            return false;
+        }
+        CompressedBlockIndexEntry entry;
+        entry.uav = header.uav;
+        entry.sampleCount = header.sampleCount;
+        entry.firstTime = header.first[0];
+        entry.lastTime = header.lastTime;
+        entry.offset = position;
+        blocks[header.uav].push_back(entry);
+        position = next;
+    }
+    return position == file.size();
+}
+
+// Decodes one block.
+bool CompressedTrajectoryReader::decodeBlock(const CompressedBlockIndexEntry& entry,
+                                             std::vector<TrajectorySample>& samples) const {
+    CompressedBlockHeader header;
+    std::memcpy(&header, file.data() + entry.offset, sizeof(header));
+    if (std::memcmp(header.magic, "UAVB", 4) != 0 ||
+        entry.offset + sizeof(header) + header.payloadBytes > file.size()) {
+        return false;
+    }
+    return decodeTrajectoryBlock(header, file.data() + entry.offset + sizeof(header), resolution, samples);
+}
+
+// Decodes all samples of a UAV.
+bool CompressedTrajectoryReader::read(std::size_t index, std::vector<TrajectorySample>& samples) const {
+    samples.clear();
+    if (index >= blocks.size()) {
+        return false;
+    }
+    for (const CompressedBlockIndexEntry& entry : blocks[index]) {
+        if (!decodeBlock(entry, samples)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decodes the samples of a UAV between two times, from the blocks overlapping the window.
+bool CompressedTrajectoryReader::read(std::size_t index, double begin, double end,
+                                      std::vector<TrajectorySample>& samples) const {
+    samples.clear();
+    if (index >= blocks.size()) {
+        return false;
+    }
+    // Half a time unit of slack: the times in the file are rounded
+    const double slack = 0.5 * resolution.time;
+    const std::vector<CompressedBlockIndexEntry>& list = blocks[index];
+    auto first = std::lower_bound(list.begin(), list.end(), begin - slack,
+        [this](const CompressedBlockIndexEntry& entry, double time) {
+            return static_cast<double>(entry.lastTime) * resolution.time < time;
+        });
+    std::vector<TrajectorySample> decoded;
+    for (auto it = first; it != list.end() && static_cast<double>(it->firstTime) * resolution.time <= end + slack; ++it) {
+        decoded.clear();
+        if (!decodeBlock(*it, decoded)) {
+            return false;
+        }
+        for (const TrajectorySample& sample : decoded) {
+            if (sample.time >= begin - slack && sample.time <= end + slack) {
+                samples.push_back(sample);
+            }
+        }
+    }
+    return true;
+}
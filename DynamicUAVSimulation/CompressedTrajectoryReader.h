@@ -0,0 +1,65 @@
+#pragma once
+#ifndef COMPRESSEDTRAJECTORYREADER_H
+#define COMPRESSEDTRAJECTORYREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "TrajectoryCodec.h"
+
+// Reads a compressed trajectory file written by CompressedTrajectoryWriter.
+// The file is memory-mapped; the block index at its end (or, for a file whose writer did not
+// finish, a walk over the blocks) tells where the blocks of every UAV are and which times they
+// cover, so a time window is decoded without touching the rest of the file.
+class CompressedTrajectoryReader {
+public:
+    /**
+    * Maps the file and loads its block index.
+    *
+    * @param filename The compressed trajectory file.
+    * @return True if the file is a valid compressed trajectory file, false otherwise.
+    */
+    bool open(const std::string& filename);
+
+    std::size_t uavCount() const { return nums.size(); }
+    const std::vector<int>& getNums() const { return nums; }
+    const TrajectoryResolution& getResolution() const { return resolution; }
+    bool hasAltitude() const { return altitude; }
+
+    /**
+    * Decodes all samples of a UAV.
+    *
+    * @param index The zero-based UAV index.
+    * @param samples Receives the samples in time order.
+    * @return True if every block was decoded, false otherwise.
+    */
+    bool read(std::size_t index, std::vector<TrajectorySample>& samples) const;
+
+    /**
+    * Decodes the samples of a UAV between two times (inclusive); only the blocks overlapping
+    * the window are decoded.
+    *
+    * @param index The zero-based UAV index.
+    * @param begin The start of the window, in seconds.
+    * @param end The end of the window, in seconds.
+    * @param samples Receives the samples in time order.
+    * @return True if the blocks were decoded, false otherwise.
+    */
+    bool read(std::size_t index, double begin, double end, std::vector<TrajectorySample>& samples) const;
+
+private:
+    bool loadIndex();
+    bool scanBlocks();
+    bool decodeBlock(const CompressedBlockIndexEntry& entry, std::vector<TrajectorySample>& samples) const;
+
+    MappedFile file;
+    std::vector<int> nums;
+    TrajectoryResolution resolution;
+    bool altitude = false;
+    std::size_t blocksOffset = 0;
+    std::vector<std::vector<CompressedBlockIndexEntry>> blocks; // Blocks of every UAV in time order
+};
+
+#endif // COMPRESSEDTRAJECTORYREADER_H
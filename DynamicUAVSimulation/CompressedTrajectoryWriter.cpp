@@ -0,0 +1,181 @@
+#include "CompressedTrajectoryWriter.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include "Checkpoint.h"
+#include "Profiler.h"
+
+// Constructor
+CompressedTrajectoryWriter::CompressedTrajectoryWriter(std::size_t blockSamples, const TrajectoryResolution& resolution,
+                                                       bool altitude)
+    : blockSamples(blockSamples > 0 ? blockSamples : 1), resolution(resolution), altitude(altitude) {}
+
+// Destructor - makes sure nothing buffered is lost
+CompressedTrajectoryWriter::~CompressedTrajectoryWriter() {
+    close();
+}
+
+// Creates (or truncates) the output file and writes its header.
+bool CompressedTrajectoryWriter::open(const std::string& filename, const std::vector<int>& nums, bool append) {
+    close();
+    this->filename = filename;
+    channels.clear();
+    channels.resize(nums.size());
+    index.clear();
+    fileBytes = 0;
+
+    file.open(filename, std::ios_base::binary | (append ? std::ios_base::app : std::ios_base::trunc));
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+    if (append) {
+        // restoreState() cuts the file back to its length at the checkpoint
+        return true;
+    }
+
+    CompressedTrajectoryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "UAVZTRJ", 8);
+    header.version = 1;
+    header.nUav = static_cast<std::uint32_t>(nums.size());
+    header.blockSamples = static_cast<std::uint32_t>(blockSamples);
+    header.flags = altitude ? CompressedTrajectoryHeader::Altitude : 0;
+    header.timeResolution = resolution.time;
+    header.positionResolution = resolution.position;
+    header.angleResolution = resolution.angle;
+    std::vector<std::int32_t> numbers(nums.begin(), nums.end());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(numbers.data()), static_cast<std::streamsize>(numbers.size() * sizeof(std::int32_t)));
+    fileBytes = sizeof(header) + numbers.size() * sizeof(std::int32_t);
+    if (!file) {
+        std::cerr << "Failed to write file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Encodes a sample; a full block waits for the next synchronization.
+void CompressedTrajectoryWriter::record(std::size_t index, const TrajectorySample& sample) {
+    Channel& channel = channels[index];
+    channel.encoder.add(sample, resolution);
+    if (channel.encoder.size() >= blockSamples) {
+        CompressedBlockIndexEntry entry;
+        std::uint64_t position = channel.completed.size();
+        channel.encoder.finishBlock(static_cast<std::uint32_t>(index), channel.completed, entry);
+        entry.offset = position; // Relative to `completed` until the block is written
+        channel.entries.push_back(entry);
+    }
+}
+
+// Writes the completed blocks of every UAV, in UAV order.
+void CompressedTrajectoryWriter::writeCompleted() {
+    for (auto& channel : channels) {
+        if (channel.completed.empty()) {
+            continue;
+        }
+        for (CompressedBlockIndexEntry& entry : channel.entries) {
+            entry.offset += fileBytes;
+            index.push_back(entry);
+        }
+        UAVSIM_PROFILE_COUNT_N(OutputBytes, channel.completed.size());
+        UAVSIM_PROFILE_COUNT(OutputWriteCalls);
+        file.write(channel.completed.data(), static_cast<std::streamsize>(channel.completed.size()));
+        fileBytes += channel.completed.size();
+        channel.completed.clear();
+        channel.entries.clear();
+    }
+}
+
+// Writes the completed blocks.
+void CompressedTrajectoryWriter::synchronize(double time) {
+    (void)time;
+    writeCompleted();
+}
+
+// Ends the blocks of every UAV and writes them.
+void CompressedTrajectoryWriter::flush() {
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        Channel& channel = channels[i];
+        CompressedBlockIndexEntry entry;
+        std::uint64_t position = channel.completed.size();
+        if (channel.encoder.finishBlock(static_cast<std::uint32_t>(i), channel.completed, entry)) {
+            entry.offset = position;
+            channel.entries.push_back(entry);
+        }
+    }
+    writeCompleted();
+    file.flush();
+}
+
+// Returns the number of bytes written to the file so far.
+std::uint64_t CompressedTrajectoryWriter::bytesWritten() const {
+    return closedBytes + fileBytes;
+}
+
+// Saves the file length, the block index and the blocks being encoded.
+void CompressedTrajectoryWriter::saveState(StateWriter& state) const {
+    state.write(fileBytes);
+    state.writeVector(index);
+    state.write<std::uint64_t>(channels.size());
+    for (const auto& channel : channels) {
+        channel.encoder.saveState(state);
+        state.writeString(channel.completed);
+        state.writeVector(channel.entries);
+    }
+}
+
+// Cuts the file back to its length at the checkpoint and restores the blocks being encoded.
+bool CompressedTrajectoryWriter::restoreState(StateReader& state) {
+    std::uint64_t count = 0;
+    state.read(fileBytes);
+    state.readVector(index);
+    if (!state.read(count) || count != channels.size()) {
+        return false;
+    }
+    for (auto& channel : channels) {
+        if (!channel.encoder.restoreState(state) || !state.readString(channel.completed) ||
+            !state.readVector(channel.entries)) {
+            return false;
+        }
+    }
+
+    file.flush();
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(filename, error);
+    if (error || size < fileBytes) {
+        std::cerr << "Error: " << filename << " is shorter than at the checkpoint" << std::endl;
+        return false;
+    }
+    std::filesystem::resize_file(filename, fileBytes, error);
+    if (error) {
+        std::cerr << "Failed to truncate file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Writes the remaining blocks and the block index, and closes the file.
+void CompressedTrajectoryWriter::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    flush();
+    CompressedTrajectoryTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    trailer.indexOffset = fileBytes;
+    trailer.blockCount = index.size();
+    std::memcpy(trailer.magic, "UAVZIDX", 8);
+    file.write(reinterpret_cast<const char*>(index.data()),
+        static_cast<std::streamsize>(index.size() * sizeof(CompressedBlockIndexEntry)));
+    file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    if (!file) {
+        std::cerr << "Failed to write file: " << filename << std::endl;
+    }
+    closedBytes += fileBytes + index.size() * sizeof(CompressedBlockIndexEntry) + sizeof(trailer);
+    fileBytes = 0;
+    file.close();
+    channels.clear();
+    index.clear();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef COMPRESSEDTRAJECTORYWRITER_H
+#define COMPRESSEDTRAJECTORYWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TrajectoryCodec.h"
+#include "TrajectorySink.h"
+
+// Writes all UAV trajectories into one compressed file (format in TrajectoryCodec.h).
+// Every UAV encodes its samples into its own block; completed blocks are written at the next
+// synchronization in UAV order, so the file does not depend on the number of threads.
+class CompressedTrajectoryWriter : public TrajectorySink {
+public:
+    /**
+    * @param blockSamples The most samples in a block.
+    * @param resolution The quantization steps of time, position and azimuth.
+    * @param altitude Mark the altitude as part of the trajectory (3D motion model).
+    */
+    CompressedTrajectoryWriter(std::size_t blockSamples, const TrajectoryResolution& resolution, bool altitude = false);
+    ~CompressedTrajectoryWriter() override;
+
+    CompressedTrajectoryWriter(const CompressedTrajectoryWriter&) = delete;
+    CompressedTrajectoryWriter& operator=(const CompressedTrajectoryWriter&) = delete;
+
+    /**
+    * Creates (or truncates) the output file.
+    *
+    * @param filename The name of the file to create.
+    * @param nums The UAV numbers, indexed by UAV index.
+    * @param append Keep the existing content of the file (to resume from a checkpoint).
+    * @return True if the file was created, false otherwise.
+    */
+    bool open(const std::string& filename, const std::vector<int>& nums, bool append = false);
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+
+    /**
+    * Writes the completed blocks.
+    */
+    void synchronize(double time) override;
+
+    /**
+    * Ends the blocks of every UAV and writes them.
+    */
+    void flush() override;
+    std::uint64_t bytesWritten() const override;
+
+    /**
+    * Saves the file length, the block index and the blocks being encoded.
+    */
+    void saveState(StateWriter& state) const override;
+
+    /**
+    * Cuts the file back to its length at the checkpoint and restores the blocks being encoded.
+    */
+    bool restoreState(StateReader& state) override;
+
+    /**
+    * Writes the remaining blocks and the block index, and closes the file.
+    */
+    void close();
+
+private:
+    struct Channel {
+        TrajectoryBlockEncoder encoder;
+        std::string completed; // Blocks waiting for the next synchronization
+        std::vector<CompressedBlockIndexEntry> entries;
+    };
+
+    void writeCompleted();
+
+    std::size_t blockSamples;
+    TrajectoryResolution resolution;
+    bool altitude;
+    std::string filename;
+    std::ofstream file;
+    std::vector<Channel> channels;
+    std::vector<CompressedBlockIndexEntry> index; // Every block written so far
+    std::uint64_t fileBytes = 0;
+    std::uint64_t closedBytes = 0;
+};
+
+#endif // COMPRESSEDTRAJECTORYWRITER_H
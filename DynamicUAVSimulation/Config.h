@@ -0,0 +1,63 @@
+#pragma once
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+// Structure to hold configuration data
+struct Config {
+    double Dt;      // Time step
+    int N_uav;      // Number of UAVs
+    double R;       // Minimum turning radius
+    double X0;      // Initial X coordinate
+    double Y0;      // Initial Y coordinate
+    double Z0;      // Initial Z coordinate
+    double V0;      // Initial velocity
+    double Az;      // Initial azimuth
+    double TimeLim; // Time limit
+    std::size_t OutputBufferBytes = 65536; // Per-UAV output buffer size that triggers a write
+    double OutputFlushInterval = 0.0;  // Simulation seconds between forced writes (0 = only when the buffer is full)
+    bool BinaryOutput = false;         // Also write all trajectories to UAVTrajectories.bin
+    int BinaryPrecision = 64;          // Bits per position/azimuth value in the binary output (32 or 64)
+    int Threads = 0;                   // Worker threads for the tick loop (0 = one per core, capped by fleet size)
+    int TicksPerSync = 1;              // Ticks each thread runs between two synchronizations
+    int Engine = 0;                    // 0 = fixed Dt steps, 1 = event-driven closed-form propagation
+    double OutputInterval = 0.0;       // Seconds between output samples (0 = every step of Dt)
+    int OutputDecimation = 1;          // Keep every N-th output sample
+    std::map<int, int> OutputDecimationPerUAV; // "OutputDecimation<num>=N" overrides OutputDecimation for UAV <num>
+    bool TextOutput = true;            // Write the UAV<num>.txt trajectory files
+    bool Recorder = false;             // Keep the last RecorderWindow seconds of every UAV in memory for dumps
+    double RecorderWindow = 10.0;      // Seconds of history kept per UAV by the recorder
+    double RecorderPostTrigger = 0.0;  // Seconds recorded after an anomaly before the trigger dump is written
+    double SeparationDistance = 0.0;   // Minimum allowed distance between two UAVs (0 = no separation monitoring)
+    double SeparationCheckInterval = 0.0; // Seconds between two separation checks (0 = every synchronization)
+    double RealTimeFactor = 0.0;       // Simulation seconds per wall-clock second (0 = as fast as possible)
+    double RealTimeSpin = 0.0002;      // Wall-clock seconds spent spinning (not sleeping) before each real-time deadline
+    double CommandPollInterval = 0.01; // Wall-clock seconds between two reads of an exhausted command stream
+    double CheckpointInterval = 0.0;   // Simulation seconds between two checkpoints in Checkpoint.bin (0 = none)
+    bool LoiterFastPath = false;       // Tick engine: move loitering UAVs by incremental rotation instead of cos/sin
+    int LoiterRenormalizeSteps = 64;   // Rotation steps between two exact re-synchronizations of the fast path
+    std::string FleetManifest;         // Per-UAV start state (CSV or binary); sets N_uav and overrides X0..R per UAV
+    int MotionModel = 0;               // 0 = planar model, 1 = 3D model with turn, climb and acceleration limits (tick engine)
+    double MaxClimbRate = 5.0;         // 3D model: largest altitude change in meters per second
+    double MaxAcceleration = 2.0;      // 3D model: largest speed change in meters per second squared
+    double LoiterRadiusFactor = 1.2;   // 3D model: loiter radius as a multiple of the minimum turning radius R
+    bool CompressedOutput = false;     // Also write all trajectories to the compressed UAVTrajectories.uavz
+    int CompressedBlockSamples = 1024; // Most samples of one UAV in a compressed block
+    double CompressedTimeResolution = 1e-6;     // Compressed output: seconds per time unit
+    double CompressedPositionResolution = 0.001; // Compressed output: meters per position unit
+    double CompressedAngleResolution = 0.0001;  // Compressed output: radians per azimuth unit
+    bool AsyncOutput = false;          // Format and write the trajectory files on a writer thread
+    int AsyncOutputBuffers = 2;        // Sample buffers between the engine and the writer thread (at least 2)
+    std::size_t AsyncOutputBufferBytes = 16777216; // Memory of one sample buffer
+    int AsyncOutputPolicy = 0;         // All buffers busy: 0 = the engine waits, 1 = the newest samples are dropped
+    int AssignmentExactLimit = 500;    // Target batches with at most this squared UAV-target pairs are assigned exactly (Hungarian)
+    int AssignmentCandidates = 32;     // Larger batches: nearest UAVs every target bids for in the auction
+    bool PrecisionValidation = false;  // Tick engine, planar model: run in double, step a float state alongside and report the largest position difference
+    double TrajectoryIndexInterval = 0.0; // Seconds between two entries of the UAV<num>.idx time indexes (0 = no index)
+    int ProfileTraceEvery = 100;       // Profiling builds: synchronizations between two traced in ProfileTrace.json (0 = none)
+};
+
+#endif // CONFIG_H
@@ -0,0 +1,508 @@
+#include "Manager.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+    // Commands buffered between the stream reader and the engine
+    const std::size_t commandStreamCapacity = 65536;
+
+    // Recorder dumped on demand by the dump signal (SIGUSR1, or Ctrl+Break on Windows)
+    TelemetryRecorder* signalRecorder = nullptr;
+
+    extern "C" void onDumpSignal(int) {
+        if (signalRecorder != nullptr) {
+            signalRecorder->requestDump();
+        }
+    }
+
+    // Restores the state of an engine from a checkpoint file.
+    template <typename Engine>
+    bool resumeEngine(Engine& engine, const std::string& checkpointFile, double& time) {
+        std::vector<char> data;
+        if (!Checkpointer::load(checkpointFile, time, data)) {
+            return false;
+        }
+        StateReader state(data.data(), data.size());
+        if (!engine.restoreState(state)) {
+            return false;
+        }
+        std::cout << "Resuming from " << checkpointFile << " at t=" << time << std::endl;
+        return true;
+    }
+
+    // Prints the profile (profiling builds) and writes it with the standby ticks of every UAV to
+    // ProfileReport.txt, and the sampled spans to ProfileTrace.json.
+    void writeProfile() {
+        if (!Profiler::enabled) {
+            return;
+        }
+        Profiler::writeReport(std::cout, false);
+        std::ofstream report("ProfileReport.txt", std::ios_base::trunc);
+        if (report.is_open()) {
+            Profiler::writeReport(report, true);
+        }
+        Profiler::writeTrace("ProfileTrace.json");
+    }
+}
+
+// Runs every variant of a sweep specification on top of the given configuration.
+// The statistics go to SweepSummary.csv.
+int runSweep(const std::string& specFile, Config config, const std::string& commandsFile) {
+    SweepSpec spec;
+    if (!readSweepSpec(specFile, spec)) {
+        return 1;
+    }
+    // A fleet manifest sets the fleet size of every run (each run reads it again)
+    if (!config.FleetManifest.empty()) {
+        for (const auto& parameter : spec.parameters) {
+            if (parameter.key == "N_uav") {
+                std::cerr << "Error: N_uav cannot be swept with a fleet manifest" << std::endl;
+                return 1;
+            }
+        }
+        UAVFleet fleet;
+        if (!initializeUAVs(config, fleet)) {
+            return 1;
+        }
+    }
+    // Every command file is read once and shared by all the runs using it
+    std::vector<std::string> commandFiles = spec.commandFiles;
+    if (commandFiles.empty()) {
+        commandFiles.push_back(commandsFile);
+    }
+    std::vector<std::vector<Command>> commandSets(commandFiles.size());
+    for (std::size_t i = 0; i < commandFiles.size(); ++i) {
+        if (!readCommandsFromFile(commandFiles[i], commandSets[i])) {
+            return 1;
+        }
+    }
+    SweepRunner runner(config, spec, commandSets);
+    return runner.run("SweepSummary.csv") ? 0 : 1;
+}
+
+// Decodes a compressed trajectory file into UAV<num>.txt files in the current directory.
+// The samples are quantized, so a value can round to a different last digit than during the run.
+int decompressTrajectories(const std::string& filename) {
+    CompressedTrajectoryReader reader;
+    if (!reader.open(filename)) {
+        return 1;
+    }
+    std::vector<std::string> filenames;
+    for (int num : reader.getNums()) {
+        filenames.push_back("UAV" + std::to_string(num) + ".txt");
+    }
+    TextTrajectoryWriter writer(65536, 0.0, reader.hasAltitude());
+    if (!writer.open(filenames)) {
+        return 1;
+    }
+    std::vector<TrajectorySample> samples;
+    for (std::size_t i = 0; i < reader.uavCount(); ++i) {
+        if (!reader.read(i, samples)) {
+            std::cerr << "Error: Corrupted trajectory of UAV" << reader.getNums()[i] << " in " << filename << std::endl;
+            return 1;
+        }
+        for (const TrajectorySample& sample : samples) {
+            writer.record(i, sample);
+        }
+    }
+    writer.close();
+    std::cout << "Decoded " << reader.uavCount() << " trajectories from " << filename << std::endl;
+    return 0;
+}
+
+// Parses "<a>:<b>" into two times. Returns false if the text is not of that form.
+bool parseTimeRange(const std::string& text, double& begin, double& end) {
+    std::istringstream input(text);
+    char separator = 0;
+    return static_cast<bool>(input >> begin >> separator >> end) && separator == ':' && input.peek() == EOF;
+}
+
+// Answers a query on a trajectory file through its time index and prints the result:
+// the sample at a time, the samples of a window, or the bounding boxes of an overview
+// ("[<begin>:<end>:]<buckets>", the whole trajectory by default).
+int queryTrajectory(const std::string& filename, const std::string& at, const std::string& window,
+                    const std::string& overview) {
+    TrajectoryIndex index;
+    if (!index.open(filename)) {
+        return 1;
+    }
+    auto printSample = [](const TrajectorySample& sample) {
+        std::printf("%.2f %.2f %.2f %.2f\n", sample.time, sample.x, sample.y, sample.azimuth);
+    };
+    if (!at.empty()) {
+        TrajectorySample sample;
+        if (index.sampleAt(std::atof(at.c_str()), sample)) {
+            printSample(sample);
+        }
+    }
+    if (!window.empty()) {
+        double begin = 0.0;
+        double end = 0.0;
+        if (!parseTimeRange(window, begin, end)) {
+            std::cerr << "Error: --window expects <begin>:<end>" << std::endl;
+            return 1;
+        }
+        std::vector<TrajectorySample> samples;
+        index.window(begin, end, samples);
+        for (const TrajectorySample& sample : samples) {
+            printSample(sample);
+        }
+    }
+    if (!overview.empty() && !index.getEntries().empty()) {
+        double begin = index.getEntries().front().time;
+        double end = index.getEntries().back().endTime;
+        std::string::size_type colon = overview.find_last_of(':');
+        if (colon != std::string::npos && !parseTimeRange(overview.substr(0, colon), begin, end)) {
+            std::cerr << "Error: --overview expects [<begin>:<end>:]<buckets>" << std::endl;
+            return 1;
+        }
+        long buckets = std::atol(overview.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+        std::vector<TrajectoryOverviewBucket> result;
+        index.overview(begin, end, static_cast<std::size_t>(std::max(buckets, 1L)), result);
+        for (const TrajectoryOverviewBucket& bucket : result) {
+            if (bucket.lines > 0) {
+                std::printf("%.2f %.2f %llu %.2f %.2f %.2f %.2f\n", bucket.begin, bucket.end,
+                            static_cast<unsigned long long>(bucket.lines), bucket.minX, bucket.maxX, bucket.minY, bucket.maxY);
+            }
+        }
+    }
+    return 0;
+}
+
+// Usage: DynamicUAVSimulation [--sweep <sweep file>] [--stream <commands stream>] [--resume <checkpoint>]
+//                             [--convert-commands <binary commands file>] [--decompress <trajectory file>]
+//                             [--query <trajectory file> [--at <t>] [--window <t1>:<t2>] [--overview [<t1>:<t2>:]<n>]]
+//                             [--index <trajectory file> [--index-interval <seconds>]]
+//                             [<params file> [<commands file>]]
+// The files default to SimParams.ini and SimCmds.txt in the current directory.
+// --convert-commands writes the commands as a pre-sorted binary command file and exits; the binary
+// file can then be given in place of SimCmds.txt.
+// --decompress writes UAV<num>.txt files from the (quantized) samples of a compressed trajectory
+// file and exits; they may differ from the text files of the run in the last digit.
+// --query answers time queries on a UAV<num>.txt file and exits; --index writes its UAV<num>.idx
+// time index (every second by default) and exits.
+// The commands stream (a file that keeps growing, or a FIFO) adds commands while the simulation runs.
+// Commands for UAV 0 (in the commands file or the stream) are targets given to the free UAVs.
+// A resumed run continues the checkpointed run with the same parameters and appends to its outputs.
+int main(int argc, char* argv[]) {
+    std::string sweepFile;
+    std::string streamFile;
+    std::string resumeFile;
+    std::string convertFile;
+    std::string decompressFile;
+    std::string queryFile;
+    std::string queryAt;
+    std::string queryWindow;
+    std::string queryOverview;
+    std::string indexFile;
+    double indexInterval = 1.0;
+    while (argc > 2 && std::string(argv[1]).compare(0, 2, "--") == 0) {
+        const std::string option = argv[1];
+        if (option == "--sweep") {
+            sweepFile = argv[2];
+        }
+        else if (option == "--stream") {
+            streamFile = argv[2];
+        }
+        else if (option == "--resume") {
+            resumeFile = argv[2];
+        }
+        else if (option == "--convert-commands") {
+            convertFile = argv[2];
+        }
+        else if (option == "--decompress") {
+            decompressFile = argv[2];
+        }
+        else if (option == "--query") {
+            queryFile = argv[2];
+        }
+        else if (option == "--at") {
+            queryAt = argv[2];
+        }
+        else if (option == "--window") {
+            queryWindow = argv[2];
+        }
+        else if (option == "--overview") {
+            queryOverview = argv[2];
+        }
+        else if (option == "--index") {
+            indexFile = argv[2];
+        }
+        else if (option == "--index-interval") {
+            indexInterval = std::atof(argv[2]);
+        }
+        else {
+            std::cerr << "Error: Unknown option " << option << std::endl;
+            return 1;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (!decompressFile.empty()) {
+        return decompressTrajectories(decompressFile);
+    }
+    if (!indexFile.empty()) {
+        return TrajectoryIndex::writeIndexFile(indexFile, indexInterval) ? 0 : 1;
+    }
+    if (!queryFile.empty()) {
+        return queryTrajectory(queryFile, queryAt, queryWindow, queryOverview);
+    }
+    const std::string paramsFile = argc > 1 ? argv[1] : "SimParams.ini";
+    const std::string commandsFile = argc > 2 ? argv[2] : "SimCmds.txt";
+
+    Config config; // Create a configuration object
+    std::vector<Command> commands; // Vector to store commands
+    UAVFleet fleet; // Storage of all UAVs
+
+    //Reads SimParams file
+    if (!readConfigFromFile(paramsFile, config)) {
+        return 1;
+    }
+    if (!sweepFile.empty()) {
+        Profiler::configure(0, config.ProfileTraceEvery);
+        int status = runSweep(sweepFile, config, commandsFile);
+        writeProfile();
+        return status;
+    }
+    //Reads SimCmds file
+    if (!readCommandsFromFile(commandsFile, commands)) {
+        return 1;
+    }
+    if (!convertFile.empty()) {
+        return writeCommandFile(convertFile, commands) ? 0 : 1;
+    }
+
+    if (!initializeUAVs(config, fleet)) {
+        return 1;
+    }
+    printConfiguration(config);
+    printCommands(commands);
+
+    // Bucket the commands per UAV and sort them by time
+    CommandScheduler scheduler(commands, config.N_uav);
+
+    // Commands addressed to UAV 0 are targets, assigned to the free UAVs while the simulation runs.
+    // Targets may also arrive through the command stream.
+    std::vector<Command> targets;
+    for (const Command& command : commands) {
+        if (command.num == 0) {
+            targets.push_back(command);
+        }
+    }
+    std::unique_ptr<TargetDispatcher> targetDispatcher;
+    if (!targets.empty() || !streamFile.empty()) {
+        targetDispatcher.reset(new TargetDispatcher(targets,
+            static_cast<std::size_t>(std::max(config.AssignmentExactLimit, 0)),
+            static_cast<std::size_t>(std::max(config.AssignmentCandidates, 1))));
+    }
+
+    printUAVDetails(fleet);
+    Profiler::configure(fleet.size(), config.ProfileTraceEvery);
+
+    // Create (or truncate) the output files before the main simulation loop starts.
+    // The files stay open for the whole run. A resumed run keeps the existing files.
+    const bool resuming = !resumeFile.empty();
+    std::vector<TrajectorySink*> outputs;
+    TextTrajectoryWriter trajectoryWriter(config.OutputBufferBytes, config.OutputFlushInterval, config.MotionModel == 1,
+                                          config.TrajectoryIndexInterval);
+    if (config.TextOutput) {
+        std::vector<std::string> filenames;
+        for (int i = 0; i < config.N_uav; ++i) {
+            filenames.push_back("UAV" + std::to_string(fleet.num[i]) + ".txt");
+        }
+        if (!trajectoryWriter.open(filenames, resuming)) {
+            return 1;
+        }
+        outputs.push_back(&trajectoryWriter);
+    }
+
+    // Optional binary output, preallocated for the whole run
+    // The closed-form propagation only covers the planar model
+    bool eventDriven = config.Engine == 1 && config.MotionModel == 0;
+    if (config.Engine == 1 && !eventDriven) {
+        std::cerr << "Warning: MotionModel=1 needs the tick engine, Engine=1 is ignored" << std::endl;
+    }
+    if (config.PrecisionValidation && (eventDriven || config.MotionModel == 1)) {
+        std::cerr << "Warning: PrecisionValidation needs the tick engine and the planar model, it is ignored" << std::endl;
+    }
+    double recordInterval = config.OutputInterval > 0.0 ? config.OutputInterval : config.Dt;
+    BinaryTrajectoryWriter binaryWriter(config.BinaryPrecision);
+    if (config.BinaryOutput) {
+        std::size_t capacity = BinaryTrajectoryWriter::recordsForDuration(config.TimeLim, recordInterval);
+        if (!binaryWriter.open("UAVTrajectories.bin", config.N_uav, recordInterval, capacity, resuming)) {
+            return 1;
+        }
+        outputs.push_back(&binaryWriter);
+    }
+
+    // Optional compressed output of all trajectories
+    TrajectoryResolution resolution;
+    resolution.time = config.CompressedTimeResolution;
+    resolution.position = config.CompressedPositionResolution;
+    resolution.angle = config.CompressedAngleResolution;
+    CompressedTrajectoryWriter compressedWriter(static_cast<std::size_t>(std::max(config.CompressedBlockSamples, 1)),
+        resolution, config.MotionModel == 1);
+    if (config.CompressedOutput) {
+        std::vector<int> nums(fleet.num.begin(), fleet.num.end());
+        if (!compressedWriter.open("UAVTrajectories.uavz", nums, resuming)) {
+            return 1;
+        }
+        outputs.push_back(&compressedWriter);
+    }
+
+    // Optional writer thread: the engine threads only copy the samples into buffers, the files are
+    // formatted and written in the background
+    std::unique_ptr<AsyncTrajectoryWriter> asyncWriter;
+    if (config.AsyncOutput && !outputs.empty()) {
+        std::size_t samplesPerSync = config.TicksPerSync > 0 ? static_cast<std::size_t>(config.TicksPerSync) : 1;
+        AsyncTrajectoryWriter::BackpressurePolicy policy = config.AsyncOutputPolicy == 1 ?
+            AsyncTrajectoryWriter::DropSamples : AsyncTrajectoryWriter::WaitForBuffer;
+        asyncWriter.reset(new AsyncTrajectoryWriter(outputs, fleet.size(), samplesPerSync,
+            config.AsyncOutputBufferBytes, config.AsyncOutputBuffers, policy));
+        outputs = { asyncWriter.get() };
+    }
+
+    // Output sampling: the tick engine steps every Dt but only every OutputInterval is written,
+    // and decimated UAVs keep only every N-th output sample
+    std::vector<int> decimations(config.N_uav, config.OutputDecimation);
+    for (const auto& decimation : config.OutputDecimationPerUAV) {
+        if (decimation.first >= 1 && decimation.first <= config.N_uav) {
+            decimations[decimation.first - 1] = decimation.second;
+        }
+    }
+    bool decimated = std::any_of(decimations.begin(), decimations.end(), [](int n) { return n > 1; });
+    OutputSampler sampler(outputs, recordInterval, decimations);
+    std::vector<TrajectorySink*> sinks = outputs;
+    if ((!eventDriven && config.OutputInterval > 0.0) || decimated) {
+        sinks = { &sampler };
+    }
+
+    // Optional in-memory recorder of the last RecorderWindow seconds, fed with every step
+    std::unique_ptr<TelemetryRecorder> recorder;
+    if (config.Recorder) {
+        double stepInterval = eventDriven ? recordInterval : config.Dt;
+        std::vector<int> nums(fleet.num.begin(), fleet.num.end());
+        recorder.reset(new TelemetryRecorder(nums, TelemetryRecorder::capacityFor(config.RecorderWindow, stepInterval),
+            config.RecorderPostTrigger));
+        sinks.push_back(recorder.get());
+        signalRecorder = recorder.get();
+#if defined(SIGUSR1)
+        std::signal(SIGUSR1, onDumpSignal);
+#elif defined(SIGBREAK)
+        std::signal(SIGBREAK, onDumpSignal);
+#endif
+    }
+
+    // Optional separation monitoring, which also triggers recorder dumps
+    std::unique_ptr<SeparationMonitor> separationMonitor;
+    if (config.SeparationDistance > 0.0) {
+        std::vector<int> nums(fleet.num.begin(), fleet.num.end());
+        separationMonitor.reset(new SeparationMonitor(nums, config.SeparationDistance, config.SeparationCheckInterval));
+        if (!separationMonitor->open("SeparationEvents.txt", resuming)) {
+            return 1;
+        }
+        separationMonitor->setRecorder(recorder.get());
+        sinks.push_back(separationMonitor.get());
+    }
+
+    // Optional commands received while the simulation runs
+    std::unique_ptr<CommandStream> commandStream;
+    if (!streamFile.empty()) {
+        commandStream.reset(new CommandStream(commandStreamCapacity, config.CommandPollInterval));
+        if (!commandStream->open(streamFile)) {
+            return 1;
+        }
+    }
+
+    // Optional periodic checkpoints, written in the background
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (config.CheckpointInterval > 0.0) {
+        checkpointer.reset(new Checkpointer("Checkpoint.bin", config.CheckpointInterval));
+    }
+
+    // Main simulation loop
+    double endTime = 0.0;
+    double resumeTime = 0.0;
+    if (eventDriven) {
+        EventEngine engine(config, fleet, scheduler, sinks);
+        engine.setTargetDispatcher(targetDispatcher.get());
+        if (resuming && !resumeEngine(engine, resumeFile, resumeTime)) {
+            return 1;
+        }
+        engine.setCommandStream(commandStream.get());
+        engine.setCheckpointer(checkpointer.get());
+        if (checkpointer) {
+            checkpointer->startAt(resumeTime);
+        }
+        engine.run();
+        endTime = engine.getCurrentTime();
+        engine.getPacer().printStatistics();
+    }
+    else {
+        TickEngine engine(config, fleet, scheduler, sinks);
+        engine.setTargetDispatcher(targetDispatcher.get());
+        if (resuming && !resumeEngine(engine, resumeFile, resumeTime)) {
+            return 1;
+        }
+        engine.setCommandStream(commandStream.get());
+        engine.setCheckpointer(checkpointer.get());
+        if (checkpointer) {
+            checkpointer->startAt(resumeTime);
+        }
+        engine.run();
+        endTime = engine.getCurrentTime();
+        engine.getPacer().printStatistics();
+        if (config.PrecisionValidation && config.MotionModel != 1) {
+            std::size_t index = 0;
+            double time = 0.0;
+            double divergence = engine.getPrecisionDivergence(index, time);
+            std::cout << "Precision validation: largest position difference between float and double "
+                << std::fixed << std::setprecision(6) << divergence << " m";
+            if (divergence > 0.0) {
+                std::cout << " (UAV " << fleet.num[index] << " at t=" << std::setprecision(3) << time << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    if (checkpointer) {
+        checkpointer->finish();
+        std::cout << "Checkpoints written: " << checkpointer->getWrittenCount() << std::endl;
+    }
+
+    if (commandStream) {
+        commandStream->close();
+        std::cout << "Streamed commands: " << commandStream->getReceivedCount()
+            << " (" << commandStream->getIgnoredCount() << " ignored)" << std::endl;
+    }
+
+    if (targetDispatcher) {
+        std::cout << "Assigned targets: " << targetDispatcher->getAssignedCount() << " of "
+            << targetDispatcher->getTargetCount() << " (" << targetDispatcher->getWaitingCount() << " waiting), "
+            << "predicted time to target " << std::fixed << std::setprecision(2) << targetDispatcher->getTotalCost()
+            << " s in total" << std::endl;
+    }
+
+    if (separationMonitor) {
+        separationMonitor->close(endTime);
+        std::cout << "Separation events: " << separationMonitor->getEventCount() << std::endl;
+    }
+    if (recorder) {
+        signalRecorder = nullptr;
+        recorder->dump(TelemetryRecorder::DumpAtEnd, endTime);
+    }
+
+    // Write whatever is still buffered and close the output files
+    if (asyncWriter) {
+        asyncWriter->close();
+    }
+    trajectoryWriter.close();
+    binaryWriter.close();
+    compressedWriter.close();
+
+    writeProfile();
+    return 0;
+}
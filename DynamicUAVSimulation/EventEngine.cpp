@@ -0,0 +1,251 @@
+#include "EventEngine.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include "Profiler.h"
+#include "TickEngine.h"
+
+namespace {
+    const double pi = 3.14159265358979323846;
+
+    // Brings an angle into [0, 2 * pi), like UAV::standbyMode does
+    double wrapAngle(double angle) {
+        angle = std::fmod(angle, 2 * pi);
+        if (angle < 0) {
+            angle += 2 * pi;
+        }
+        return angle;
+    }
+}
+
+// Constructor - every UAV starts cruising from its initial state
+EventEngine::EventEngine(const Config& config, UAVFleet& fleet, CommandScheduler& scheduler, const std::vector<TrajectorySink*>& sinks)
+    : config(config), fleet(fleet), scheduler(scheduler), sinks(sinks),
+      segments(fleet.size()), cursors(fleet.size(), 0), pacer(config.RealTimeFactor, config.RealTimeSpin),
+      pool(TickEngine::threadCountFor(config.Threads, fleet.size())) {
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        Segment& segment = segments[i];
+        segment.startTime = 0.0;
+        segment.startX = fleet.x[i];
+        segment.startY = fleet.y[i];
+        segment.heading = fleet.azimuth[i];
+        segment.loiterTime = std::numeric_limits<double>::infinity();
+        segment.loiterAz = 0.0;
+        segment.destX = 0.0;
+        segment.destY = 0.0;
+    }
+}
+
+// Returns the time a UAV needs to reach the loiter circle of a destination.
+double EventEngine::timeToLoiter(double distance, double v, double r) {
+    if (v <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    // From inside the circle the UAV flies through the destination to the far side of the circle
+    return distance >= r ? (distance - r) / v : (distance + r) / v;
+}
+
+// Runs the simulation until the time limit.
+void EventEngine::run() {
+    const double interval = config.OutputInterval > 0.0 ? config.OutputInterval : config.Dt;
+    const std::size_t samplesPerSync = config.TicksPerSync > 0 ? static_cast<std::size_t>(config.TicksPerSync) : 1;
+    std::vector<double> sampleTimes;
+    sampleTimes.reserve(samplesPerSync);
+
+    // Output times are computed from their index, so they do not accumulate rounding errors
+    double sampleTime = static_cast<double>(sampleCount) * interval;
+    pacer.start(currentTime);
+    while (sampleTime <= config.TimeLim) {
+        UAVSIM_PROFILE_SYNC();
+        UAVSIM_PROFILE_SCOPE(PhaseTick);
+
+        // Soft real time: wait for the wall clock, then pick up the commands received meanwhile.
+        // A late command starts its segment at the last sampled time.
+        {
+            UAVSIM_PROFILE_SCOPE(PhasePacing);
+            pacer.waitUntil(sampleTime);
+        }
+        if (commandStream != nullptr) {
+            UAVSIM_PROFILE_SCOPE(PhaseCommands);
+            commandStream->drainInto(scheduler, currentTime, targetDispatcher);
+        }
+        if (targetDispatcher != nullptr) {
+            UAVSIM_PROFILE_SCOPE(PhaseAssignment);
+            targetDispatcher->dispatch(fleet, scheduler, currentTime);
+        }
+
+        sampleTimes.clear();
+        while (sampleTimes.size() < samplesPerSync && sampleTime <= config.TimeLim) {
+            sampleTimes.push_back(sampleTime);
+            sampleTime = static_cast<double>(++sampleCount) * interval;
+        }
+
+        pool.parallelFor(fleet.size(), [this, &sampleTimes](std::size_t begin, std::size_t end) {
+            sampleRange(begin, end, sampleTimes);
+            });
+        currentTime = sampleTimes.back();
+
+        {
+            UAVSIM_PROFILE_SCOPE(PhaseSynchronize);
+            for (TrajectorySink* sink : sinks) {
+                sink->synchronize(currentTime);
+            }
+        }
+
+        // The state goes to memory here; the checkpoint writer puts it on disk in the background
+        if (checkpointer != nullptr && checkpointer->isDue(currentTime)) {
+            UAVSIM_PROFILE_SCOPE(PhaseCheckpoint);
+            saveState(checkpointState);
+            checkpointer->submit(currentTime, checkpointState);
+        }
+    }
+
+    pacer.finish(sampleTime);
+
+    UAVSIM_PROFILE_SCOPE(PhaseFlush);
+    for (TrajectorySink* sink : sinks) {
+        sink->flush();
+    }
+}
+
+// Saves the complete simulation state.
+void EventEngine::saveState(StateWriter& state) const {
+    // Parameters the state depends on, checked when it is restored
+    state.write<std::uint32_t>(1);
+    state.write<std::uint64_t>(fleet.size());
+    state.write(config.Dt);
+    state.write(config.OutputInterval);
+    state.write<std::uint64_t>(sinks.size());
+
+    state.write(currentTime);
+    state.write(sampleCount);
+    state.writeVector(segments);
+    state.writeVector(cursors);
+    fleet.saveState(state);
+    scheduler.saveState(state);
+    state.write<std::uint8_t>(targetDispatcher != nullptr ? 1 : 0);
+    if (targetDispatcher != nullptr) {
+        targetDispatcher->saveState(state);
+    }
+    for (const TrajectorySink* sink : sinks) {
+        sink->saveState(state);
+    }
+}
+
+// Restores a state saved by saveState() with the same parameters.
+bool EventEngine::restoreState(StateReader& state) {
+    std::uint32_t kind = 0;
+    std::uint64_t fleetSize = 0;
+    std::uint64_t sinkCount = 0;
+    double dt = 0.0;
+    double outputInterval = 0.0;
+    state.read(kind);
+    state.read(fleetSize);
+    state.read(dt);
+    state.read(outputInterval);
+    state.read(sinkCount);
+    if (!state.ok() || kind != 1 || fleetSize != fleet.size() || dt != config.Dt ||
+        outputInterval != config.OutputInterval || sinkCount != sinks.size()) {
+        std::cerr << "Error: The checkpoint does not match the simulation parameters" << std::endl;
+        return false;
+    }
+
+    state.read(currentTime);
+    state.read(sampleCount);
+    state.readVector(segments);
+    state.readVector(cursors);
+    if (!fleet.restoreState(state) || !scheduler.restoreState(state)) {
+        std::cerr << "Error: The checkpoint is damaged" << std::endl;
+        return false;
+    }
+    std::uint8_t hasTargets = 0;
+    state.read(hasTargets);
+    if ((hasTargets != 0) != (targetDispatcher != nullptr)) {
+        std::cerr << "Error: The checkpoint does not match the simulation parameters" << std::endl;
+        return false;
+    }
+    if (targetDispatcher != nullptr && !targetDispatcher->restoreState(state)) {
+        std::cerr << "Error: The checkpoint is damaged" << std::endl;
+        return false;
+    }
+    for (TrajectorySink* sink : sinks) {
+        if (!sink->restoreState(state)) {
+            std::cerr << "Error: The outputs cannot be resumed from the checkpoint" << std::endl;
+            return false;
+        }
+    }
+    return state.ok();
+}
+
+// Starts a transit towards a destination at the given time.
+void EventEngine::startTransit(std::size_t index, double time, double destX, double destY) {
+    Segment& segment = segments[index];
+    double deltaX = destX - fleet.x[index];
+    double deltaY = destY - fleet.y[index];
+    double distanceToDest = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+    double azimuthToDest = std::atan2(deltaY, deltaX);
+
+    segment.startTime = time;
+    segment.startX = fleet.x[index];
+    segment.startY = fleet.y[index];
+    segment.heading = azimuthToDest;
+    segment.loiterTime = time + timeToLoiter(distanceToDest, fleet.v[index], fleet.r[index]);
+    // The loiter angle points from the UAV to the center: the arrival heading, reversed when
+    // the UAV reaches the circle on the far side of the destination
+    segment.loiterAz = distanceToDest >= fleet.r[index] ? azimuthToDest : wrapAngle(azimuthToDest + pi);
+    segment.destX = destX;
+    segment.destY = destY;
+}
+
+// Evaluates the segment of a UAV and stores the state in the fleet.
+void EventEngine::evaluate(std::size_t index, double time) {
+    const Segment& segment = segments[index];
+    double v = fleet.v[index];
+    double r = fleet.r[index];
+
+    if (time < segment.loiterTime) {
+        // Straight flight
+        double duration = time - segment.startTime;
+        fleet.x[index] = segment.startX + v * std::cos(segment.heading) * duration;
+        fleet.y[index] = segment.startY + v * std::sin(segment.heading) * duration;
+        fleet.azimuth[index] = segment.heading;
+        fleet.standbyModeFlag[index] = 0;
+    }
+    else {
+        // Clockwise circle around the destination
+        double azimuth = wrapAngle(segment.loiterAz - v / r * (time - segment.loiterTime));
+        fleet.x[index] = segment.destX - r * std::cos(azimuth);
+        fleet.y[index] = segment.destY - r * std::sin(azimuth);
+        fleet.azimuth[index] = azimuth;
+        fleet.standbyModeFlag[index] = 1;
+    }
+}
+
+// Samples the UAVs in [begin, end) at the given times.
+void EventEngine::sampleRange(std::size_t begin, std::size_t end, const std::vector<double>& sampleTimes) {
+    UAVSIM_PROFILE_SCOPE(PhaseEvaluate);
+    for (double sampleTime : sampleTimes) {
+        for (std::size_t i = begin; i < end; ++i) {
+            // Start a new segment at the time of every command issued since the last sample
+            const std::vector<Command>& commands = scheduler.commandsOf(i);
+            std::size_t& cursor = cursors[i];
+            while (cursor < commands.size() && commands[cursor].time < sampleTime) {
+                const Command& command = commands[cursor];
+                evaluate(i, command.time);
+                startTransit(i, command.time, command.x, command.y);
+                fleet.cruising[i] = 0;
+                UAVSIM_PROFILE_COUNT(CommandActivations);
+                ++cursor;
+            }
+
+            evaluate(i, sampleTime);
+            TrajectorySample sample = sampleOf(fleet, i, sampleTime);
+            for (TrajectorySink* sink : sinks) {
+                sink->record(i, sample);
+            }
+        }
+        UAVSIM_PROFILE_STANDBY(fleet.standbyModeFlag.data(), begin, end);
+        UAVSIM_PROFILE_COUNT_FLAGS(CruiseUpdates, fleet.cruising.data(), begin, end);
+    }
+}
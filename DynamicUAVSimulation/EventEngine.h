@@ -0,0 +1,130 @@
+#pragma once
+#ifndef EVENTENGINE_H
+#define EVENTENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Checkpoint.h"
+#include "CommandScheduler.h"
+#include "CommandStream.h"
+#include "Config.h"
+#include "Pacer.h"
+#include "TargetDispatcher.h"
+#include "ThreadPool.h"
+#include "TrajectorySink.h"
+#include "UAVFleet.h"
+
+// Event-driven simulation.
+// The motion model is piecewise analytic, so instead of integrating every Dt the engine keeps one
+// closed-form segment per UAV and only evaluates it at the requested output times:
+//  - cruise:  straight flight along the initial azimuth until the first command,
+//  - transit: straight flight towards the destination until the UAV is at distance R from it
+//             (through the destination first when the command starts inside the circle),
+//  - loiter:  clockwise circle of radius R around the destination at angular speed V/R.
+// A new segment starts exactly at the time of each command, from the position the previous
+// segment reaches at that time.
+class EventEngine {
+public:
+    /**
+    * @param config The simulation parameters (TimeLim, OutputInterval, Threads, TicksPerSync, RealTimeFactor, RealTimeSpin).
+    * @param fleet The fleet to simulate. Its state is updated at every output time.
+    * @param scheduler The commands of the fleet.
+    * @param sinks The trajectory outputs. record() is called concurrently for different UAVs.
+    */
+    EventEngine(const Config& config, UAVFleet& fleet, CommandScheduler& scheduler, const std::vector<TrajectorySink*>& sinks);
+
+    /**
+    * Runs the simulation until the time limit.
+    */
+    void run();
+
+    /**
+    * Sets the source of the commands received while the simulation runs.
+    * The stream is drained into the scheduler at every synchronization point.
+    *
+    * @param stream The command stream, or nullptr for none.
+    */
+    void setCommandStream(CommandStream* stream) { commandStream = stream; }
+
+    /**
+    * Sets the dispatcher of the targets (commands addressed to UAV 0).
+    * It assigns the released targets to the free UAVs at every synchronization point.
+    * Must be set before restoreState(), since its targets are part of the state.
+    *
+    * @param dispatcher The target dispatcher, or nullptr for none.
+    */
+    void setTargetDispatcher(TargetDispatcher* dispatcher) { targetDispatcher = dispatcher; }
+
+    /**
+    * Sets the writer of the periodic checkpoints (CheckpointInterval).
+    *
+    * @param writer The checkpoint writer, or nullptr for none.
+    */
+    void setCheckpointer(Checkpointer* writer) { checkpointer = writer; }
+
+    /**
+    * Saves the complete simulation state: engine, fleet, commands and trajectory outputs.
+    * Only valid between two runs of the loop, e.g. from a synchronization point.
+    */
+    void saveState(StateWriter& state) const;
+
+    /**
+    * Restores a state saved by saveState() with the same parameters; run() then continues from it.
+    *
+    * @return True if the state was restored, false if it does not match the simulation.
+    */
+    bool restoreState(StateReader& state);
+
+    double getCurrentTime() const { return currentTime; }
+    const Pacer& getPacer() const { return pacer; }
+    std::size_t getThreadCount() const { return pool.size(); }
+
+    /**
+    * Returns the time a UAV needs to reach the loiter circle of a destination.
+    *
+    * @param distance The distance between the UAV and the destination.
+    * @param v The UAV velocity.
+    * @param r The loiter radius.
+    */
+    static double timeToLoiter(double distance, double v, double r);
+
+private:
+    // Closed-form motion of one UAV
+    struct Segment {
+        double startTime;   // Time the straight part starts
+        double startX;      // Position at startTime
+        double startY;
+        double heading;     // Direction of the straight part
+        double loiterTime;  // Time the loiter starts (infinity while cruising)
+        double loiterAz;    // Loiter angle at loiterTime
+        double destX;       // Loiter center
+        double destY;
+    };
+
+    // Starts a transit towards a destination at the given time.
+    void startTransit(std::size_t index, double time, double destX, double destY);
+
+    // Evaluates the segment of a UAV and stores the state in the fleet.
+    void evaluate(std::size_t index, double time);
+
+    // Samples the UAVs in [begin, end) at the given times.
+    void sampleRange(std::size_t begin, std::size_t end, const std::vector<double>& sampleTimes);
+
+    const Config& config;
+    UAVFleet& fleet;
+    CommandScheduler& scheduler;
+    std::vector<TrajectorySink*> sinks;
+    std::vector<Segment> segments;
+    std::vector<std::size_t> cursors; // Number of commands already applied to every UAV
+    CommandStream* commandStream = nullptr;
+    TargetDispatcher* targetDispatcher = nullptr;
+    Checkpointer* checkpointer = nullptr;
+    StateWriter checkpointState; // Reused buffer of the checkpoints
+    Pacer pacer; // Soft real time (RealTimeFactor)
+    double currentTime = 0.0;
+    std::uint64_t sampleCount = 0; // Output samples taken so far
+    ThreadPool pool;
+};
+
+#endif // EVENTENGINE_H
@@ -0,0 +1,279 @@
+#include "FleetManifest.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+#include "Manager.h"
+#include "MappedFile.h"
+
+namespace {
+    // Binary manifest layout: header, then the columns
+    struct ManifestHeader {
+        char magic[8];           // "UAVFLEET" (no terminating NUL)
+        std::uint32_t version;   // Format version
+        std::uint32_t byteOrder; // 0x01020304 written in the native byte order
+        std::uint64_t count;     // Number of UAVs
+    };
+
+    const std::uint32_t manifestVersion = 1;
+    const std::uint32_t byteOrderMark = 0x01020304;
+
+    // Manifest columns, in the order of the binary format
+    const std::size_t columnCount = 6;
+    const char* const columnNames[columnCount] = { "X0", "Y0", "Z0", "V0", "Az", "R" };
+    const std::size_t speedColumn = 3;
+    const std::size_t radiusColumn = 5;
+
+    void fleetColumns(UAVFleet& fleet, AlignedVector<double>* (&columns)[columnCount]) {
+        AlignedVector<double>* all[columnCount] = { &fleet.x, &fleet.y, &fleet.z, &fleet.v, &fleet.azimuth, &fleet.r };
+        std::copy(all, all + columnCount, columns);
+    }
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && isBlank(text.front())) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && isBlank(text.back())) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // Returns the line starting at position, without its line break, and moves position past it.
+    std::string_view nextLine(const char*& position, const char* end) {
+        const char* newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        std::string_view line(position, static_cast<std::size_t>(lineEnd - position));
+        position = newline != nullptr ? newline + 1 : end;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    bool isSkipped(std::string_view line) {
+        line = trim(line);
+        return line.empty() || line.front() == '#';
+    }
+
+    // Maps every field of the header row to a manifest column.
+    bool parseHeader(std::string_view line, std::vector<std::size_t>& fieldColumns, const std::string& filename) {
+        bool used[columnCount] = {};
+        while (true) {
+            std::size_t comma = line.find(',');
+            std::string_view name = trim(line.substr(0, comma));
+            const char* const* found = std::find(columnNames, columnNames + columnCount, name);
+            std::size_t column = static_cast<std::size_t>(found - columnNames);
+            if (column == columnCount || used[column]) {
+                std::cerr << "Error: " << (column == columnCount ? "Unknown" : "Duplicate") << " column \""
+                    << name << "\" in fleet manifest " << filename << std::endl;
+                return false;
+            }
+            used[column] = true;
+            fieldColumns.push_back(column);
+            if (comma == std::string_view::npos) {
+                return true;
+            }
+            line.remove_prefix(comma + 1);
+        }
+    }
+
+    // Parses one row into the given fleet index.
+    bool parseRow(std::string_view line, const std::vector<std::size_t>& fieldColumns,
+                  AlignedVector<double>* (&columns)[columnCount], std::size_t row) {
+        const char* position = line.data();
+        const char* end = position + line.size();
+        std::size_t field = 0;
+        while (true) {
+            while (position != end && isBlank(*position)) {
+                ++position;
+            }
+            if (field == fieldColumns.size()) {
+                return false;
+            }
+            double value = 0.0;
+            std::from_chars_result result = std::from_chars(position, end, value);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            (*columns[fieldColumns[field]])[row] = value;
+            ++field;
+            position = result.ptr;
+            while (position != end && isBlank(*position)) {
+                ++position;
+            }
+            if (position == end) {
+                return field == fieldColumns.size();
+            }
+            if (*position != ',') {
+                return false;
+            }
+            ++position;
+        }
+    }
+
+    bool hasColumn(const std::vector<std::size_t>& fieldColumns, std::size_t column) {
+        return std::find(fieldColumns.begin(), fieldColumns.end(), column) != fieldColumns.end();
+    }
+
+    // Returns the name of the first of V0 and R that is not positive (both divide the loiter
+    // computations), or nullptr if both are valid.
+    const char* invalidEnvelope(double v, double r) {
+        if (!(v > 0.0)) {
+            return "V0";
+        }
+        if (!(r > 0.0)) {
+            return "R";
+        }
+        return nullptr;
+    }
+
+    bool loadCsvManifest(const MappedFile& file, const std::string& filename, const Config& config, UAVFleet& fleet) {
+        const char* position = file.data();
+        const char* end = position + file.size();
+
+        // Every line but the header may be a row: size the fleet once and shrink it at the end
+        std::size_t lines = static_cast<std::size_t>(std::count(position, end, '\n')) + 1;
+        fleet = UAVFleet(lines);
+        AlignedVector<double>* columns[columnCount];
+        fleetColumns(fleet, columns);
+
+        std::vector<std::size_t> fieldColumns;
+        std::size_t rows = 0;
+        std::size_t lineNumber = 0;
+        while (position != end) {
+            std::string_view line = nextLine(position, end);
+            ++lineNumber;
+            if (isSkipped(line)) {
+                continue;
+            }
+            if (fieldColumns.empty()) {
+                if (!parseHeader(line, fieldColumns, filename)) {
+                    return false;
+                }
+                continue;
+            }
+            if (!parseRow(line, fieldColumns, columns, rows)) {
+                std::cerr << "Error: Invalid row at line " << lineNumber << " of fleet manifest " << filename << std::endl;
+                return false;
+            }
+            // Columns left out of the manifest are checked with their SimParams.ini value
+            const char* invalid = invalidEnvelope(hasColumn(fieldColumns, speedColumn) ? fleet.v[rows] : config.V0,
+                                                  hasColumn(fieldColumns, radiusColumn) ? fleet.r[rows] : config.R);
+            if (invalid != nullptr) {
+                std::cerr << "Error: " << invalid << " must be positive at line " << lineNumber << " of fleet manifest "
+                    << filename << std::endl;
+                return false;
+            }
+            ++rows;
+        }
+        if (fieldColumns.empty()) {
+            std::cerr << "Error: Fleet manifest " << filename << " has no header row" << std::endl;
+            return false;
+        }
+        if (rows == 0) {
+            std::cerr << "Error: Fleet manifest " << filename << " has no UAV rows" << std::endl;
+            return false;
+        }
+        fleet.resize(rows);
+
+        // Columns left out of the manifest take the SimParams.ini values
+        const double defaults[columnCount] = { config.X0, config.Y0, config.Z0, config.V0, config.Az, config.R };
+        for (std::size_t column = 0; column < columnCount; ++column) {
+            if (!hasColumn(fieldColumns, column)) {
+                std::fill(columns[column]->begin(), columns[column]->end(), defaults[column]);
+            }
+        }
+        return true;
+    }
+
+    bool loadBinaryManifest(const MappedFile& file, const std::string& filename, UAVFleet& fleet) {
+        ManifestHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.version != manifestVersion || header.byteOrder != byteOrderMark) {
+            std::cerr << "Error: Fleet manifest " << filename << " was written by an incompatible build" << std::endl;
+            return false;
+        }
+        std::size_t available = (file.size() - sizeof(header)) / (columnCount * sizeof(double));
+        if (header.count > available) {
+            std::cerr << "Error: Fleet manifest " << filename << " is truncated" << std::endl;
+            return false;
+        }
+
+        if (header.count == 0) {
+            std::cerr << "Error: Fleet manifest " << filename << " has no UAVs" << std::endl;
+            return false;
+        }
+
+        std::size_t count = static_cast<std::size_t>(header.count);
+        fleet = UAVFleet(count);
+        AlignedVector<double>* columns[columnCount];
+        fleetColumns(fleet, columns);
+        const char* data = file.data() + sizeof(header);
+        for (std::size_t column = 0; column < columnCount; ++column) {
+            if (count > 0) {
+                std::memcpy(columns[column]->data(), data, count * sizeof(double));
+            }
+            data += count * sizeof(double);
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const char* invalid = invalidEnvelope(fleet.v[i], fleet.r[i]);
+            if (invalid != nullptr) {
+                std::cerr << "Error: " << invalid << " must be positive for UAV " << (i + 1) << " of fleet manifest "
+                    << filename << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// Loads a fleet manifest (CSV or binary, recognized by its content) into the fleet storage.
+bool loadFleetManifest(const std::string& filename, const Config& config, UAVFleet& fleet) {
+    MappedFile file;
+    if (!file.openReadOnly(resolveInputPath(filename).string())) {
+        std::cerr << "Error: Unable to open fleet manifest " << filename << std::endl;
+        return false;
+    }
+    bool binary = file.size() >= sizeof(ManifestHeader) && std::memcmp(file.data(), "UAVFLEET", 8) == 0;
+    bool ok = binary ? loadBinaryManifest(file, filename, fleet) : loadCsvManifest(file, filename, config, fleet);
+    if (!ok) {
+        return false;
+    }
+    std::iota(fleet.num.begin(), fleet.num.end(), 1);
+    return true;
+}
+
+// Writes the start state of a fleet as a binary manifest.
+bool writeFleetManifest(const std::string& filename, const UAVFleet& fleet) {
+    std::ofstream file(filename, std::ios_base::binary | std::ios_base::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+    ManifestHeader header = {};
+    std::memcpy(header.magic, "UAVFLEET", 8);
+    header.version = manifestVersion;
+    header.byteOrder = byteOrderMark;
+    header.count = fleet.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const AlignedVector<double>* columns[columnCount] = { &fleet.x, &fleet.y, &fleet.z, &fleet.v, &fleet.azimuth, &fleet.r };
+    for (const AlignedVector<double>* column : columns) {
+        file.write(reinterpret_cast<const char*>(column->data()), static_cast<std::streamsize>(column->size() * sizeof(double)));
+    }
+    if (!file) {
+        std::cerr << "Failed to write fleet manifest: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef FLEETMANIFEST_H
+#define FLEETMANIFEST_H
+
+#include <string>
+#include "Config.h"
+#include "UAVFleet.h"
+
+// Per-UAV start state and performance envelope, one UAV per row.
+//
+// CSV manifest: a header row naming the columns, then one row per UAV. The columns use the
+// SimParams.ini names X0, Y0, Z0, V0, Az and R, in any order; a column that is left out takes the
+// value of SimParams.ini for every UAV. Row k is UAV k. Blank lines and lines starting with '#'
+// are skipped.
+//
+//     X0,Y0,V0,R
+//     0,0,25,80
+//     100,-50,30,120
+//
+// Binary manifest: a header ("UAVFLEET", version, byte order mark, UAV count) followed by one
+// column of doubles per field (X0, Y0, Z0, V0, Az, R), so every column is copied into the fleet
+// storage in one block. writeFleetManifest() converts a fleet to this format.
+//
+// Both formats are read through a memory mapping and parsed in place with std::from_chars, without
+// any per-line allocation.
+
+/**
+* Loads a fleet manifest (CSV or binary, recognized by its content) into the fleet storage.
+*
+* @param filename The manifest, relative to the current directory.
+* @param config The configuration giving the values of the columns a CSV manifest leaves out.
+* @param fleet The fleet. It is resized to the number of rows and the UAVs are numbered from 1.
+* @return True if the manifest was loaded, false otherwise.
+*/
+bool loadFleetManifest(const std::string& filename, const Config& config, UAVFleet& fleet);
+
+/**
+* Writes the start state of a fleet as a binary manifest.
+*
+* @param filename The manifest to create.
+* @param fleet The fleet to write.
+* @return True if the manifest was written, false otherwise.
+*/
+bool writeFleetManifest(const std::string& filename, const UAVFleet& fleet);
+
+#endif // FLEETMANIFEST_H
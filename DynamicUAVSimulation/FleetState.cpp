@@ -0,0 +1,201 @@
+#include "FleetState.h"
+
+#include <cmath>
+#include "Profiler.h"
+
+// Changes the number of UAVs.
+template <typename T>
+void FleetState<T>::resize(std::size_t count) {
+    x.resize(count, T(0));
+    y.resize(count, T(0));
+    tileX.resize(count, 0);
+    tileY.resize(count, 0);
+    azimuth.resize(count, T(0));
+    v.resize(count, T(0));
+    r.resize(count, T(0));
+    azimuthUpdated.resize(count, 0);
+    standbyModeFlag.resize(count, 0);
+}
+
+// Copies the state of every UAV from the fleet.
+template <typename T>
+void FleetState<T>::load(const UAVFleet& fleet) {
+    resize(fleet.size());
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        double shiftX = std::floor(fleet.x[i] / tileSize + 0.5);
+        double shiftY = std::floor(fleet.y[i] / tileSize + 0.5);
+        tileX[i] = static_cast<std::int32_t>(shiftX);
+        tileY[i] = static_cast<std::int32_t>(shiftY);
+        x[i] = static_cast<T>(fleet.x[i] - shiftX * tileSize);
+        y[i] = static_cast<T>(fleet.y[i] - shiftY * tileSize);
+        azimuth[i] = static_cast<T>(fleet.azimuth[i]);
+        v[i] = static_cast<T>(fleet.v[i]);
+        r[i] = static_cast<T>(fleet.r[i]);
+        azimuthUpdated[i] = fleet.azimuthUpdated[i];
+        standbyModeFlag[i] = fleet.standbyModeFlag[i];
+    }
+}
+
+// Copies the positions, azimuths and flags of the UAVs in [begin, end) into the fleet.
+template <typename T>
+void FleetState<T>::store(UAVFleet& fleet, std::size_t begin, std::size_t end, const std::uint8_t* skip) const {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (skip != nullptr && skip[i]) {
+            continue;
+        }
+        fleet.x[i] = positionX(i);
+        fleet.y[i] = positionY(i);
+        fleet.azimuth[i] = static_cast<double>(azimuth[i]);
+        fleet.azimuthUpdated[i] = azimuthUpdated[i];
+        fleet.standbyModeFlag[i] = standbyModeFlag[i];
+    }
+}
+
+// Returns the current state of a UAV as a trajectory sample.
+template <typename T>
+TrajectorySample FleetState<T>::sample(const UAVFleet& fleet, std::size_t index, double time) const {
+    std::uint8_t mode = 0;
+    if (standbyModeFlag[index]) {
+        mode |= TrajectorySample::StandbyMode;
+    }
+    if (azimuthUpdated[index]) {
+        mode |= TrajectorySample::AzimuthUpdated;
+    }
+    if (fleet.cruising[index]) {
+        mode |= TrajectorySample::Cruising;
+    }
+    return { time, positionX(index), positionY(index), static_cast<double>(azimuth[index]), fleet.z[index], mode };
+}
+
+// Moves a UAV into the tile holding its position. The shift is a multiple of the power-of-two
+// tile size close to the coordinate, so the subtraction is exact.
+template <typename T>
+void FleetState<T>::rebase(std::size_t index) {
+    const T half = static_cast<T>(tileSize / 2.0);
+    if (!(x[index] >= -half && x[index] < half) && std::isfinite(x[index])) {
+        double shift = std::floor(static_cast<double>(x[index]) / tileSize + 0.5);
+        x[index] = static_cast<T>(static_cast<double>(x[index]) - shift * tileSize);
+        tileX[index] += static_cast<std::int32_t>(shift);
+    }
+    if (!(y[index] >= -half && y[index] < half) && std::isfinite(y[index])) {
+        double shift = std::floor(static_cast<double>(y[index]) / tileSize + 0.5);
+        y[index] = static_cast<T>(static_cast<double>(y[index]) - shift * tileSize);
+        tileY[index] += static_cast<std::int32_t>(shift);
+    }
+}
+
+// Straight flight of one UAV, like UAV::linearFlightUpdate.
+template <typename T>
+void FleetState<T>::linearFlightUpdate(std::size_t index, T duration) {
+    x[index] = x[index] + v[index] * std::cos(azimuth[index]) * duration;
+    y[index] = y[index] + v[index] * std::sin(azimuth[index]) * duration;
+}
+
+// Clockwise circle around the destination, like UAV::standbyMode.
+template <typename T>
+void FleetState<T>::standbyMode(std::size_t index, T destX, T destY, T duration) {
+    const T twoPi = static_cast<T>(2.0 * 3.14159265358979323846);
+    T angularSpeed = v[index] / r[index];
+    T newAzimuth = azimuth[index] + (-angularSpeed * duration);
+    while (newAzimuth < T(0))
+        newAzimuth += twoPi;
+    while (newAzimuth >= twoPi)
+        newAzimuth -= twoPi;
+
+    x[index] = destX - r[index] * std::cos(newAzimuth);
+    y[index] = destY - r[index] * std::sin(newAzimuth);
+    azimuth[index] = newAzimuth;
+}
+
+// Moves a UAV towards its destination for one step, with the branches of UAV::navigateToTarget.
+template <typename T>
+void FleetState<T>::navigateToTarget(std::size_t index, double duration, double destX, double destY, bool newCommand) {
+    if (newCommand) {
+        standbyModeFlag[index] = 0;
+    }
+    const T step = static_cast<T>(duration);
+    const T radius = r[index];
+    const T speed = v[index];
+    // Destination relative to the tile of the UAV
+    const T targetX = static_cast<T>(destX - tileX[index] * tileSize);
+    const T targetY = static_cast<T>(destY - tileY[index] * tileSize);
+
+    T deltaX = targetX - x[index];
+    T deltaY = targetY - y[index];
+    T distanceToDest = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+    T azimuthToDest = std::atan2(deltaY, deltaX);
+
+    if (distanceToDest == radius || standbyModeFlag[index]) {
+        UAVSIM_PROFILE_COUNT(NavigateStandby);
+        standbyModeFlag[index] = 1;
+        standbyMode(index, targetX, targetY, step);
+    }
+    else if (distanceToDest < radius) {
+        T timeToDest = distanceToDest / speed;
+        T timeToRadius = radius / speed;
+        if (!azimuthUpdated[index]) {
+            azimuth[index] = azimuthToDest;
+            azimuthUpdated[index] = 1;
+        }
+        if ((timeToDest + timeToRadius) < step) {
+            UAVSIM_PROFILE_COUNT(NavigateInsideArrive);
+            azimuthUpdated[index] = 0;
+            linearFlightUpdate(index, timeToDest);
+            standbyMode(index, targetX, targetY, step - (timeToDest + timeToRadius));
+        }
+        else {
+            UAVSIM_PROFILE_COUNT(NavigateInsideStraight);
+            linearFlightUpdate(index, step);
+        }
+    }
+    else {
+        T finalX = x[index] + speed * std::cos(azimuthToDest) * step;
+        T finalY = y[index] + speed * std::sin(azimuthToDest) * step;
+        T finalDeltaX = targetX - finalX;
+        T finalDeltaY = targetY - finalY;
+        T finalDistanceToDest = std::sqrt(finalDeltaX * finalDeltaX + finalDeltaY * finalDeltaY);
+
+        if (finalDistanceToDest < radius || finalDistanceToDest - radius > distanceToDest) {
+            UAVSIM_PROFILE_COUNT(NavigateOvershoot);
+            T timeToRadiusFromCenter = std::abs(radius - distanceToDest) / speed;
+            azimuth[index] = azimuthToDest;
+            linearFlightUpdate(index, timeToRadiusFromCenter);
+            standbyModeFlag[index] = 1;
+            standbyMode(index, targetX, targetY, step - timeToRadiusFromCenter);
+        }
+        else {
+            UAVSIM_PROFILE_COUNT(NavigateApproach);
+            azimuth[index] = azimuthToDest;
+            linearFlightUpdate(index, step);
+        }
+    }
+    rebase(index);
+}
+
+// Advances the cruising UAVs in [begin, end) in a straight line.
+template <typename T>
+void FleetState<T>::linearFlightUpdate(double duration, const std::uint8_t* cruising, std::size_t begin, std::size_t end) {
+    const std::size_t count = end - begin;
+    const T step = static_cast<T>(duration);
+    T* __restrict px = x.data() + begin;
+    T* __restrict py = y.data() + begin;
+    const T* __restrict pazimuth = azimuth.data() + begin;
+    const T* __restrict pv = v.data() + begin;
+    const std::uint8_t* __restrict pcruising = cruising + begin;
+
+    // Separate X and Y passes, as in linearFlightUpdate(fleet, ...), so both vectorize
+    for (std::size_t i = 0; i < count; ++i) {
+        T newX = px[i] + pv[i] * std::cos(pazimuth[i]) * step;
+        px[i] = pcruising[i] ? newX : px[i];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        T newY = py[i] + pv[i] * std::sin(pazimuth[i]) * step;
+        py[i] = pcruising[i] ? newY : py[i];
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+        rebase(i);
+    }
+}
+
+template class FleetState<float>;
+template class FleetState<double>;
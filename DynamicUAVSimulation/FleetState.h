@@ -0,0 +1,114 @@
+#pragma once
+#ifndef FLEETSTATE_H
+#define FLEETSTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "TrajectorySink.h"
+#include "UAVFleet.h"
+
+// Scalar of the planar state of the tick engine, chosen at compile time (UAVSIM_FLOAT_STATE).
+// A double build moves the UAVFleet itself; a float build moves a FleetState<StateScalar> instead
+// and copies it into the fleet at every synchronization point.
+#if defined(UAVSIM_FLOAT_STATE) && UAVSIM_FLOAT_STATE
+using StateScalar = float;
+#else
+using StateScalar = double;
+#endif
+const bool floatState = std::is_same<StateScalar, float>::value;
+
+// Compact copy of the state the planar model updates every tick, in single or double precision.
+//
+// Float positions far from the origin would lose the centimeters a tick moves a UAV, so every UAV
+// keeps its position relative to the center of a square tile of tileSize meters, stored as two
+// integers: the absolute position is tile * tileSize + relative, with the relative coordinates in
+// [-tileSize / 2, tileSize / 2). A UAV leaving its tile moves to the next one; since tileSize is a
+// power of two, that shift is exact, and load() of a stored position gives back the same tile and
+// relative coordinates, so a run resumed from a checkpoint continues from exactly the same state.
+//
+// The kernels repeat UAV::navigateToTarget, UAV::standbyMode and UAV::linearFlightUpdate in the
+// scalar type T, with the destination taken relative to the tile of the UAV, and take the same
+// branches on the same tests (a UAV enters its loiter when its distance is exactly R). A loiter that
+// is restarted every step (the engine keeps whole command times, so a command with a fractional
+// time counts as new at every step) depends on that test coming out exactly as in double, which no
+// other precision reproduces: the tick engine moves such UAVs in the double fleet instead (see
+// TickEngine.h). In float, the state a tick reads and writes takes 30 bytes per UAV instead of the
+// 42 of the fleet arrays (x, y, azimuth, v, r and two flags), and the straight flight pass handles
+// twice as many UAVs per vector instruction.
+template <typename T>
+class FleetState {
+public:
+    static constexpr double tileSize = 1024.0;
+
+    /**
+    * Changes the number of UAVs. New UAVs are zero-initialized.
+    */
+    void resize(std::size_t count);
+
+    std::size_t size() const { return x.size(); }
+
+    /**
+    * Copies the state of every UAV from the fleet.
+    */
+    void load(const UAVFleet& fleet);
+
+    /**
+    * Copies the positions, azimuths and flags of the UAVs in [begin, end) into the fleet.
+    *
+    * @param skip Per-UAV flags of the UAVs to leave alone (moved in the fleet itself), or nullptr.
+    */
+    void store(UAVFleet& fleet, std::size_t begin, std::size_t end, const std::uint8_t* skip = nullptr) const;
+
+    const std::uint8_t* standbyFlags() const { return standbyModeFlag.data(); }
+
+    double positionX(std::size_t index) const { return tileX[index] * tileSize + static_cast<double>(x[index]); }
+    double positionY(std::size_t index) const { return tileY[index] * tileSize + static_cast<double>(y[index]); }
+
+    /**
+    * Returns the current state of a UAV as a trajectory sample, like sampleOf().
+    *
+    * @param fleet The fleet, giving the fields the planar model does not change (altitude, cruising).
+    * @param index The zero-based index of the UAV.
+    * @param time The simulation time of the sample.
+    */
+    TrajectorySample sample(const UAVFleet& fleet, std::size_t index, double time) const;
+
+    /**
+    * Moves a UAV towards its destination for one step, like UAV::navigateToTarget.
+    *
+    * @param index The zero-based index of the UAV.
+    * @param duration The step duration.
+    * @param destX The X coordinate of the destination.
+    * @param destY The Y coordinate of the destination.
+    * @param newCommand True if the command differs from the one of the last step (ends the loiter).
+    */
+    void navigateToTarget(std::size_t index, double duration, double destX, double destY, bool newCommand);
+
+    /**
+    * Advances the cruising UAVs in [begin, end) in a straight line, like linearFlightUpdate(fleet, ...).
+    *
+    * @param duration The step duration.
+    * @param cruising The cruising flags of the fleet.
+    */
+    void linearFlightUpdate(double duration, const std::uint8_t* cruising, std::size_t begin, std::size_t end);
+
+private:
+    void linearFlightUpdate(std::size_t index, T duration);
+    void standbyMode(std::size_t index, T destX, T destY, T duration);
+
+    // Moves a UAV into the tile holding its position
+    void rebase(std::size_t index);
+
+    AlignedVector<T> x;                 // Position relative to the center of the tile
+    AlignedVector<T> y;
+    AlignedVector<std::int32_t> tileX;
+    AlignedVector<std::int32_t> tileY;
+    AlignedVector<T> azimuth;
+    AlignedVector<T> v;
+    AlignedVector<T> r;
+    AlignedVector<std::uint8_t> azimuthUpdated;
+    AlignedVector<std::uint8_t> standbyModeFlag;
+};
+
+#endif // FLEETSTATE_H
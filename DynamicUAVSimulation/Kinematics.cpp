@@ -0,0 +1,199 @@
+#include "Kinematics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "Checkpoint.h"
+
+namespace {
+    const double pi = 3.14159265358979323846;
+
+    // Gain of the guidance field: how sharply the desired direction turns from the tangent of the
+    // loiter circle towards (or away from) its center with the distance to the circle
+    const double convergenceGain = 2.0;
+
+    // Largest heading change of one step; keeps the polynomial sine and cosine accurate
+    const double maxStepTurn = 1.5;
+
+    // A UAV within this fraction of the loiter radius from the circle is reported as loitering
+    const double loiterTolerance = 0.1;
+
+    // Polynomial atan2 in [0, 2*pi) that the compiler can vectorize (no branches, no library call).
+    // The ratio of the smaller to the larger component is halved twice with
+    // tan(a / 2) = t / (1 + sqrt(1 + t^2)), then the series of atan is accurate to 1e-11.
+    inline double azimuthOf(double x, double y) {
+        double ax = std::fabs(x);
+        double ay = std::fabs(y);
+        double t = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-300);
+        t = t / (1.0 + std::sqrt(1.0 + t * t));
+        t = t / (1.0 + std::sqrt(1.0 + t * t));
+        double t2 = t * t;
+        double series = t * (1.0 + t2 * (-1.0 / 3.0 + t2 * (1.0 / 5.0 + t2 * (-1.0 / 7.0 + t2 * (1.0 / 9.0 +
+            t2 * (-1.0 / 11.0 + t2 * (1.0 / 13.0)))))));
+        double angle = 4.0 * series;
+        angle = ay > ax ? 0.5 * pi - angle : angle;
+        angle = x < 0.0 ? pi - angle : angle;
+        angle = y < 0.0 ? 2.0 * pi - angle : angle;
+        return angle < 2.0 * pi ? angle : 0.0;
+    }
+
+    // The kernels take their arrays as restrict parameters: the compiler does not vectorize a loop
+    // when it has to check at run time that many arrays do not overlap.
+
+    // Moves every value towards its setpoint by at most maxChange.
+    void approachSetpoints(std::size_t count, double* __restrict values, const double* __restrict setpoints,
+                           double maxChange) {
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] += std::min(std::max(setpoints[i] - values[i], -maxChange), maxChange);
+        }
+    }
+
+    // Turns the headings towards the guidance field with the turn rate limit and moves the UAVs.
+    void steer(std::size_t count, double* __restrict x, double* __restrict y, double* __restrict hx,
+               double* __restrict hy, const double* __restrict v, const double* __restrict r,
+               const double* __restrict tx, const double* __restrict ty, const double* __restrict active,
+               double factor, double duration) {
+        for (std::size_t i = 0; i < count; ++i) {
+            // Desired direction: tangent of the clockwise loiter circle, bent towards the center when
+            // outside the circle and away from it when inside
+            double dx = tx[i] - x[i];
+            double dy = ty[i] - y[i];
+            double distance = std::sqrt(dx * dx + dy * dy);
+            double inverse = 1.0 / std::max(distance, 1e-9);
+            double ux = dx * inverse;
+            double uy = dy * inverse;
+            double loiterRadius = factor * r[i];
+            double s = convergenceGain * (distance - loiterRadius) / loiterRadius;
+            double norm = 1.0 / std::sqrt(1.0 + s * s);
+            double wx = (-uy + s * ux) * norm;
+            double wy = (ux + s * uy) * norm;
+
+            // UAVs without a command keep their heading
+            double headX = hx[i];
+            double headY = hy[i];
+            wx = active[i] * wx + (1.0 - active[i]) * headX;
+            wy = active[i] * wy + (1.0 - active[i]) * headY;
+
+            // Turn towards the desired direction by at most v / R * dt
+            double turn = std::min(v[i] / r[i] * duration, maxStepTurn);
+            double turn2 = turn * turn;
+            double cosTurn = 1.0 - turn2 * (1.0 / 2.0 - turn2 * (1.0 / 24.0 - turn2 * (1.0 / 720.0 - turn2 * (1.0 / 40320.0))));
+            double sinTurn = turn * (1.0 - turn2 * (1.0 / 6.0 - turn2 * (1.0 / 120.0 - turn2 * (1.0 / 5040.0 - turn2 * (1.0 / 362880.0)))));
+            sinTurn = std::copysign(sinTurn, headX * wy - headY * wx);
+            double rotatedX = headX * cosTurn - headY * sinTurn;
+            double rotatedY = headY * cosTurn + headX * sinTurn;
+            bool reached = headX * wx + headY * wy >= cosTurn;
+            double newX = reached ? wx : rotatedX;
+            double newY = reached ? wy : rotatedY;
+            double length = 1.0 / std::sqrt(newX * newX + newY * newY);
+            newX *= length;
+            newY *= length;
+            hx[i] = newX;
+            hy[i] = newY;
+
+            // Move along the chord of the turn
+            double advance = 0.5 * v[i] * duration;
+            x[i] += advance * (headX + newX);
+            y[i] += advance * (headY + newY);
+        }
+    }
+
+    void updateAzimuths(std::size_t count, double* __restrict azimuth, const double* __restrict hx,
+                        const double* __restrict hy) {
+        for (std::size_t i = 0; i < count; ++i) {
+            azimuth[i] = azimuthOf(hx[i], hy[i]);
+        }
+    }
+
+    // A UAV with a command is reported as loitering while it is close to its loiter circle.
+    void updateLoiterFlags(std::size_t count, std::uint8_t* __restrict standby, const double* __restrict x,
+                           const double* __restrict y, const double* __restrict r, const double* __restrict tx,
+                           const double* __restrict ty, const double* __restrict active, double factor) {
+        for (std::size_t i = 0; i < count; ++i) {
+            double dx = tx[i] - x[i];
+            double dy = ty[i] - y[i];
+            double loiterRadius = factor * r[i];
+            double offset = std::fabs(std::sqrt(dx * dx + dy * dy) - loiterRadius);
+            standby[i] = active[i] != 0.0 && offset <= loiterTolerance * loiterRadius;
+        }
+    }
+}
+
+// Constructor
+Kinematics::Kinematics(const UAVFleet& fleet, const Config& config)
+    : maxClimbRate(config.MaxClimbRate), maxAcceleration(config.MaxAcceleration),
+      loiterRadiusFactor(config.LoiterRadiusFactor) {
+    if (config.MotionModel != 1) {
+        return;
+    }
+    const std::size_t count = fleet.size();
+    headingX.resize(count);
+    headingY.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        headingX[i] = std::cos(fleet.azimuth[i]);
+        headingY[i] = std::sin(fleet.azimuth[i]);
+    }
+    targetX.assign(fleet.x.begin(), fleet.x.end());
+    targetY.assign(fleet.y.begin(), fleet.y.end());
+    targetZ.assign(fleet.z.begin(), fleet.z.end());
+    targetV.assign(fleet.v.begin(), fleet.v.end());
+    guided.assign(count, 0.0);
+    commandTimes.assign(count, -1.0);
+}
+
+// Takes the setpoints of the active command of a UAV.
+void Kinematics::setCommand(UAVFleet& fleet, std::size_t index, const Command& command) {
+    if (commandTimes[index] == command.time) {
+        return;
+    }
+    commandTimes[index] = command.time;
+    targetX[index] = command.x;
+    targetY[index] = command.y;
+    if (!std::isnan(command.z)) {
+        targetZ[index] = command.z;
+    }
+    if (!std::isnan(command.v) && command.v > 0.0) {
+        targetV[index] = command.v;
+    }
+    guided[index] = 1.0;
+    fleet.cruising[index] = 0;
+    fleet.standbyModeFlag[index] = 0;
+}
+
+// Moves the UAVs in [begin, end) for one step.
+void Kinematics::step(UAVFleet& fleet, double duration, std::size_t begin, std::size_t end) {
+    const std::size_t count = end - begin;
+    approachSetpoints(count, fleet.z.data() + begin, targetZ.data() + begin, maxClimbRate * duration);
+    approachSetpoints(count, fleet.v.data() + begin, targetV.data() + begin, maxAcceleration * duration);
+    steer(count, fleet.x.data() + begin, fleet.y.data() + begin, headingX.data() + begin, headingY.data() + begin,
+        fleet.v.data() + begin, fleet.r.data() + begin, targetX.data() + begin, targetY.data() + begin,
+        guided.data() + begin, loiterRadiusFactor, duration);
+    updateAzimuths(count, fleet.azimuth.data() + begin, headingX.data() + begin, headingY.data() + begin);
+    updateLoiterFlags(count, fleet.standbyModeFlag.data() + begin, fleet.x.data() + begin, fleet.y.data() + begin,
+        fleet.r.data() + begin, targetX.data() + begin, targetY.data() + begin, guided.data() + begin, loiterRadiusFactor);
+}
+
+// Saves the heading and setpoints of every UAV.
+void Kinematics::saveState(StateWriter& state) const {
+    state.writeVector(headingX);
+    state.writeVector(headingY);
+    state.writeVector(targetX);
+    state.writeVector(targetY);
+    state.writeVector(targetZ);
+    state.writeVector(targetV);
+    state.writeVector(guided);
+    state.writeVector(commandTimes);
+}
+
+// Restores the state saved by saveState().
+bool Kinematics::restoreState(StateReader& state) {
+    const std::size_t count = guided.size();
+    AlignedVector<double>* arrays[] = { &headingX, &headingY, &targetX, &targetY, &targetZ, &targetV, &guided, &commandTimes };
+    for (AlignedVector<double>* array : arrays) {
+        state.readVector(*array);
+        if (array->size() != count) {
+            return false;
+        }
+    }
+    return state.ok();
+}
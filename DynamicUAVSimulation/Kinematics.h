@@ -0,0 +1,73 @@
+#pragma once
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <cstddef>
+#include "CommandScheduler.h"
+#include "Config.h"
+#include "UAVFleet.h"
+
+// 3D motion model of the tick engine (MotionModel=1).
+//
+// Every UAV flies towards the setpoints of its latest command: a loiter center (x, y), an altitude
+// and a speed. Unlike the planar model, nothing jumps:
+// - the heading turns at most v / R radians per second (R is the minimum turning radius),
+// - the altitude changes at most MaxClimbRate meters per second and the speed MaxAcceleration
+//   meters per second squared,
+// - the UAV circles clockwise at LoiterRadiusFactor * R around the center, climbing or descending
+//   on a helix until it reaches the commanded altitude.
+//
+// The guidance is a vector field: the desired direction blends the tangent of the loiter circle with
+// the direction of its center according to the distance to the circle, which also steers UAVs far
+// away straight to the center. It is written with unit vectors instead of angles, so a step of the
+// whole fleet is one branch-free loop without calls into the math library, which the compiler
+// vectorizes. The heading is kept as a unit vector; the azimuth of the outputs is derived from it.
+// UAVs without any command keep their heading, altitude and speed.
+class Kinematics {
+public:
+    /**
+    * @param fleet The fleet. The headings start at the fleet azimuths and the setpoints at the
+    *              current positions, altitudes and speeds.
+    * @param config The simulation parameters (MotionModel, MaxClimbRate, MaxAcceleration, LoiterRadiusFactor).
+    *               The model holds no state unless MotionModel is 1.
+    */
+    Kinematics(const UAVFleet& fleet, const Config& config);
+
+    /**
+    * Takes the setpoints of the active command of a UAV. A new command ends the loiter of the
+    * previous one; the altitude and speed setpoints are kept when the command does not give them.
+    *
+    * @param fleet The fleet holding the UAV.
+    * @param index The zero-based index of the UAV.
+    * @param command The active command of the UAV.
+    */
+    void setCommand(UAVFleet& fleet, std::size_t index, const Command& command);
+
+    /**
+    * Moves the UAVs in [begin, end) for one step.
+    *
+    * @param fleet The fleet.
+    * @param duration The step duration.
+    * @param begin The first UAV index.
+    * @param end One past the last UAV index.
+    */
+    void step(UAVFleet& fleet, double duration, std::size_t begin, std::size_t end);
+
+    void saveState(StateWriter& state) const;
+    bool restoreState(StateReader& state);
+
+private:
+    double maxClimbRate;
+    double maxAcceleration;
+    double loiterRadiusFactor;
+    AlignedVector<double> headingX;     // Unit vector of the heading
+    AlignedVector<double> headingY;
+    AlignedVector<double> targetX;      // Loiter center of the active command
+    AlignedVector<double> targetY;
+    AlignedVector<double> targetZ;      // Altitude setpoint
+    AlignedVector<double> targetV;      // Speed setpoint
+    AlignedVector<double> guided;       // 1 once the UAV has a command, 0 before
+    AlignedVector<double> commandTimes; // Time of the active command (-1 = none)
+};
+
+#endif // KINEMATICS_H
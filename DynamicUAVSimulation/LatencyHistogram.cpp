@@ -0,0 +1,58 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Returns the bucket of a value: values below 16 have their own bucket, larger values are
+// bucketed by their highest bit and the next 4 bits.
+int LatencyHistogram::bucketOf(std::uint64_t value) {
+    if (value < static_cast<std::uint64_t>(subBuckets)) {
+        return static_cast<int>(value);
+    }
+    int highestBit = 63;
+    while ((value >> highestBit) == 0) {
+        --highestBit;
+    }
+    int shift = highestBit - subBucketBits;
+    int subBucket = static_cast<int>((value >> shift) & (subBuckets - 1));
+    return (shift + 1) * subBuckets + subBucket;
+}
+
+// Returns the largest value of a bucket.
+std::uint64_t LatencyHistogram::upperBoundOf(int bucket) {
+    if (bucket < subBuckets) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int shift = bucket / subBuckets - 1;
+    std::uint64_t subBucket = static_cast<std::uint64_t>(bucket % subBuckets);
+    return ((static_cast<std::uint64_t>(subBuckets) + subBucket + 1) << shift) - 1;
+}
+
+// Adds a duration.
+void LatencyHistogram::record(std::int64_t nanoseconds) {
+    if (nanoseconds < 0) {
+        nanoseconds = 0;
+    }
+    ++counts[bucketOf(static_cast<std::uint64_t>(nanoseconds))];
+    ++total;
+    maxValue = std::max(maxValue, nanoseconds);
+}
+
+// Returns the duration below which the given fraction of the recorded durations lie.
+std::int64_t LatencyHistogram::percentile(double fraction) const {
+    if (total == 0) {
+        return 0;
+    }
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            // The exact maximum is tighter than the bucket bound
+            return std::min(static_cast<std::int64_t>(upperBoundOf(bucket)), maxValue);
+        }
+    }
+    return maxValue;
+}
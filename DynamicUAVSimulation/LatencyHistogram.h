@@ -0,0 +1,46 @@
+#pragma once
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Histogram of durations with a bounded relative error.
+// Values are bucketed by their power of two, and every power of two is split into 16 linear
+// sub-buckets, so a percentile is reported within about 6% of the recorded value whatever its
+// magnitude. The buckets are a fixed array: recording never allocates.
+class LatencyHistogram {
+public:
+    /**
+    * Adds a duration.
+    *
+    * @param nanoseconds The duration in nanoseconds; negative durations count as 0.
+    */
+    void record(std::int64_t nanoseconds);
+
+    /**
+    * Returns the duration below which the given fraction of the recorded durations lie.
+    *
+    * @param fraction The fraction in [0, 1], e.g. 0.99 for the 99th percentile.
+    * @return The upper bound of the bucket holding the percentile, in nanoseconds (0 if empty).
+    */
+    std::int64_t percentile(double fraction) const;
+
+    std::int64_t max() const { return maxValue; }
+    std::uint64_t count() const { return total; }
+
+private:
+    static const int subBucketBits = 4;
+    static const int subBuckets = 1 << subBucketBits;
+    static const int bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+    static int bucketOf(std::uint64_t value);
+    static std::uint64_t upperBoundOf(int bucket);
+
+    std::array<std::uint64_t, bucketCount> counts{};
+    std::uint64_t total = 0;
+    std::int64_t maxValue = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
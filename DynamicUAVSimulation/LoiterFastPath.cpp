@@ -0,0 +1,78 @@
+#include "LoiterFastPath.h"
+
+#include <cmath>
+#include "Checkpoint.h"
+
+// Constructor
+LoiterFastPath::LoiterFastPath(std::size_t count, int renormalizeSteps)
+    : renormalizeSteps(renormalizeSteps > 0 ? renormalizeSteps : 1),
+      cosAzimuth(count, 1.0), sinAzimuth(count, 0.0), stepAngle(count, 0.0), cosStep(count, 1.0),
+      sinStep(count, 0.0), stepsSinceSync(count, 0), valid(count, 0) {}
+
+// Moves a loitering UAV along its circle for one step.
+void LoiterFastPath::step(UAVFleet& fleet, std::size_t index, double duration, double destX, double destY) {
+    const double pi = 3.14159265358979323846;
+    const double r = fleet.r[index];
+
+    // Same azimuth arithmetic as UAV::standbyMode (clockwise)
+    double angle = fleet.v[index] / r * duration;
+    double newAzimuth = fleet.azimuth[index] + -angle;
+    while (newAzimuth < 0)
+        newAzimuth += 2 * pi;
+    while (newAzimuth >= 2 * pi)
+        newAzimuth -= 2 * pi;
+
+    double c;
+    double s;
+    if (valid[index] && stepAngle[index] == angle && stepsSinceSync[index] < static_cast<std::uint32_t>(renormalizeSteps)) {
+        // cos(a - d) = cos a cos d + sin a sin d, sin(a - d) = sin a cos d - cos a sin d
+        double cosA = cosAzimuth[index];
+        double sinA = sinAzimuth[index];
+        c = cosA * cosStep[index] + sinA * sinStep[index];
+        s = sinA * cosStep[index] - cosA * sinStep[index];
+        ++stepsSinceSync[index];
+    }
+    else {
+        // Exact (re-)synchronization
+        c = std::cos(newAzimuth);
+        s = std::sin(newAzimuth);
+        if (stepAngle[index] != angle || !valid[index]) {
+            stepAngle[index] = angle;
+            cosStep[index] = std::cos(angle);
+            sinStep[index] = std::sin(angle);
+        }
+        stepsSinceSync[index] = 0;
+        valid[index] = 1;
+    }
+    cosAzimuth[index] = c;
+    sinAzimuth[index] = s;
+
+    fleet.x[index] = destX - r * c;
+    fleet.y[index] = destY - r * s;
+    fleet.azimuth[index] = newAzimuth;
+}
+
+// Saves the rotation state of every UAV, so a resumed run re-synchronizes at the same ticks.
+void LoiterFastPath::saveState(StateWriter& state) const {
+    state.writeVector(cosAzimuth);
+    state.writeVector(sinAzimuth);
+    state.writeVector(stepAngle);
+    state.writeVector(cosStep);
+    state.writeVector(sinStep);
+    state.writeVector(stepsSinceSync);
+    state.writeVector(valid);
+}
+
+// Restores the rotation state saved by saveState().
+bool LoiterFastPath::restoreState(StateReader& state) {
+    const std::size_t count = valid.size();
+    state.readVector(cosAzimuth);
+    state.readVector(sinAzimuth);
+    state.readVector(stepAngle);
+    state.readVector(cosStep);
+    state.readVector(sinStep);
+    state.readVector(stepsSinceSync);
+    state.readVector(valid);
+    return state.ok() && cosAzimuth.size() == count && sinAzimuth.size() == count && stepAngle.size() == count &&
+        cosStep.size() == count && sinStep.size() == count && stepsSinceSync.size() == count && valid.size() == count;
+}
@@ -2,19 +2,195 @@
 
 // Function to get the current directory
 std::string getCurrentDirectory() {
-    char buffer[MAX_PATH];
-    DWORD result = GetCurrentDirectoryA(MAX_PATH, buffer); // Retrieve current directory
-    if (result == 0) {
+    std::error_code error;
+    std::filesystem::path current = std::filesystem::current_path(error); // Retrieve current directory
+    if (error) {
         std::cerr << "Error getting current directory." << std::endl; // Print error message if failed
         return "";
     }
-    return std::string(buffer); // Return current directory as string
+    return current.string(); // Return current directory as string
+}
+
+// Function to resolve an input file name
+std::filesystem::path resolveInputPath(const std::string& filename) {
+    std::filesystem::path path(filename);
+    if (path.is_absolute()) {
+        return path;
+    }
+    return std::filesystem::path(getCurrentDirectory()) / path;
+}
+
+// Function to set one configuration parameter
+bool setConfigValue(Config& config, const std::string& key, double value) {
+    if (key == "Dt") {
+        config.Dt = value;
+    }
+    else if (key == "N_uav") {
+        config.N_uav = static_cast<int>(value);
+    }
+    else if (key == "R") {
+        config.R = value;
+    }
+    else if (key == "X0") {
+        config.X0 = value;
+    }
+    else if (key == "Y0") {
+        config.Y0 = value;
+    }
+    else if (key == "Z0") {
+        config.Z0 = value;
+    }
+    else if (key == "V0") {
+        config.V0 = value;
+    }
+    else if (key == "Az") {
+        config.Az = value;
+    }
+    else if (key == "TimeLim") {
+        config.TimeLim = value;
+    }
+    else if (key == "OutputBufferBytes") {
+        config.OutputBufferBytes = static_cast<std::size_t>(value);
+    }
+    else if (key == "OutputFlushInterval") {
+        config.OutputFlushInterval = value;
+    }
+    else if (key == "BinaryOutput") {
+        config.BinaryOutput = value != 0.0;
+    }
+    else if (key == "BinaryPrecision") {
+        config.BinaryPrecision = static_cast<int>(value);
+    }
+    else if (key == "Threads") {
+        config.Threads = static_cast<int>(value);
+    }
+    else if (key == "TicksPerSync") {
+        config.TicksPerSync = static_cast<int>(value);
+    }
+    else if (key == "Engine") {
+        config.Engine = static_cast<int>(value);
+    }
+    else if (key == "OutputInterval") {
+        config.OutputInterval = value;
+    }
+    else if (key == "TextOutput") {
+        config.TextOutput = value != 0.0;
+    }
+    else if (key == "Recorder") {
+        config.Recorder = value != 0.0;
+    }
+    else if (key == "RecorderWindow") {
+        config.RecorderWindow = value;
+    }
+    else if (key == "RecorderPostTrigger") {
+        config.RecorderPostTrigger = value;
+    }
+    else if (key == "SeparationDistance") {
+        config.SeparationDistance = value;
+    }
+    else if (key == "SeparationCheckInterval") {
+        config.SeparationCheckInterval = value;
+    }
+    else if (key == "RealTimeFactor") {
+        config.RealTimeFactor = value;
+    }
+    else if (key == "RealTimeSpin") {
+        config.RealTimeSpin = value;
+    }
+    else if (key == "CommandPollInterval") {
+        config.CommandPollInterval = value;
+    }
+    else if (key == "CheckpointInterval") {
+        config.CheckpointInterval = value;
+    }
+    else if (key == "LoiterFastPath") {
+        config.LoiterFastPath = value != 0.0;
+    }
+    else if (key == "LoiterRenormalizeSteps") {
+        config.LoiterRenormalizeSteps = static_cast<int>(value);
+    }
+    else if (key == "MotionModel") {
+        config.MotionModel = static_cast<int>(value);
+    }
+    else if (key == "MaxClimbRate") {
+        config.MaxClimbRate = value;
+    }
+    else if (key == "MaxAcceleration") {
+        config.MaxAcceleration = value;
+    }
+    else if (key == "LoiterRadiusFactor") {
+        config.LoiterRadiusFactor = value;
+    }
+    else if (key == "CompressedOutput") {
+        config.CompressedOutput = value != 0.0;
+    }
+    else if (key == "CompressedBlockSamples") {
+        config.CompressedBlockSamples = static_cast<int>(value);
+    }
+    else if (key == "CompressedTimeResolution") {
+        config.CompressedTimeResolution = value;
+    }
+    else if (key == "CompressedPositionResolution") {
+        config.CompressedPositionResolution = value;
+    }
+    else if (key == "CompressedAngleResolution") {
+        config.CompressedAngleResolution = value;
+    }
+    else if (key == "AsyncOutput") {
+        config.AsyncOutput = value != 0.0;
+    }
+    else if (key == "AsyncOutputBuffers") {
+        config.AsyncOutputBuffers = static_cast<int>(value);
+    }
+    else if (key == "AsyncOutputBufferBytes") {
+        config.AsyncOutputBufferBytes = static_cast<std::size_t>(value);
+    }
+    else if (key == "AsyncOutputPolicy") {
+        config.AsyncOutputPolicy = static_cast<int>(value);
+    }
+    else if (key == "AssignmentExactLimit") {
+        config.AssignmentExactLimit = static_cast<int>(value);
+    }
+    else if (key == "AssignmentCandidates") {
+        config.AssignmentCandidates = static_cast<int>(value);
+    }
+    else if (key == "PrecisionValidation") {
+        config.PrecisionValidation = value != 0.0;
+    }
+    else if (key == "TrajectoryIndexInterval") {
+        config.TrajectoryIndexInterval = value;
+    }
+    else if (key == "ProfileTraceEvery") {
+        config.ProfileTraceEvery = static_cast<int>(value);
+    }
+    else if (key == "OutputDecimation") {
+        config.OutputDecimation = static_cast<int>(value);
+    }
+    else if (key.compare(0, 16, "OutputDecimation") == 0 && key.size() > 16 &&
+        key.find_first_not_of("0123456789", 16) == std::string::npos) {
+        // Per-UAV decimation, e.g. "OutputDecimation3=10"
+        config.OutputDecimationPerUAV[std::stoi(key.substr(16))] = static_cast<int>(value);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+// Function to set one text configuration parameter
+bool setConfigString(Config& config, const std::string& key, const std::string& value) {
+    if (key == "FleetManifest") {
+        config.FleetManifest = value;
+    }
+    else {
+        return false;
+    }
+    return true;
 }
 
 // Function to read configuration from file
 bool readConfigFromFile(const std::string& filename, Config& config) {
-    std::string currentDir = getCurrentDirectory(); // Get current directory
-    std::ifstream file(currentDir + "\\" + filename); // Open file in current directory
+    std::ifstream file(resolveInputPath(filename)); // Open file relative to the current directory
 
     if (!file.is_open()) {
         std::cerr << "Error: Unable to open file." << std::endl; // Print error message if failed to open file
@@ -27,35 +203,14 @@ bool readConfigFromFile(const std::string& filename, Config& config) {
         std::string key, valueString;
         if (std::getline(iss, key, '=')) { // Split line into key and value
             if (std::getline(iss, valueString)) {
-                double value = std::stod(valueString); // Convert value to double
-                // Set configuration parameters based on key
-                if (key == "Dt") {
-                    config.Dt = value;
-                }
-                else if (key == "N_uav") {
-                    config.N_uav = static_cast<int>(value);
-                }
-                else if (key == "R") {
-                    config.R = value;
-                }
-                else if (key == "X0") {
-                    config.X0 = value;
-                }
-                else if (key == "Y0") {
-                    config.Y0 = value;
-                }
-                else if (key == "Z0") {
-                    config.Z0 = value;
-                }
-                else if (key == "V0") {
-                    config.V0 = value;
-                }
-                else if (key == "Az") {
-                    config.Az = value;
+                if (!valueString.empty() && valueString.back() == '\r') {
+                    valueString.pop_back();
                 }
-                else if (key == "TimeLim") {
-                    config.TimeLim = value;
+                if (setConfigString(config, key, valueString)) {
+                    continue;
                 }
+                double value = std::stod(valueString); // Convert value to double
+                setConfigValue(config, key, value); // Set configuration parameters based on key
             }
         }
     }
@@ -66,40 +221,31 @@ bool readConfigFromFile(const std::string& filename, Config& config) {
 
 // Function to read commands from file
 bool readCommandsFromFile(const std::string& filename, std::vector<Command>& commands) {
-    std::string currentDir = getCurrentDirectory(); // Get current directory
-    std::ifstream file(currentDir + "\\" + filename); // Open file in current directory
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Unable to open file." << std::endl; // Print error message if failed to open file
-        return false;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) { // Read each line of the file
-        std::istringstream iss(line); // Create a string stream from the line
-        Command command;
-        if (iss >> command.time >> command.num >> command.x >> command.y) { // Read command data
-            commands.push_back(command); // Store command in the vector
-        }
-    }
-
-    file.close(); // Close the file
-    return true;
+    // Memory-mapped and parsed in place (in parallel for large files); also reads binary command files
+    return loadCommandFile(filename, commands);
 }
 
 
 // Function to initialize UAVs
-void initializeUAVs(Config& config, UAV*& uavs) {
-    uavs = new UAV[config.N_uav];
+bool initializeUAVs(Config& config, UAVFleet& fleet) {
+    if (!config.FleetManifest.empty()) {
+        if (!loadFleetManifest(config.FleetManifest, config, fleet)) {
+            return false;
+        }
+        config.N_uav = static_cast<int>(fleet.size());
+        return true;
+    }
+    fleet.resize(config.N_uav);
     for (int i = 0; i < config.N_uav; ++i) {
-        uavs[i].setNum(i + 1);
-        uavs[i].setX(config.X0);
-        uavs[i].setY(config.Y0);
-        uavs[i].setAzimuth(config.Az);
-        uavs[i].setZ(config.Z0);
-        uavs[i].setV(config.V0);
-        uavs[i].setR(config.R);
+        fleet.num[i] = i + 1;
+        fleet.x[i] = config.X0;
+        fleet.y[i] = config.Y0;
+        fleet.azimuth[i] = config.Az;
+        fleet.z[i] = config.Z0;
+        fleet.v[i] = config.V0;
+        fleet.r[i] = config.R;
     }
+    return true;
 }
 
 // Function to print configuration
@@ -114,121 +260,98 @@ void printConfiguration(const Config& config) {
     std::cout << "V0: " << std::fixed << std::setprecision(1) << config.V0 << std::endl;
     std::cout << "Az: " << std::fixed << std::setprecision(2) << config.Az << std::endl;
     std::cout << "TimeLim: " << std::fixed << std::setprecision(2) << config.TimeLim << std::endl;
+    std::cout << "OutputBufferBytes: " << config.OutputBufferBytes << std::endl;
+    std::cout << "OutputFlushInterval: " << std::fixed << std::setprecision(2) << config.OutputFlushInterval << std::endl;
+    std::cout << "BinaryOutput: " << (config.BinaryOutput ? 1 : 0) << std::endl;
+    std::cout << "BinaryPrecision: " << config.BinaryPrecision << std::endl;
+    std::cout << "Threads: " << config.Threads << std::endl;
+    std::cout << "TicksPerSync: " << config.TicksPerSync << std::endl;
+    std::cout << "Engine: " << config.Engine << std::endl;
+    std::cout << "OutputInterval: " << std::fixed << std::setprecision(3) << config.OutputInterval << std::endl;
+    std::cout << "OutputDecimation: " << config.OutputDecimation << std::endl;
+    for (const auto& decimation : config.OutputDecimationPerUAV) {
+        std::cout << "OutputDecimation" << decimation.first << ": " << decimation.second << std::endl;
+    }
+    std::cout << "TextOutput: " << (config.TextOutput ? 1 : 0) << std::endl;
+    std::cout << "TrajectoryIndexInterval: " << std::fixed << std::setprecision(2) << config.TrajectoryIndexInterval << std::endl;
+    std::cout << "Recorder: " << (config.Recorder ? 1 : 0) << std::endl;
+    std::cout << "RecorderWindow: " << std::fixed << std::setprecision(2) << config.RecorderWindow << std::endl;
+    std::cout << "RecorderPostTrigger: " << std::fixed << std::setprecision(2) << config.RecorderPostTrigger << std::endl;
+    std::cout << "SeparationDistance: " << std::fixed << std::setprecision(2) << config.SeparationDistance << std::endl;
+    std::cout << "SeparationCheckInterval: " << std::fixed << std::setprecision(2) << config.SeparationCheckInterval << std::endl;
+    std::cout << "RealTimeFactor: " << std::fixed << std::setprecision(2) << config.RealTimeFactor << std::endl;
+    std::cout << "RealTimeSpin: " << std::fixed << std::setprecision(4) << config.RealTimeSpin << std::endl;
+    std::cout << "CommandPollInterval: " << std::fixed << std::setprecision(3) << config.CommandPollInterval << std::endl;
+    std::cout << "CheckpointInterval: " << std::fixed << std::setprecision(2) << config.CheckpointInterval << std::endl;
+    std::cout << "LoiterFastPath: " << (config.LoiterFastPath ? 1 : 0) << std::endl;
+    std::cout << "LoiterRenormalizeSteps: " << config.LoiterRenormalizeSteps << std::endl;
+    std::cout << "MotionModel: " << config.MotionModel << std::endl;
+    if (config.MotionModel == 1) {
+        std::cout << "MaxClimbRate: " << std::fixed << std::setprecision(2) << config.MaxClimbRate << std::endl;
+        std::cout << "MaxAcceleration: " << std::fixed << std::setprecision(2) << config.MaxAcceleration << std::endl;
+        std::cout << "LoiterRadiusFactor: " << std::fixed << std::setprecision(2) << config.LoiterRadiusFactor << std::endl;
+    }
+    std::cout << "CompressedOutput: " << (config.CompressedOutput ? 1 : 0) << std::endl;
+    if (config.CompressedOutput) {
+        std::cout << "CompressedBlockSamples: " << config.CompressedBlockSamples << std::endl;
+        std::streamsize precision = std::cout.precision(6);
+        std::cout << "CompressedTimeResolution: " << config.CompressedTimeResolution << std::endl;
+        std::cout << "CompressedPositionResolution: " << config.CompressedPositionResolution << std::endl;
+        std::cout << "CompressedAngleResolution: " << config.CompressedAngleResolution << std::endl;
+        std::cout.precision(precision);
+    }
+    std::cout << "AsyncOutput: " << (config.AsyncOutput ? 1 : 0) << std::endl;
+    if (config.AsyncOutput) {
+        std::cout << "AsyncOutputBuffers: " << config.AsyncOutputBuffers << std::endl;
+        std::cout << "AsyncOutputBufferBytes: " << config.AsyncOutputBufferBytes << std::endl;
+        std::cout << "AsyncOutputPolicy: " << config.AsyncOutputPolicy << std::endl;
+    }
+    std::cout << "AssignmentExactLimit: " << config.AssignmentExactLimit << std::endl;
+    std::cout << "AssignmentCandidates: " << config.AssignmentCandidates << std::endl;
+    std::cout << "PrecisionValidation: " << (config.PrecisionValidation ? 1 : 0) << std::endl;
+    if (Profiler::enabled) {
+        std::cout << "ProfileTraceEvery: " << config.ProfileTraceEvery << std::endl;
+    }
+    if (!config.FleetManifest.empty()) {
+        std::cout << "FleetManifest: " << config.FleetManifest << std::endl;
+    }
 }
 
 // Function to print commands
 void printCommands(const std::vector<Command>& commands) {
     std::cout << "\nCommands:" << std::endl;
-    for (const auto& command : commands) {
+    std::size_t printed = std::min(commands.size(), printedCommandLimit);
+    for (std::size_t i = 0; i < printed; ++i) {
+        const Command& command = commands[i];
         std::cout << "Time: " << command.time << ", Num: " << command.num
-            << ", X: " << command.x << ", Y: " << command.y << std::endl;
+            << ", X: " << command.x << ", Y: " << command.y;
+        if (!std::isnan(command.z)) {
+            std::cout << ", Z: " << command.z;
+        }
+        if (!std::isnan(command.v)) {
+            std::cout << ", V: " << command.v;
+        }
+        std::cout << "\n";
     }
+    if (commands.size() > printed) {
+        std::cout << "... " << commands.size() - printed << " more commands\n";
+    }
+    std::cout.flush();
 }
 
 // Function to print UAV details
-void printUAVDetails(UAV* uavs, int num_uavs) {
+void printUAVDetails(UAVFleet& fleet) {
     std::cout << "\nUAV's Details:\n" << std::endl;
-    for (int i = 0; i < num_uavs; ++i) {
-        std::cout << "UAV" << uavs[i].getNum() << " Details:" << std::endl;
-        std::cout << "Num: " << uavs[i].getNum() << std::endl;
-        std::cout << "X: " << uavs[i].getX() << std::endl;
-        std::cout << "Y: " << uavs[i].getY() << std::endl;
-        std::cout << "Azimuth: " << uavs[i].getAzimuth() << std::endl;
-        std::cout << "Z: " << uavs[i].getZ() << std::endl;
-        std::cout << "V: " << uavs[i].getV() << std::endl;
-        std::cout << "R: " << uavs[i].getR() << std::endl;
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        UAV uav = fleet[i];
+        std::cout << "UAV" << uav.getNum() << " Details:" << std::endl;
+        std::cout << "Num: " << uav.getNum() << std::endl;
+        std::cout << "X: " << uav.getX() << std::endl;
+        std::cout << "Y: " << uav.getY() << std::endl;
+        std::cout << "Azimuth: " << uav.getAzimuth() << std::endl;
+        std::cout << "Z: " << uav.getZ() << std::endl;
+        std::cout << "V: " << uav.getV() << std::endl;
+        std::cout << "R: " << uav.getR() << std::endl;
         std::cout << std::endl;
     }
 }
-
-// Writes the current UAV details (time, position, azimuth) to a specified file.
-void writeUAVDetailsToFile(const std::string& filename, double currentTime, double x, double y, double azimuth) {
-    std::ofstream outputFile(filename, std::ios_base::app); // Open in append mode
-    if (!outputFile.is_open()) {
-        std::cerr << "Failed to open file: " << filename << std::endl;
-        return; // Exit if the file could not be opened
-    }
-    outputFile << std::fixed << std::setprecision(2) << currentTime << " "
-        << x << " " << y << " " << azimuth << std::endl;
-}
-
-
-int main() {
-    Config config; // Create a configuration object
-    std::vector<Command> commands; // Vector to store commands
-    double currentTime = 0.0; // Initialize current time
-    UAV* uavs = nullptr; // Pointer to UAVs array
-
-    //Reads SimParams file
-    if (!readConfigFromFile("SimParams.ini", config)) {
-        return 1;
-    }
-    //Reads SimCmds file
-    if (!readCommandsFromFile("SimCmds.txt", commands)) {
-        return 1;
-    }
-
-    // Initialize a vector to store the last executed command time for each UAV.
-    std::vector<int> uavCommands(config.N_uav, -1);
-
-    initializeUAVs(config, uavs);
-    printConfiguration(config);
-    printCommands(commands);
-
-    // Sort commands vector in descending order based on time
-    std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
-        return a.time > b.time;
-        });
-
-    printUAVDetails(uavs, config.N_uav);
-
-    // Delete old files before the main simulation loop starts
-    for (int i = 0; i < config.N_uav; ++i) {
-        std::string filename = "UAV" + std::to_string(uavs[i].getNum()) + ".txt";
-        std::remove(filename.c_str());
-    }
-
-    // Main simulation loop
-    while (currentTime <= config.TimeLim) {
-
-        // This loop iterates over each UAV and writes its details to a separate file.
-        for (int i = 0; i < config.N_uav; ++i) {
-            // Formulate the filename for each UAV
-            std::string filename = "UAV" + std::to_string(uavs[i].getNum()) + ".txt";
-            // Write details to the file
-            writeUAVDetailsToFile(filename, currentTime, uavs[i].getX(), uavs[i].getY(), uavs[i].getAzimuth());
-        }
-
-        // Increment current time by time step
-        currentTime += config.Dt;
-
-        // Iterate through each UAV
-        for (int i = 0; i < config.N_uav; ++i) {
-            double latestCommandTime = 0.0; // Initialize latest command time for the UAV
-
-            // Iterate through the list of commands for the current UAV
-            for (const auto& command : commands) {
-                // Check if the command is for the current UAV and its time is valid and not outdated
-                if (command.num == i + 1 && command.time < currentTime && command.time > latestCommandTime) {
-                    latestCommandTime= command.time;// Update the latest command time for the UAV
-                    if (uavCommands[i] != command.time) {
-                        uavs[i].setStandbyModeFlag(false);
-                    }
-                    uavCommands[i] = command.time; // Update the latest command time for the UAV
-                    uavs[i].navigateToTarget(config.Dt, command.x, command.y); // Execute navigation command
-                }
-            }
-
-            // If no command was executed for the UAV, perform linear flight update
-            if (-1== uavCommands[i]) {
-                uavs[i].linearFlightUpdate(config.Dt);
-            }
-        }
-    }
-
-    //deallocate memory
-    delete[] uavs;
-    uavs = nullptr;
-
-    return 0;
-}
\ No newline at end of file
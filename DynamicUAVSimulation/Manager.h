@@ -5,34 +5,37 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include <windows.h>
+#include <filesystem> // Portable path handling
 #include <iomanip> // Include <iomanip> for formatting output
 #include <vector> // Include <vector> for storing commands
+#include "Config.h" // Configuration structure
 #include "UAV.h"    // Include the UAV header file
+#include "UAVFleet.h" // Structure-of-arrays storage of the UAVs
+#include "FleetManifest.h" // Per-UAV start state loaded from a manifest
+#include "CommandScheduler.h" // Command structure and per-UAV command scheduling
+#include "CommandFile.h" // Fast text and binary command file loading
+#include "CommandStream.h" // Commands received while the simulation runs
+#include "Checkpoint.h" // Checkpoints of the simulation state
+#include "TextTrajectoryWriter.h" // Buffered trajectory output
+#include "BinaryTrajectoryWriter.h" // Memory-mapped binary trajectory output
+#include "CompressedTrajectoryWriter.h" // Delta-encoded compressed trajectory output
+#include "CompressedTrajectoryReader.h" // Decoder of the compressed trajectory output
+#include "TrajectoryIndex.h" // Time index of the trajectory files for random access
+#include "TargetDispatcher.h" // Assignment of the commands addressed to any UAV
+#include "OutputSampler.h" // Output rate decoupled from the physics step
+#include "AsyncTrajectoryWriter.h" // Trajectory output written by a background thread
+#include "TelemetryRecorder.h" // Bounded in-memory history with snapshot dumps
+#include "SeparationMonitor.h" // Online detection of separation violations
+#include "TickEngine.h" // Fixed-step (optionally multithreaded) simulation loop
+#include "Profiler.h" // Optional hot-path counters and phase timers (UAVSIM_PROFILING)
+#include "EventEngine.h" // Event-driven closed-form simulation
+#include "SweepRunner.h" // Many simulation variants in one process
 #include <chrono> // For time measurement
 #include <thread> // For sleep
 #include <algorithm> // For std::sort
 
-// Structure to hold configuration data
-struct Config {
-    double Dt;      // Time step
-    int N_uav;      // Number of UAVs
-    double R;       // Minimum turning radius
-    double X0;      // Initial X coordinate
-    double Y0;      // Initial Y coordinate
-    double Z0;      // Initial Z coordinate
-    double V0;      // Initial velocity
-    double Az;      // Initial azimuth
-    double TimeLim; // Time limit
-};
-
-// Structure to hold command data
-struct Command {
-    double time; // Command execution time
-    int num;     // Number of the UAV
-    double x;    // X coordinate of the new destination
-    double y;    // Y coordinate of the new destination
-};
+// Number of commands printed by printCommands
+const std::size_t printedCommandLimit = 1000;
 
 // Function to get the current directory
 // Retrieves the current directory path.
@@ -41,6 +44,32 @@ struct Command {
 //Function to get the current directory
 std::string getCurrentDirectory();
 
+// Function to resolve an input file name
+// Relative names are resolved against the current directory, absolute paths are kept as they are.
+// Parameters:
+//  - filename: The file name or path given by the user.
+// Returns:
+//  The path of the file to open.
+std::filesystem::path resolveInputPath(const std::string& filename);
+
+// Function to set one configuration parameter
+// Parameters:
+//  - config: Reference to the Config struct to update.
+//  - key: The parameter name, as written in SimParams.ini.
+//  - value: The parameter value.
+// Returns:
+//  True if the key is a known parameter, false otherwise.
+bool setConfigValue(Config& config, const std::string& key, double value);
+
+// Function to set one text configuration parameter
+// Parameters:
+//  - config: Reference to the Config struct to update.
+//  - key: The parameter name, as written in SimParams.ini.
+//  - value: The parameter value.
+// Returns:
+//  True if the key is a known text parameter, false otherwise.
+bool setConfigString(Config& config, const std::string& key, const std::string& value);
+
 // Function to read configuration from file
 // Reads configuration parameters from a file and populates a Config struct.
 // Parameters:
@@ -53,6 +82,7 @@ bool readConfigFromFile(const std::string& filename, Config& config);
 // Function to read commands from file
 // Reads commands from a file and populates a vector with Command structs.
 // Each command is expected to be formatted as: "<time> <num> <x> <y>"
+// Binary command files (see CommandFile.h) are recognized and read as well.
 // Parameters:
 //  - filename: The name of the file containing the commands.
 //  - commands: Reference to a vector to populate with Command structs.
@@ -61,11 +91,14 @@ bool readConfigFromFile(const std::string& filename, Config& config);
 bool readCommandsFromFile(const std::string& filename, std::vector<Command>& commands);
 
 // Function to initialize UAVs
-// Initializes an array of UAVs based on the provided configuration.
+// Initializes the fleet storage based on the provided configuration.
+// With a fleet manifest, every UAV gets its own start state and config.N_uav is set to its row count.
 // Parameters:
 //  - config: The configuration object containing UAV parameters.
-//  - uavs: Reference to a pointer to UAV array. This pointer will be assigned to the newly created array.
-void initializeUAVs(Config& config, UAV*& uavs);
+//  - fleet: Reference to the fleet. It is resized to config.N_uav entries.
+// Returns:
+//  True if the fleet was initialized, false if the fleet manifest could not be loaded.
+bool initializeUAVs(Config& config, UAVFleet& fleet);
 
 // Function to print configuration
 // Prints the configuration parameters to the standard output.
@@ -75,6 +108,7 @@ void printConfiguration(const Config& config);
 
 // Function to print commands
 // Prints the list of commands to the standard output.
+// Long lists are cut after the first printedCommandLimit commands.
 // Parameters:
 //  - commands: The vector of commands to be printe
 void printCommands(const std::vector<Command>& commands);
@@ -82,18 +116,8 @@ void printCommands(const std::vector<Command>& commands);
 // Function to print UAV details
 // Prints details of each UAV to the standard output.
 // Parameters:
-//  - uavs: Pointer to the array of UAVs.
-//  - num_uavs: The number of UAVs in the array.
-void printUAVDetails(UAV* uavs, int num_uavs);
-
-// Writes the current UAV details (time, position, azimuth) to a specified file.
-// Parameters:
-//  - filename: The name of the file to write to.
-//  - currentTime: The current time.
-//  - x: The X coordinate of the UAV.
-//  - y: The Y coordinate of the UAV.
-//  - azimuth: The azimuth angle of the UAV.
-void writeUAVDetailsToFile(const std::string& filename, double currentTime, double x, double y, double azimuth);
+//  - fleet: The fleet whose UAVs are printed.
+void printUAVDetails(UAVFleet& fleet);
 
 #endif // MANAGER_H
 
@@ -0,0 +1,286 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor
+MappedFile::MappedFile() = default;
+
+// Destructor
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+// Creates (or truncates) a file of the given size and maps it for reading and writing.
+bool MappedFile::create(const std::string& filename, std::size_t size) {
+    close();
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to create file: " << filename << std::endl;
+        return false;
+    }
+    fileHandle = file;
+    writable = true;
+    length = size;
+    if (size == 0) {
+        return true;
+    }
+
+    ULARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = size;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, mappingSize.HighPart, mappingSize.LowPart, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    address = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+    if (address == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Maps an existing file for reading.
+bool MappedFile::openReadOnly(const std::string& filename) {
+    close();
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Unable to open file." << std::endl;
+        return false;
+    }
+    fileHandle = file;
+    writable = false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    address = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (address == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Maps an existing file for reading and writing, keeping its content and size.
+bool MappedFile::openReadWrite(const std::string& filename) {
+    close();
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Unable to open file." << std::endl;
+        return false;
+    }
+    fileHandle = file;
+    writable = true;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    address = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (address == nullptr) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Writes dirty pages back to the file.
+void MappedFile::flush() {
+    if (address != nullptr && writable) {
+        FlushViewOfFile(address, 0);
+    }
+}
+
+// Unmaps and closes the file.
+void MappedFile::close() {
+    if (address != nullptr) {
+        UnmapViewOfFile(address);
+        address = nullptr;
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        fileHandle = nullptr;
+    }
+    length = 0;
+}
+
+#else
+
+// Creates (or truncates) a file of the given size and maps it for reading and writing.
+bool MappedFile::create(const std::string& filename, std::size_t size) {
+    close();
+    fileDescriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        std::cerr << "Failed to create file: " << filename << std::endl;
+        return false;
+    }
+    writable = true;
+    if (::ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Failed to allocate file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    length = size;
+    if (size == 0) {
+        return true;
+    }
+
+#ifndef __APPLE__
+    // ftruncate leaves a sparse file: reserve the blocks now, so a full disk fails here
+    // instead of raising SIGBUS on the first write through the mapping.
+    // Filesystems that cannot reserve space keep the sparse file.
+    int reserved = ::posix_fallocate(fileDescriptor, 0, static_cast<off_t>(size));
+    if (reserved != 0 && reserved != EINVAL && reserved != EOPNOTSUPP) {
+        std::cerr << "Failed to allocate file: " << filename << std::endl;
+        close();
+        return false;
+    }
+#endif
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    address = static_cast<char*>(mapping);
+    return true;
+}
+
+// Maps an existing file for reading.
+bool MappedFile::openReadOnly(const std::string& filename) {
+    close();
+    fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::cerr << "Error: Unable to open file." << std::endl;
+        return false;
+    }
+    writable = false;
+
+    struct stat status;
+    if (::fstat(fileDescriptor, &status) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length == 0) {
+        return true;
+    }
+
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    address = static_cast<char*>(mapping);
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+    return true;
+}
+
+// Maps an existing file for reading and writing, keeping its content and size.
+bool MappedFile::openReadWrite(const std::string& filename) {
+    close();
+    fileDescriptor = ::open(filename.c_str(), O_RDWR);
+    if (fileDescriptor < 0) {
+        std::cerr << "Error: Unable to open file." << std::endl;
+        return false;
+    }
+    writable = true;
+
+    struct stat status;
+    if (::fstat(fileDescriptor, &status) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length == 0) {
+        return true;
+    }
+
+    void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << filename << std::endl;
+        close();
+        return false;
+    }
+    address = static_cast<char*>(mapping);
+    return true;
+}
+
+// Writes dirty pages back to the file.
+void MappedFile::flush() {
+    if (address != nullptr && writable) {
+        ::msync(address, length, MS_ASYNC);
+    }
+}
+
+// Unmaps and closes the file.
+void MappedFile::close() {
+    if (address != nullptr) {
+        ::munmap(address, length);
+        address = nullptr;
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+    length = 0;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Memory-mapped file.
+// Wraps CreateFileMapping/MapViewOfFile on Windows and mmap on other platforms.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+    * Creates (or truncates) a file of the given size and maps it for reading and writing.
+    * The disk space is reserved up front where the platform allows it.
+    *
+    * @param filename The name of the file to create.
+    * @param size The size of the file in bytes.
+    * @return True if the file was created and mapped, false otherwise.
+    */
+    bool create(const std::string& filename, std::size_t size);
+
+    /**
+    * Maps an existing file for reading and writing, keeping its content and size.
+    *
+    * @param filename The name of the file to map.
+    * @return True if the file was opened and mapped, false otherwise.
+    */
+    bool openReadWrite(const std::string& filename);
+
+    /**
+    * Maps an existing file for reading.
+    *
+    * @param filename The name of the file to map.
+    * @return True if the file was opened and mapped, false otherwise.
+    */
+    bool openReadOnly(const std::string& filename);
+
+    /**
+    * Writes dirty pages back to the file.
+    */
+    void flush();
+
+    /**
+    * Unmaps and closes the file.
+    */
+    void close();
+
+    char* data() { return address; }
+    const char* data() const { return address; }
+    std::size_t size() const { return length; }
+
+private:
+    char* address = nullptr;
+    std::size_t length = 0;
+    bool writable = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
+
+#endif // MAPPEDFILE_H
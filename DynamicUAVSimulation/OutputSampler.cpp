@@ -0,0 +1,120 @@
+#include "OutputSampler.h"
+
+#include <cmath>
+#include "Checkpoint.h"
+
+namespace {
+    const double pi = 3.14159265358979323846;
+
+    // The engine time is a running sum of Dt and may end slightly short of an output time
+    // (e.g. 19.9999999 instead of 20); such a step still produces the output sample.
+    const double timeTolerance = 1e-6;
+}
+
+// Constructor
+OutputSampler::OutputSampler(const std::vector<TrajectorySink*>& outputs, double interval, const std::vector<int>& decimations)
+    : outputs(outputs), interval(interval), decimations(decimations),
+      previous(decimations.size()), hasPrevious(decimations.size(), 0), nextSamples(decimations.size(), 0) {}
+
+// Forwards the output samples that fall between the previous step and this one.
+void OutputSampler::record(std::size_t index, const TrajectorySample& sample) {
+    std::uint64_t& next = nextSamples[index];
+    double nextTime = static_cast<double>(next) * interval;
+    double lastTime = sample.time + timeTolerance * interval;
+
+    while (nextTime <= lastTime) {
+        if (nextTime >= sample.time || !hasPrevious[index]) {
+            TrajectorySample exact = sample;
+            exact.time = nextTime;
+            emit(index, next, exact);
+        }
+        else {
+            // Linear interpolation between the surrounding steps
+            const TrajectorySample& before = previous[index];
+            double alpha = (nextTime - before.time) / (sample.time - before.time);
+
+            // Turn the short way round when the azimuth wrapped between the two steps
+            double turn = std::remainder(sample.azimuth - before.azimuth, 2 * pi);
+
+            TrajectorySample interpolated;
+            interpolated.time = nextTime;
+            interpolated.x = before.x + alpha * (sample.x - before.x);
+            interpolated.y = before.y + alpha * (sample.y - before.y);
+            interpolated.azimuth = before.azimuth + alpha * turn;
+
+            // Keep the azimuth within [0, 2 * pi) like the kernels do
+            while (interpolated.azimuth < 0)
+                interpolated.azimuth += 2 * pi;
+            while (interpolated.azimuth >= 2 * pi)
+                interpolated.azimuth -= 2 * pi;
+            interpolated.z = before.z + alpha * (sample.z - before.z);
+            interpolated.mode = before.mode;
+            emit(index, next, interpolated);
+        }
+        nextTime = static_cast<double>(++next) * interval;
+    }
+
+    previous[index] = sample;
+    hasPrevious[index] = 1;
+}
+
+// Sends an output sample to the outputs, unless decimated.
+void OutputSampler::emit(std::size_t index, std::uint64_t sampleIndex, const TrajectorySample& sample) {
+    int decimation = decimations[index];
+    if (decimation > 1 && sampleIndex % static_cast<std::uint64_t>(decimation) != 0) {
+        return;
+    }
+    for (TrajectorySink* output : outputs) {
+        output->record(index, sample);
+    }
+}
+
+// Flushes the outputs.
+void OutputSampler::flush() {
+    for (TrajectorySink* output : outputs) {
+        output->flush();
+    }
+}
+
+// Lets the outputs synchronize.
+void OutputSampler::synchronize(double time) {
+    for (TrajectorySink* output : outputs) {
+        output->synchronize(time);
+    }
+}
+
+// Returns the bytes written by the outputs.
+std::uint64_t OutputSampler::bytesWritten() const {
+    std::uint64_t total = 0;
+    for (const TrajectorySink* output : outputs) {
+        total += output->bytesWritten();
+    }
+    return total;
+}
+
+// Saves the resampling state of every UAV, then the state of the outputs.
+void OutputSampler::saveState(StateWriter& state) const {
+    state.writeVector(previous);
+    state.writeVector(hasPrevious);
+    state.writeVector(nextSamples);
+    for (const TrajectorySink* output : outputs) {
+        output->saveState(state);
+    }
+}
+
+// Restores the resampling state of every UAV and the state of the outputs.
+bool OutputSampler::restoreState(StateReader& state) {
+    const std::size_t count = decimations.size();
+    state.readVector(previous);
+    state.readVector(hasPrevious);
+    state.readVector(nextSamples);
+    if (!state.ok() || previous.size() != count || hasPrevious.size() != count || nextSamples.size() != count) {
+        return false;
+    }
+    for (TrajectorySink* output : outputs) {
+        if (!output->restoreState(state)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef OUTPUTSAMPLER_H
+#define OUTPUTSAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TrajectorySink.h"
+
+// Resamples trajectories before they reach the outputs.
+// The engine records every physics step; the sampler forwards one sample every `interval`
+// seconds (at t = k * interval), linearly interpolated between the two surrounding steps,
+// and keeps only every N-th of those samples for UAVs with a decimation factor N.
+class OutputSampler : public TrajectorySink {
+public:
+    /**
+    * @param outputs The sinks receiving the resampled trajectories.
+    * @param interval The time between two output samples, in seconds.
+    * @param decimations The decimation factor of every UAV (1 = keep every output sample).
+    */
+    OutputSampler(const std::vector<TrajectorySink*>& outputs, double interval, const std::vector<int>& decimations);
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+    void flush() override;
+    void synchronize(double time) override;
+    std::uint64_t bytesWritten() const override;
+    void saveState(StateWriter& state) const override;
+    bool restoreState(StateReader& state) override;
+
+private:
+    // Sends output sample number `sampleIndex` of a UAV to the outputs, unless decimated.
+    void emit(std::size_t index, std::uint64_t sampleIndex, const TrajectorySample& sample);
+
+    std::vector<TrajectorySink*> outputs;
+    double interval;
+    std::vector<int> decimations;
+    std::vector<TrajectorySample> previous;   // Last recorded step of every UAV
+    std::vector<std::uint8_t> hasPrevious;
+    std::vector<std::uint64_t> nextSamples;   // Index of the next output sample of every UAV
+};
+
+#endif // OUTPUTSAMPLER_H
@@ -0,0 +1,91 @@
+#include "Pacer.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+    double toMicroseconds(std::int64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+}
+
+// Constructor
+Pacer::Pacer(double factor, double spinTime)
+    : factor(factor > 0.0 ? factor : 0.0),
+      spin(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinTime > 0.0 ? spinTime : 0.0))),
+      origin(Clock::now()), periodStart(origin) {}
+
+// Sets the wall-clock time of the given simulation time to now and clears the statistics.
+void Pacer::start(double simulationTime) {
+    periodStart = Clock::now();
+    origin = periodStart;
+    if (isEnabled()) {
+        origin -= std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(simulationTime / factor));
+    }
+    lastSimulationTime = simulationTime;
+    periods = 0;
+    deadlineMisses = 0;
+    computeTimes = LatencyHistogram();
+    jitter = LatencyHistogram();
+}
+
+// Returns the wall-clock time of a simulation time.
+Pacer::Clock::time_point Pacer::deadlineOf(double simulationTime) const {
+    return origin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(simulationTime / factor));
+}
+
+// Records the compute time of the period ending now and whether it missed its deadline.
+void Pacer::endPeriod(double simulationTime, Clock::time_point now, Clock::time_point deadline) {
+    if (simulationTime > lastSimulationTime) {
+        computeTimes.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - periodStart).count());
+        ++periods;
+        if (now > deadline) {
+            ++deadlineMisses;
+        }
+    }
+    lastSimulationTime = simulationTime;
+}
+
+// Waits until the wall clock reaches the given simulation time.
+void Pacer::waitUntil(double simulationTime) {
+    if (!isEnabled()) {
+        return;
+    }
+    Clock::time_point deadline = deadlineOf(simulationTime);
+    Clock::time_point now = Clock::now();
+    endPeriod(simulationTime, now, deadline);
+
+    // Coarse sleep, then spin up to the deadline
+    if (deadline - now > spin) {
+        std::this_thread::sleep_until(deadline - spin);
+    }
+    do {
+        now = Clock::now();
+    } while (now < deadline);
+
+    periodStart = now;
+    jitter.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+}
+
+// Ends the last period at the end of the run, without waiting.
+void Pacer::finish(double simulationTime) {
+    if (isEnabled()) {
+        endPeriod(simulationTime, Clock::now(), deadlineOf(simulationTime));
+    }
+}
+
+// Prints the period count, the deadline misses and the compute time and jitter percentiles.
+void Pacer::printStatistics() const {
+    if (!isEnabled()) {
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Real-time periods: " << periods << ", deadline misses: " << deadlineMisses << std::endl;
+    std::cout << "Compute time (us): p50 " << toMicroseconds(computeTimes.percentile(0.5))
+        << ", p99 " << toMicroseconds(computeTimes.percentile(0.99))
+        << ", max " << toMicroseconds(computeTimes.max()) << std::endl;
+    std::cout << "Wake-up jitter (us): p50 " << toMicroseconds(jitter.percentile(0.5))
+        << ", p99 " << toMicroseconds(jitter.percentile(0.99))
+        << ", max " << toMicroseconds(jitter.max()) << std::endl;
+}
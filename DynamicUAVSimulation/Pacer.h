@@ -0,0 +1,77 @@
+#pragma once
+#ifndef PACER_H
+#define PACER_H
+
+#include <chrono>
+#include <cstdint>
+#include "LatencyHistogram.h"
+
+// Paces a simulation to the wall clock.
+// With a factor of 1 one simulated second takes one wall-clock second, with a factor of 10 it
+// takes a tenth of a second; a factor of 0 disables pacing (as fast as possible).
+//
+// Each period starts at a deadline computed from the simulation time, so errors do not accumulate.
+// The pacer sleeps until shortly before the deadline and spins for the rest, since sleeps
+// typically overshoot by tens of microseconds to milliseconds. It measures the compute time of every
+// period, the wake-up jitter (how late the period starts) and counts the deadline misses
+// (periods whose computation ended after the start of the next period).
+class Pacer {
+public:
+    /**
+    * @param factor Simulation seconds per wall-clock second (0 = no pacing).
+    * @param spinTime Wall-clock seconds spent spinning before each deadline instead of sleeping.
+    */
+    Pacer(double factor, double spinTime);
+
+    /**
+    * Sets the wall-clock time of the given simulation time to now and clears the statistics.
+    *
+    * @param simulationTime The simulation time the run starts (or resumes) at.
+    */
+    void start(double simulationTime);
+
+    /**
+    * Waits until the wall clock reaches the given simulation time.
+    * Returns immediately when the simulation is late (a deadline miss) or pacing is disabled.
+    *
+    * @param simulationTime The simulation time about to be computed.
+    */
+    void waitUntil(double simulationTime);
+
+    /**
+    * Ends the last period at the end of the run, without waiting.
+    *
+    * @param simulationTime The simulation time the run stopped at.
+    */
+    void finish(double simulationTime);
+
+    /**
+    * Prints the period count, the deadline misses and the compute time and jitter percentiles.
+    */
+    void printStatistics() const;
+
+    bool isEnabled() const { return factor > 0.0; }
+    std::uint64_t getPeriodCount() const { return periods; }
+    std::uint64_t getDeadlineMisses() const { return deadlineMisses; }
+    const LatencyHistogram& getComputeTimes() const { return computeTimes; }
+    const LatencyHistogram& getJitter() const { return jitter; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Records the compute time of the period ending now and whether it missed its deadline.
+    void endPeriod(double simulationTime, Clock::time_point now, Clock::time_point deadline);
+    Clock::time_point deadlineOf(double simulationTime) const;
+
+    double factor;
+    Clock::duration spin;
+    Clock::time_point origin;
+    Clock::time_point periodStart; // Wall-clock time the current period started computing
+    double lastSimulationTime = 0.0;
+    std::uint64_t periods = 0;
+    std::uint64_t deadlineMisses = 0;
+    LatencyHistogram computeTimes;
+    LatencyHistogram jitter;
+};
+
+#endif // PACER_H
@@ -0,0 +1,212 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Spans kept per thread; later spans of a long run are dropped
+    const std::size_t maxTraceEventsPerThread = 1 << 20;
+
+    const char* const counterNames[Profiler::CounterCount] = {
+        "NavigateStandby", "NavigateInsideArrive", "NavigateInsideStraight", "NavigateOvershoot",
+        "NavigateApproach", "CruiseUpdates", "LoiterFastPathSteps", "KinematicsUpdates", "CommandActivations",
+        "OutputBytes", "OutputWriteCalls", "OutputFileOpens", "OutputSyncCalls", "OutputDroppedSamples",
+        "CheckpointBytes"
+    };
+
+    const char* const phaseNames[Profiler::PhaseCount] = {
+        "Tick", "Record", "Navigate", "Cruise", "Kinematics", "Evaluate", "Synchronize", "Commands", "Pacing",
+        "Checkpoint", "Flush", "Write", "Backpressure", "Assignment"
+    };
+
+    struct TraceEvent {
+        std::uint64_t startNs;
+        std::uint64_t durationNs;
+        Profiler::Phase phase;
+    };
+
+    // Counters of one thread; only that thread writes them
+    struct ThreadProfile {
+        std::size_t id = 0;
+        std::uint64_t counters[Profiler::CounterCount] = {};
+        std::uint64_t phaseNs[Profiler::PhaseCount] = {};
+        std::uint64_t phaseCalls[Profiler::PhaseCount] = {};
+        std::vector<TraceEvent> events;
+    };
+
+    // Profiles of every thread that ever counted something. They outlive their threads (the
+    // thread pools are gone when the report is written).
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadProfile>> profiles;
+        std::vector<std::uint64_t> standbyTicks;
+        std::atomic<bool> tracing{ false };
+        std::atomic<std::uint64_t> syncCount{ 0 };
+        int traceEvery = 0;
+        std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local ThreadProfile* currentProfile = nullptr;
+
+    ThreadProfile& threadProfile() {
+        if (currentProfile == nullptr) {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.profiles.emplace_back(new ThreadProfile());
+            currentProfile = shared.profiles.back().get();
+            currentProfile->id = shared.profiles.size();
+        }
+        return *currentProfile;
+    }
+
+    std::uint64_t nanoseconds(std::chrono::steady_clock::duration duration) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+}
+
+namespace Profiler {
+    // Prepares a run.
+    void configure(std::size_t fleetSize, int traceEvery) {
+        threadProfile(); // The configuring thread is listed first in the trace
+        Registry& shared = registry();
+        shared.standbyTicks.assign(fleetSize, 0);
+        shared.traceEvery = traceEvery;
+    }
+
+    // Adds to a counter of the calling thread.
+    void count(Counter counter, std::uint64_t amount) {
+        threadProfile().counters[counter] += amount;
+    }
+
+    // Adds the number of flagged UAVs in [begin, end) to a counter.
+    void countFlags(Counter counter, const std::uint8_t* flags, std::size_t begin, std::size_t end) {
+        std::uint64_t flagged = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            flagged += flags[i] != 0;
+        }
+        threadProfile().counters[counter] += flagged;
+    }
+
+    // Counts a standby tick for every flagged UAV in [begin, end).
+    void countStandbyTicks(const std::uint8_t* standbyFlags, std::size_t begin, std::size_t end) {
+        std::vector<std::uint64_t>& ticks = registry().standbyTicks;
+        end = std::min(end, ticks.size());
+        for (std::size_t i = begin; i < end; ++i) {
+            ticks[i] += standbyFlags[i] != 0;
+        }
+    }
+
+    // Marks the start of a synchronization.
+    void beginSync() {
+        Registry& shared = registry();
+        std::uint64_t index = shared.syncCount.fetch_add(1, std::memory_order_relaxed);
+        bool traced = shared.traceEvery > 0 && index % static_cast<std::uint64_t>(shared.traceEvery) == 0;
+        shared.tracing.store(traced, std::memory_order_relaxed);
+    }
+
+    // Adds the duration of a phase to the calling thread.
+    void addPhase(Phase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+        ThreadProfile& profile = threadProfile();
+        std::uint64_t duration = nanoseconds(end - start);
+        profile.phaseNs[phase] += duration;
+        ++profile.phaseCalls[phase];
+        Registry& shared = registry();
+        if (shared.tracing.load(std::memory_order_relaxed) && profile.events.size() < maxTraceEventsPerThread) {
+            profile.events.push_back({ nanoseconds(start - shared.origin), duration, phase });
+        }
+    }
+
+    // Writes the report.
+    void writeReport(std::ostream& out, bool perUav) {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        std::uint64_t counters[CounterCount] = {};
+        std::uint64_t phaseNs[PhaseCount] = {};
+        std::uint64_t phaseCalls[PhaseCount] = {};
+        for (const auto& profile : shared.profiles) {
+            for (int i = 0; i < CounterCount; ++i) {
+                counters[i] += profile->counters[i];
+            }
+            for (int i = 0; i < PhaseCount; ++i) {
+                phaseNs[i] += profile->phaseNs[i];
+                phaseCalls[i] += profile->phaseCalls[i];
+            }
+        }
+
+        out << "\nProfile (" << shared.profiles.size() << " threads; phase times add up all threads):" << std::endl;
+        out << std::left << std::setw(14) << "Phase" << std::right << std::setw(14) << "Calls"
+            << std::setw(14) << "Total ms" << std::setw(14) << "Mean us" << std::endl;
+        for (int i = 0; i < PhaseCount; ++i) {
+            if (phaseCalls[i] == 0) {
+                continue;
+            }
+            out << std::left << std::setw(14) << phaseNames[i] << std::right << std::setw(14) << phaseCalls[i]
+                << std::setw(14) << std::fixed << std::setprecision(3) << phaseNs[i] / 1e6
+                << std::setw(14) << phaseNs[i] / 1e3 / static_cast<double>(phaseCalls[i]) << std::endl;
+        }
+        for (int i = 0; i < CounterCount; ++i) {
+            out << counterNames[i] << ": " << counters[i] << std::endl;
+        }
+
+        const std::vector<std::uint64_t>& ticks = shared.standbyTicks;
+        std::uint64_t total = 0;
+        std::size_t loitering = 0;
+        std::size_t busiest = 0;
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            total += ticks[i];
+            loitering += ticks[i] > 0;
+            busiest = ticks[i] > ticks[busiest] ? i : busiest;
+        }
+        if (!ticks.empty()) {
+            out << "StandbyTicks: " << total << " (" << loitering << " of " << ticks.size() << " UAVs, at most "
+                << ticks[busiest] << " for UAV" << busiest + 1 << ")" << std::endl;
+        }
+        if (perUav) {
+            for (std::size_t i = 0; i < ticks.size(); ++i) {
+                out << "StandbyTicks UAV" << i + 1 << ": " << ticks[i] << "\n";
+            }
+        }
+        out.flush();
+    }
+
+    // Writes the traced spans as Chrome trace JSON.
+    bool writeTrace(const std::string& filename) {
+        std::ofstream file(filename, std::ios_base::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        for (const auto& profile : shared.profiles) {
+            std::string name = profile->id == 1 ? "main" : "thread " + std::to_string(profile->id);
+            file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+                << profile->id << ", \"args\": {\"name\": \"" << name << "\"}}";
+            first = false;
+            for (const TraceEvent& event : profile->events) {
+                file << ",\n{\"name\": \"" << phaseNames[event.phase] << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                    << profile->id << ", \"ts\": " << event.startNs / 1e3 << ", \"dur\": " << event.durationNs / 1e3 << "}";
+            }
+        }
+        file << "\n]}\n";
+        if (!file) {
+            std::cerr << "Failed to write profile trace: " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Built-in instrumentation of the simulation loop, compiled in with the UAVSIM_PROFILING CMake
+// option (which defines UAVSIM_PROFILING=1). In a normal build every UAVSIM_* macro below expands
+// to nothing, so the hot paths carry no trace of it.
+//
+// - Counters (navigation branches, command activations, output bytes and system calls) and phase
+//   timers are kept per thread, without any atomic operation or lock on the hot path; the report
+//   adds up the threads.
+// - The ticks every UAV spends in standby mode are counted per UAV (each UAV is only ever moved
+//   by one thread at a time).
+// - Every ProfileTraceEvery-th synchronization, the phase timers also record their spans, which
+//   are written as a Chrome trace (chrome://tracing or https://ui.perfetto.dev).
+namespace Profiler {
+    enum Counter {
+        NavigateStandby,       // navigateToTarget: circling around the destination
+        NavigateInsideArrive,  // navigateToTarget: inside the radius, reaches the circle during the step
+        NavigateInsideStraight,// navigateToTarget: inside the radius, straight flight
+        NavigateOvershoot,     // navigateToTarget: reaches or passes the circle during the step
+        NavigateApproach,      // navigateToTarget: straight flight towards the destination
+        CruiseUpdates,         // UAVs flying straight without any command
+        LoiterFastPathSteps,   // Loitering steps done by incremental rotation
+        KinematicsUpdates,     // UAV steps of the 3D motion model
+        CommandActivations,    // Commands that became the active command of their UAV
+        OutputBytes,           // Bytes of trajectory output (text and binary)
+        OutputWriteCalls,      // Writes of buffered text output to a file
+        OutputFileOpens,       // Opens of output files after the start (out of file descriptors)
+        OutputSyncCalls,       // Requests to write the mapped binary output back
+        OutputDroppedSamples,  // Samples dropped by the asynchronous output (all buffers busy)
+        CheckpointBytes,       // Bytes of checkpoint files written
+        CounterCount
+    };
+
+    enum Phase {
+        PhaseTick,       // One synchronization of the engine: the ticks run by all threads
+        PhaseRecord,     // Recording the samples of a range in the trajectory outputs
+        PhaseNavigate,   // Command scanning and navigation of a range (planar model)
+        PhaseCruise,     // Straight flight of the UAVs without command (planar model)
+        PhaseKinematics, // 3D motion model of a range
+        PhaseEvaluate,   // Event engine: segments and evaluation of a range
+        PhaseSynchronize,// Synchronization of the outputs
+        PhaseCommands,   // Draining the command stream
+        PhasePacing,     // Waiting for the wall clock (real time)
+        PhaseCheckpoint, // Saving the state of a checkpoint
+        PhaseFlush,      // Final flush of the outputs
+        PhaseWrite,      // Asynchronous output: the writer thread passing a buffer to the outputs
+        PhaseBackpressure,// Asynchronous output: the engine waiting for a free buffer
+        PhaseAssignment, // Assigning the released targets to the free UAVs
+        PhaseCount
+    };
+
+    // True when the instrumentation is compiled in
+#if defined(UAVSIM_PROFILING) && UAVSIM_PROFILING
+    const bool enabled = true;
+#else
+    const bool enabled = false;
+#endif
+
+    /**
+    * Prepares a run: sizes the per-UAV standby counters and sets the trace sampling.
+    *
+    * @param fleetSize The number of UAVs (0 = no per-UAV counters, e.g. for sweeps).
+    * @param traceEvery Synchronizations between two traced ones (0 = no trace).
+    */
+    void configure(std::size_t fleetSize, int traceEvery);
+
+    /**
+    * Adds to a counter of the calling thread.
+    */
+    void count(Counter counter, std::uint64_t amount = 1);
+
+    /**
+    * Adds the number of UAVs in [begin, end) whose flag is set to a counter of the calling thread.
+    */
+    void countFlags(Counter counter, const std::uint8_t* flags, std::size_t begin, std::size_t end);
+
+    /**
+    * Counts a standby tick for every UAV in [begin, end) whose flag is set.
+    */
+    void countStandbyTicks(const std::uint8_t* standbyFlags, std::size_t begin, std::size_t end);
+
+    /**
+    * Marks the start of a synchronization; decides whether its spans are traced.
+    */
+    void beginSync();
+
+    /**
+    * Adds the duration of a phase to the calling thread and traces it in sampled synchronizations.
+    */
+    void addPhase(Phase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    /**
+    * Writes the report: counters, phase times and standby ticks.
+    *
+    * @param out The stream to write to.
+    * @param perUav Also list the standby ticks of every UAV.
+    */
+    void writeReport(std::ostream& out, bool perUav);
+
+    /**
+    * Writes the traced spans as Chrome trace JSON.
+    *
+    * @param filename The file to create.
+    * @return True if the file was written, false otherwise.
+    */
+    bool writeTrace(const std::string& filename);
+
+    // Times the enclosing scope as one phase
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() { addPhase(phase, start, std::chrono::steady_clock::now()); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+#if defined(UAVSIM_PROFILING) && UAVSIM_PROFILING
+#define UAVSIM_PROFILE_CONCAT_(a, b) a##b
+#define UAVSIM_PROFILE_CONCAT(a, b) UAVSIM_PROFILE_CONCAT_(a, b)
+#define UAVSIM_PROFILE_SCOPE(phase) Profiler::ScopedTimer UAVSIM_PROFILE_CONCAT(profileTimer, __LINE__)(Profiler::phase)
+#define UAVSIM_PROFILE_COUNT(counter) Profiler::count(Profiler::counter)
+#define UAVSIM_PROFILE_COUNT_N(counter, amount) Profiler::count(Profiler::counter, (amount))
+#define UAVSIM_PROFILE_COUNT_FLAGS(counter, flags, begin, end) Profiler::countFlags(Profiler::counter, (flags), (begin), (end))
+#define UAVSIM_PROFILE_STANDBY(flags, begin, end) Profiler::countStandbyTicks((flags), (begin), (end))
+#define UAVSIM_PROFILE_SYNC() Profiler::beginSync()
+#else
+#define UAVSIM_PROFILE_SCOPE(phase) ((void)0)
+#define UAVSIM_PROFILE_COUNT(counter) ((void)0)
+#define UAVSIM_PROFILE_COUNT_N(counter, amount) ((void)0)
+#define UAVSIM_PROFILE_COUNT_FLAGS(counter, flags, begin, end) ((void)0)
+#define UAVSIM_PROFILE_STANDBY(flags, begin, end) ((void)0)
+#define UAVSIM_PROFILE_SYNC() ((void)0)
+#endif
+
+#endif // PROFILER_H
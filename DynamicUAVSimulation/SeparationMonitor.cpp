@@ -0,0 +1,234 @@
+#include "SeparationMonitor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include "Checkpoint.h"
+#include "TelemetryRecorder.h"
+
+// Constructor
+SeparationMonitor::SeparationMonitor(const std::vector<int>& nums, double distance, double checkInterval)
+    : nums(nums), distance(distance), checkInterval(checkInterval),
+      xs(nums.size(), 0.0), ys(nums.size(), 0.0), zs(nums.size(), 0.0),
+      startXs(nums.size(), 0.0), startYs(nums.size(), 0.0), startZs(nums.size(), 0.0),
+      recorded(nums.size(), 0), cruising(nums.size(), 0), grid(distance) {
+    grid.resize(nums.size());
+}
+
+// Destructor
+SeparationMonitor::~SeparationMonitor() {
+    flush();
+}
+
+// Creates (or truncates) the event log.
+bool SeparationMonitor::open(const std::string& filename, bool append) {
+    this->filename = filename;
+    file.open(filename, (append ? std::ios_base::app : std::ios_base::trunc) | std::ios_base::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Keeps the latest position of the UAV (and the first one as its start position).
+void SeparationMonitor::record(std::size_t index, const TrajectorySample& sample) {
+    xs[index] = sample.x;
+    ys[index] = sample.y;
+    zs[index] = sample.z;
+    if (!recorded[index]) {
+        startXs[index] = sample.x;
+        startYs[index] = sample.y;
+        startZs[index] = sample.z;
+        recorded[index] = 1;
+    }
+    cruising[index] = (sample.mode & TrajectorySample::Cruising) ? 1 : 0;
+}
+
+// Returns true if both UAVs still cruise from the same start position.
+bool SeparationMonitor::inFormation(std::size_t i, std::size_t j) const {
+    return cruising[i] && cruising[j] && startXs[i] == startXs[j] && startYs[i] == startYs[j] &&
+        startZs[i] == startZs[j];
+}
+
+// Writes the buffered events to the log.
+void SeparationMonitor::flush() {
+    if (buffer.empty() || !file.is_open()) {
+        return;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    logBytes += buffer.size();
+    buffer.clear();
+}
+
+// Checks the separation when the check interval has elapsed.
+void SeparationMonitor::synchronize(double time) {
+    if (time + 1e-9 < nextCheckTime) {
+        return;
+    }
+    check(time);
+    nextCheckTime = time + checkInterval;
+}
+
+// Updates the grid and logs the violations that started or ended since the previous check.
+void SeparationMonitor::check(double time) {
+    ++checkCount;
+    for (std::size_t i = 0; i < nums.size(); ++i) {
+        if (recorded[i]) {
+            grid.update(i, xs[i], ys[i], zs[i]);
+        }
+        else {
+            grid.remove(i);
+        }
+    }
+
+    events.clear();
+    grid.forEachPairWithin(distance, [&](std::size_t i, std::size_t j, double pairDistance) {
+        if (inFormation(i, j)) {
+            return;
+        }
+        std::uint64_t pair = (static_cast<std::uint64_t>(i) << 32) | static_cast<std::uint64_t>(j);
+        auto found = violations.find(pair);
+        if (found == violations.end()) {
+            violations.emplace(pair, Violation{ pairDistance, checkCount });
+            events.emplace_back(pair, pairDistance);
+        }
+        else {
+            found->second.lastSeen = checkCount;
+            if (pairDistance < found->second.minDistance) {
+                found->second.minDistance = pairDistance;
+            }
+        }
+    });
+    bool started = !events.empty();
+    logEvents(time, "start", events);
+
+    for (auto it = violations.begin(); it != violations.end();) {
+        if (it->second.lastSeen != checkCount) {
+            events.emplace_back(it->first, it->second.minDistance);
+            it = violations.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    logEvents(time, "end", events);
+
+    if (started && recorder != nullptr) {
+        recorder->trigger(time);
+    }
+    if (buffer.size() >= 65536) {
+        flush();
+    }
+}
+
+// Appends one event line to the log buffer.
+void SeparationMonitor::logEvent(double time, const char* event, std::uint64_t pair, double pairDistance) {
+    std::size_t i = static_cast<std::size_t>(pair >> 32);
+    std::size_t j = static_cast<std::size_t>(pair & 0xFFFFFFFFu);
+    char line[128];
+    int length = std::snprintf(line, sizeof(line), "%.2f %s %d %d %.2f\n", time, event, nums[i], nums[j], pairDistance);
+    if (length > 0 && static_cast<std::size_t>(length) < sizeof(line)) {
+        buffer.append(line, static_cast<std::size_t>(length));
+    }
+    ++eventCount;
+}
+
+// Logs a list of events in pair order (the grid visits the pairs in hash order) and clears it.
+void SeparationMonitor::logEvents(double time, const char* event, std::vector<std::pair<std::uint64_t, double>>& list) {
+    std::sort(list.begin(), list.end());
+    for (const auto& entry : list) {
+        logEvent(time, event, entry.first, entry.second);
+    }
+    list.clear();
+}
+
+// Saves the latest positions, the open violations and the length of the log.
+void SeparationMonitor::saveState(StateWriter& state) const {
+    state.write(nextCheckTime);
+    state.write(checkCount);
+    state.write(eventCount);
+    state.writeVector(xs);
+    state.writeVector(ys);
+    state.writeVector(zs);
+    state.writeVector(startXs);
+    state.writeVector(startYs);
+    state.writeVector(startZs);
+    state.writeVector(recorded);
+    state.writeVector(cruising);
+    std::vector<std::uint64_t> pairs;
+    for (const auto& violation : violations) {
+        pairs.push_back(violation.first);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<Violation> open;
+    for (std::uint64_t pair : pairs) {
+        open.push_back(violations.at(pair));
+    }
+    state.writeVector(pairs);
+    state.writeVector(open);
+    state.write(logBytes);
+    state.writeString(buffer);
+}
+
+// Restores the monitor and cuts the log back to its length at the checkpoint.
+// The grid is rebuilt from the restored positions at the next check.
+bool SeparationMonitor::restoreState(StateReader& state) {
+    std::vector<std::uint64_t> pairs;
+    std::vector<Violation> open;
+    state.read(nextCheckTime);
+    state.read(checkCount);
+    state.read(eventCount);
+    state.readVector(xs);
+    state.readVector(ys);
+    state.readVector(zs);
+    state.readVector(startXs);
+    state.readVector(startYs);
+    state.readVector(startZs);
+    state.readVector(recorded);
+    state.readVector(cruising);
+    state.readVector(pairs);
+    state.readVector(open);
+    state.read(logBytes);
+    state.readString(buffer);
+    if (!state.ok() || xs.size() != nums.size() || ys.size() != nums.size() || zs.size() != nums.size() ||
+        startXs.size() != nums.size() || startYs.size() != nums.size() || startZs.size() != nums.size() ||
+        recorded.size() != nums.size() || cruising.size() != nums.size() || pairs.size() != open.size()) {
+        return false;
+    }
+    violations.clear();
+    for (std::size_t k = 0; k < pairs.size(); ++k) {
+        violations.emplace(pairs[k], open[k]);
+    }
+
+    if (file.is_open()) {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(filename, error);
+        if (error || size < logBytes) {
+            std::cerr << "Error: " << filename << " is shorter than at the checkpoint" << std::endl;
+            return false;
+        }
+        std::filesystem::resize_file(filename, logBytes, error);
+        if (error) {
+            std::cerr << "Failed to truncate file: " << filename << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Logs the end of the violations still open and closes the log.
+void SeparationMonitor::close(double time) {
+    events.clear();
+    for (const auto& violation : violations) {
+        events.emplace_back(violation.first, violation.second.minDistance);
+    }
+    logEvents(time, "end", events);
+    violations.clear();
+    flush();
+    if (file.is_open()) {
+        file.close();
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef SEPARATIONMONITOR_H
+#define SEPARATIONMONITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SpatialGrid.h"
+#include "TrajectorySink.h"
+
+class TelemetryRecorder;
+
+// Detects separation violations while the simulation runs, between any two UAVs.
+// Two UAVs that started from the same position (the common start point of SimParams.ini) and have
+// not received a command yet fly in formation; their pair is only checked once one of them has
+// received a command.
+// The monitor records the latest position of every UAV; at the synchronization points of the
+// engine it updates a SpatialGrid (cell size = separation distance) and looks for the pairs closer
+// than the separation distance. A "start" line is logged when a pair gets too close and an "end"
+// line, with the smallest distance reached, when it separates again:
+//
+//   <time> start <numA> <numB> <distance>
+//   <time> end <numA> <numB> <minimum distance>
+class SeparationMonitor : public TrajectorySink {
+public:
+    /**
+    * @param nums The UAV numbers, indexed by UAV index (written in the log).
+    * @param distance The minimum allowed distance between two UAVs.
+    * @param checkInterval The simulation time between two checks (0 = at every synchronization point).
+    */
+    SeparationMonitor(const std::vector<int>& nums, double distance, double checkInterval);
+    ~SeparationMonitor() override;
+
+    SeparationMonitor(const SeparationMonitor&) = delete;
+    SeparationMonitor& operator=(const SeparationMonitor&) = delete;
+
+    /**
+    * Creates (or truncates) the event log.
+    *
+    * @param append Keep the existing events (to resume from a checkpoint).
+    * @return True if the file was created, false otherwise.
+    */
+    bool open(const std::string& filename, bool append = false);
+
+    /**
+    * Requests a recorder dump whenever a new violation starts.
+    */
+    void setRecorder(TelemetryRecorder* recorder) { this->recorder = recorder; }
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+    void flush() override;
+    void synchronize(double time) override;
+    std::uint64_t bytesWritten() const override { return logBytes; }
+    void saveState(StateWriter& state) const override;
+    bool restoreState(StateReader& state) override;
+
+    /**
+    * Logs the end of the violations still open and closes the log.
+    *
+    * @param time The simulation time at the end of the run.
+    */
+    void close(double time);
+
+    std::uint64_t getEventCount() const { return eventCount; }
+
+    const SpatialGrid& getGrid() const { return grid; }
+
+private:
+    struct Violation {
+        double minDistance;
+        std::uint64_t lastSeen; // Check number of the last check that found the pair
+    };
+
+    void check(double time);
+    bool inFormation(std::size_t i, std::size_t j) const;
+    void logEvent(double time, const char* event, std::uint64_t pair, double distance);
+    void logEvents(double time, const char* event, std::vector<std::pair<std::uint64_t, double>>& list);
+
+    std::vector<int> nums;
+    double distance;
+    double checkInterval;
+    double nextCheckTime = 0.0;
+    std::uint64_t checkCount = 0;
+    std::vector<double> xs, ys, zs;     // Latest recorded positions
+    std::vector<double> startXs, startYs, startZs; // First recorded positions
+    std::vector<std::uint8_t> recorded; // 1 once the UAV has been recorded
+    std::vector<std::uint8_t> cruising; // 1 while the UAV has not received a command
+    SpatialGrid grid;
+    std::unordered_map<std::uint64_t, Violation> violations; // Open violations by pair (i << 32 | j)
+    std::vector<std::pair<std::uint64_t, double>> events; // Scratch list of the events of a check
+    std::string filename;
+    std::ofstream file;
+    std::string buffer;
+    std::uint64_t logBytes = 0;
+    std::uint64_t eventCount = 0;
+    TelemetryRecorder* recorder = nullptr;
+};
+
+#endif // SEPARATIONMONITOR_H
@@ -0,0 +1,159 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Cell coordinates are clamped so extreme or non-finite positions still get a cell
+    const double maxCell = static_cast<double>(std::numeric_limits<std::int32_t>::max() - 64);
+}
+
+// Constructor
+SpatialGrid::SpatialGrid(double cellSize) : cellSize(cellSize > 0.0 ? cellSize : 1.0) {}
+
+// Changes the number of indexed UAVs.
+void SpatialGrid::resize(std::size_t count) {
+    for (std::size_t i = count; i < cells.size(); ++i) {
+        if (inGrid[i]) {
+            unlink(i);
+        }
+    }
+    cells.resize(count, 0);
+    next.resize(count, none);
+    prev.resize(count, none);
+    inGrid.resize(count, 0);
+    xs.resize(count, 0.0);
+    ys.resize(count, 0.0);
+    zs.resize(count, 0.0);
+}
+
+std::uint64_t SpatialGrid::packKey(std::int32_t cx, std::int32_t cy) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+}
+
+// Returns the key of the cell holding the given position.
+std::uint64_t SpatialGrid::cellKey(double x, double y) const {
+    double cx = std::floor(x / cellSize);
+    double cy = std::floor(y / cellSize);
+    cx = std::isnan(cx) ? maxCell : std::clamp(cx, -maxCell, maxCell);
+    cy = std::isnan(cy) ? maxCell : std::clamp(cy, -maxCell, maxCell);
+    return packKey(static_cast<std::int32_t>(cx), static_cast<std::int32_t>(cy));
+}
+
+// Returns the number of cells to look at on each side for the given distance (maxReach + 1 if
+// the distance is beyond the largest stencil).
+int SpatialGrid::reachFor(double distance) const {
+    double cellsAway = std::ceil(distance / cellSize);
+    if (!(cellsAway <= maxReach)) {
+        return maxReach + 1;
+    }
+    return cellsAway < 1.0 ? 1 : static_cast<int>(cellsAway);
+}
+
+// Removes a UAV from the list of its cell.
+void SpatialGrid::unlink(std::size_t index) {
+    std::uint32_t before = prev[index];
+    std::uint32_t after = next[index];
+    if (before == none) {
+        if (after == none) {
+            heads.erase(cells[index]);
+        }
+        else {
+            heads[cells[index]] = after;
+        }
+    }
+    else {
+        next[before] = after;
+    }
+    if (after != none) {
+        prev[after] = before;
+    }
+    next[index] = none;
+    prev[index] = none;
+    inGrid[index] = 0;
+}
+
+// Adds a UAV at the front of the list of a cell.
+void SpatialGrid::link(std::size_t index, std::uint64_t key) {
+    auto inserted = heads.emplace(key, static_cast<std::uint32_t>(index));
+    if (!inserted.second) {
+        std::uint32_t first = inserted.first->second;
+        prev[first] = static_cast<std::uint32_t>(index);
+        next[index] = first;
+        inserted.first->second = static_cast<std::uint32_t>(index);
+    }
+    prev[index] = none;
+    cells[index] = key;
+    inGrid[index] = 1;
+}
+
+// Inserts a UAV, or moves it to its new position.
+void SpatialGrid::update(std::size_t index, double x, double y, double z) {
+    xs[index] = x;
+    ys[index] = y;
+    zs[index] = z;
+    std::uint64_t key = cellKey(x, y);
+    if (inGrid[index]) {
+        if (cells[index] == key) {
+            return; // Still in the same cell, nothing to relink
+        }
+        unlink(index);
+    }
+    link(index, key);
+}
+
+// Removes a UAV from the grid.
+void SpatialGrid::remove(std::size_t index) {
+    if (inGrid[index]) {
+        unlink(index);
+    }
+}
+
+// Finds the UAVs closer than `distance` to UAV `index`.
+void SpatialGrid::neighbors(std::size_t index, double distance, std::vector<std::size_t>& result) const {
+    result.clear();
+    if (!inGrid[index]) {
+        return;
+    }
+    within(xs[index], ys[index], zs[index], distance, result);
+    auto self = std::find(result.begin(), result.end(), index);
+    if (self != result.end()) {
+        result.erase(self);
+    }
+}
+
+// Finds the UAVs closer than `distance` to a position.
+void SpatialGrid::within(double x, double y, double z, double distance, std::vector<std::size_t>& result) const {
+    result.clear();
+    const double limit = distance * distance;
+    const int reach = reachFor(distance);
+    auto collect = [&](std::uint32_t first) {
+        for (std::uint32_t j = first; j != none; j = next[j]) {
+            double ddx = x - xs[j];
+            double ddy = y - ys[j];
+            double ddz = z - zs[j];
+            if (ddx * ddx + ddy * ddy + ddz * ddz < limit) {
+                result.push_back(j);
+            }
+        }
+    };
+    if (reach > maxReach) {
+        for (const auto& cell : heads) {
+            collect(cell.second);
+        }
+        return;
+    }
+
+    std::uint64_t key = cellKey(x, y);
+    std::int32_t cx = cellX(key);
+    std::int32_t cy = cellY(key);
+
+    for (int dx = -reach; dx <= reach; ++dx) {
+        for (int dy = -reach; dy <= reach; ++dy) {
+            auto cell = heads.find(packKey(cx + dx, cy + dy));
+            if (cell != heads.end()) {
+                collect(cell->second);
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over the horizontal plane, stored as a hash of the occupied cells.
+// Every UAV belongs to one cell; the UAVs of a cell form an intrusive doubly linked list, so
+// moving a UAV to another cell is O(1) and updating a UAV that stays in its cell only stores
+// its new position. Queries look at the cells within reach of the query distance only, up to
+// maxReach cells on each side; for longer distances they scan every occupied cell.
+class SpatialGrid {
+public:
+    /**
+    * @param cellSize The side of a cell. Queries are cheapest for distances up to the cell size.
+    */
+    explicit SpatialGrid(double cellSize);
+
+    /**
+    * Changes the number of indexed UAVs. New UAVs are not in the grid until their first update.
+    */
+    void resize(std::size_t count);
+
+    std::size_t size() const { return cells.size(); }
+    double getCellSize() const { return cellSize; }
+
+    /**
+    * Inserts a UAV, or moves it to its new position.
+    *
+    * @param index The zero-based index of the UAV.
+    */
+    void update(std::size_t index, double x, double y, double z);
+
+    /**
+    * Removes a UAV from the grid (no-op if it is not in the grid).
+    */
+    void remove(std::size_t index);
+
+    /**
+    * Finds the UAVs closer than `distance` to UAV `index` (3D distance, the UAV itself excluded).
+    *
+    * @param result Receives the indices of the neighbors (cleared first).
+    */
+    void neighbors(std::size_t index, double distance, std::vector<std::size_t>& result) const;
+
+    /**
+    * Finds the UAVs closer than `distance` to a position (3D distance).
+    *
+    * @param result Receives the indices of the UAVs (cleared first).
+    */
+    void within(double x, double y, double z, double distance, std::vector<std::size_t>& result) const;
+
+    /**
+    * Calls callback(i, j, distance) once for every pair of UAVs closer than `distance` (i < j).
+    */
+    template <typename Callback>
+    void forEachPairWithin(double distance, Callback callback) const;
+
+private:
+    static constexpr std::uint32_t none = 0xFFFFFFFFu;
+    static constexpr int maxReach = 64; // Largest stencil, in cells on each side
+
+    std::uint64_t cellKey(double x, double y) const;
+    static std::uint64_t packKey(std::int32_t cx, std::int32_t cy);
+    static std::int32_t cellX(std::uint64_t key) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32)); }
+    static std::int32_t cellY(std::uint64_t key) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(key)); }
+    int reachFor(double distance) const;
+
+    void unlink(std::size_t index);
+    void link(std::size_t index, std::uint64_t key);
+
+    double cellSize;
+    std::vector<std::uint64_t> cells;   // Cell key of every UAV
+    std::vector<std::uint32_t> next;    // Next UAV in the same cell
+    std::vector<std::uint32_t> prev;    // Previous UAV in the same cell
+    std::vector<std::uint8_t> inGrid;
+    std::vector<double> xs, ys, zs;     // Indexed positions
+    std::unordered_map<std::uint64_t, std::uint32_t> heads; // First UAV of every occupied cell
+};
+
+template <typename Callback>
+void SpatialGrid::forEachPairWithin(double distance, Callback callback) const {
+    const double limit = distance * distance;
+    const int reach = reachFor(distance);
+
+    auto check = [&](std::uint32_t i, std::uint32_t j) {
+        double dx = xs[i] - xs[j];
+        double dy = ys[i] - ys[j];
+        double dz = zs[i] - zs[j];
+        double squared = dx * dx + dy * dy + dz * dz;
+        if (squared < limit) {
+            if (i < j) {
+                callback(i, j, std::sqrt(squared));
+            }
+            else {
+                callback(j, i, std::sqrt(squared));
+            }
+        }
+    };
+
+    if (reach > maxReach) {
+        for (auto cell = heads.begin(); cell != heads.end(); ++cell) {
+            for (auto other = cell; other != heads.end(); ++other) {
+                for (std::uint32_t i = cell->second; i != none; i = next[i]) {
+                    for (std::uint32_t j = (other == cell ? next[i] : other->second); j != none; j = next[j]) {
+                        check(i, j);
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    for (const auto& cell : heads) {
+        std::int32_t cx = cellX(cell.first);
+        std::int32_t cy = cellY(cell.first);
+
+        // Pairs inside the cell
+        for (std::uint32_t i = cell.second; i != none; i = next[i]) {
+            for (std::uint32_t j = next[i]; j != none; j = next[j]) {
+                check(i, j);
+            }
+        }
+
+        // Pairs with the neighbor cells of the forward half of the stencil, so every pair of
+        // cells is visited once
+        for (int dx = 0; dx <= reach; ++dx) {
+            for (int dy = -reach; dy <= reach; ++dy) {
+                if (dx == 0 && dy <= 0) {
+                    continue;
+                }
+                auto other = heads.find(packKey(cx + dx, cy + dy));
+                if (other == heads.end()) {
+                    continue;
+                }
+                for (std::uint32_t i = cell.second; i != none; i = next[i]) {
+                    for (std::uint32_t j = other->second; j != none; j = next[j]) {
+                        check(i, j);
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif // SPATIALGRID_H
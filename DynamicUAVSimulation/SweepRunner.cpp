@@ -0,0 +1,386 @@
+#include "SweepRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include "EventEngine.h"
+#include "Manager.h"
+#include "TextTrajectoryWriter.h"
+#include "ThreadPool.h"
+#include "TickEngine.h"
+
+namespace {
+    std::vector<std::string> splitList(const std::string& text) {
+        std::vector<std::string> items;
+        std::istringstream iss(text);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            item.erase(0, item.find_first_not_of(" \t"));
+            item.erase(item.find_last_not_of(" \t\r") + 1);
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    // Parses "name(a,b)" into a and b.
+    bool parseDistribution(const std::string& text, const std::string& name, double& a, double& b) {
+        if (text.compare(0, name.size() + 1, name + "(") != 0 || text.back() != ')') {
+            return false;
+        }
+        std::vector<std::string> arguments = splitList(text.substr(name.size() + 1, text.size() - name.size() - 2));
+        if (arguments.size() != 2) {
+            return false;
+        }
+        a = std::stod(arguments[0]);
+        b = std::stod(arguments[1]);
+        return true;
+    }
+
+    // Parses a swept value: "a,b,c", "start:stop:step", "uniform(a,b)" or "normal(mean,deviation)".
+    bool parseParameter(const std::string& key, const std::string& text, SweepParameter& parameter) {
+        parameter.key = key;
+        if (parseDistribution(text, "uniform", parameter.a, parameter.b)) {
+            parameter.kind = SweepParameter::Uniform;
+            return parameter.b > parameter.a;
+        }
+        if (parseDistribution(text, "normal", parameter.a, parameter.b)) {
+            parameter.kind = SweepParameter::Normal;
+            return parameter.b >= 0.0;
+        }
+
+        parameter.kind = SweepParameter::Values;
+        if (text.find(':') != std::string::npos) {
+            std::vector<double> bounds;
+            std::istringstream iss(text);
+            std::string item;
+            while (std::getline(iss, item, ':')) {
+                bounds.push_back(std::stod(item));
+            }
+            if (bounds.size() != 3 || bounds[2] <= 0.0 || bounds[1] < bounds[0]) {
+                return false;
+            }
+            // Inclusive range; the tolerance keeps the last value despite rounding errors
+            std::size_t count = static_cast<std::size_t>(std::floor((bounds[1] - bounds[0]) / bounds[2] + 1e-9)) + 1;
+            for (std::size_t i = 0; i < count; ++i) {
+                parameter.values.push_back(bounds[0] + static_cast<double>(i) * bounds[2]);
+            }
+            return true;
+        }
+        for (const auto& item : splitList(text)) {
+            parameter.values.push_back(std::stod(item));
+        }
+        return !parameter.values.empty();
+    }
+}
+
+// Reads a sweep specification.
+bool readSweepSpec(const std::string& filename, SweepSpec& spec) {
+    std::ifstream file(resolveInputPath(filename));
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open sweep file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, separator);
+        std::string value = line.substr(separator + 1);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+
+        try {
+            if (key == "Commands") {
+                spec.commandFiles = splitList(value);
+            }
+            else if (key == "Samples") {
+                spec.samples = static_cast<std::size_t>(std::max(1.0, std::stod(value)));
+            }
+            else if (key == "Seed") {
+                spec.seed = static_cast<std::uint64_t>(std::stod(value));
+            }
+            else if (key == "SweepThreads") {
+                spec.threads = static_cast<int>(std::stod(value));
+            }
+            else if (key == "Trajectories") {
+                for (const auto& item : splitList(value)) {
+                    spec.trajectoryRuns.push_back(static_cast<std::size_t>(std::stoul(item)));
+                }
+            }
+            else {
+                Config probe;
+                if (!setConfigValue(probe, key, 0.0)) {
+                    std::cerr << "Error: Unknown sweep parameter " << key << std::endl;
+                    return false;
+                }
+                SweepParameter parameter;
+                if (!parseParameter(key, value, parameter)) {
+                    std::cerr << "Error: Invalid values for sweep parameter " << key << ": " << value << std::endl;
+                    return false;
+                }
+                spec.parameters.push_back(parameter);
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Error: Invalid sweep line: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Collects the statistics of one run.
+class SweepRunner::SummarySink : public TrajectorySink {
+public:
+    explicit SummarySink(std::vector<UAVSummary>& summaries)
+        : summaries(summaries), started(summaries.size(), 0) {}
+
+    void record(std::size_t index, const TrajectorySample& sample) override {
+        UAVSummary& summary = summaries[index];
+        if (started[index]) {
+            double dx = sample.x - summary.finalX;
+            double dy = sample.y - summary.finalY;
+            summary.pathLength += std::sqrt(dx * dx + dy * dy);
+        }
+        started[index] = 1;
+        if (summary.timeToStandby < 0.0 && (sample.mode & TrajectorySample::StandbyMode)) {
+            summary.timeToStandby = sample.time;
+        }
+        summary.finalX = sample.x;
+        summary.finalY = sample.y;
+        summary.finalAzimuth = sample.azimuth;
+    }
+
+    void flush() override {}
+
+private:
+    std::vector<UAVSummary>& summaries;
+    std::vector<std::uint8_t> started;
+};
+
+// Constructor
+SweepRunner::SweepRunner(const Config& base, const SweepSpec& spec, const std::vector<std::vector<Command>>& commandSets)
+    : spec(spec), commandSets(commandSets), base(base) {
+    for (const auto& parameter : spec.parameters) {
+        if (parameter.kind == SweepParameter::Values) {
+            runCount *= parameter.values.size();
+        }
+    }
+    runCount *= std::max<std::size_t>(1, commandSets.size()) * spec.samples;
+}
+
+// Computes the configuration of every run and prepares the schedulers they share.
+void SweepRunner::prepareRuns() {
+    configs.assign(runCount, base);
+    results.assign(runCount, RunResult());
+    schedulers.clear();
+    std::vector<std::pair<std::size_t, int>> schedulerKeys; // (command set, fleet size) of every scheduler
+
+    const std::size_t setCount = std::max<std::size_t>(1, commandSets.size());
+    for (std::size_t run = 0; run < runCount; ++run) {
+        Config& config = configs[run];
+        RunResult& result = results[run];
+
+        // Run index = ((grid point) * command sets + command set) * samples + sample
+        std::size_t rest = run / spec.samples;
+        result.commandSet = rest % setCount;
+        rest /= setCount;
+
+        std::seed_seq seeds{ static_cast<std::uint32_t>(spec.seed), static_cast<std::uint32_t>(spec.seed >> 32),
+                             static_cast<std::uint32_t>(run), static_cast<std::uint32_t>(static_cast<std::uint64_t>(run) >> 32) };
+        std::mt19937_64 rng(seeds);
+
+        result.values.resize(spec.parameters.size());
+        for (std::size_t p = spec.parameters.size(); p-- > 0;) {
+            const SweepParameter& parameter = spec.parameters[p];
+            if (parameter.kind == SweepParameter::Values) {
+                result.values[p] = parameter.values[rest % parameter.values.size()];
+                rest /= parameter.values.size();
+            }
+        }
+        for (std::size_t p = 0; p < spec.parameters.size(); ++p) {
+            const SweepParameter& parameter = spec.parameters[p];
+            if (parameter.kind == SweepParameter::Uniform) {
+                result.values[p] = std::uniform_real_distribution<double>(parameter.a, parameter.b)(rng);
+            }
+            else if (parameter.kind == SweepParameter::Normal) {
+                result.values[p] = std::normal_distribution<double>(parameter.a, parameter.b)(rng);
+            }
+            setConfigValue(config, parameter.key, result.values[p]);
+        }
+        config.Threads = 1; // The sweep parallelizes over runs
+        if (config.N_uav < 0) {
+            config.N_uav = 0;
+        }
+
+        std::pair<std::size_t, int> key(result.commandSet, config.N_uav);
+        auto found = std::find(schedulerKeys.begin(), schedulerKeys.end(), key);
+        if (found == schedulerKeys.end()) {
+            static const std::vector<Command> noCommands;
+            schedulers.emplace_back(commandSets.empty() ? noCommands : commandSets[result.commandSet], config.N_uav);
+            schedulerKeys.push_back(key);
+            found = schedulerKeys.end() - 1;
+        }
+        result.scheduler = static_cast<std::size_t>(found - schedulerKeys.begin());
+    }
+}
+
+// Runs one variant and keeps its statistics.
+void SweepRunner::executeRun(std::size_t run) {
+    Config& config = configs[run];
+    RunResult& result = results[run];
+
+    UAVFleet fleet;
+    if (!initializeUAVs(config, fleet)) {
+        result.ok = false;
+        return;
+    }
+    CommandScheduler scheduler = schedulers[result.scheduler];
+
+    result.uavs.assign(fleet.size(), UAVSummary());
+    SummarySink summary(result.uavs);
+    std::vector<TrajectorySink*> sinks = { &summary };
+
+    TextTrajectoryWriter trajectoryWriter(config.OutputBufferBytes, config.OutputFlushInterval, config.MotionModel == 1);
+    if (std::find(spec.trajectoryRuns.begin(), spec.trajectoryRuns.end(), run) != spec.trajectoryRuns.end()) {
+        std::vector<std::string> filenames;
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            filenames.push_back("Run" + std::to_string(run) + "_UAV" + std::to_string(fleet.num[i]) + ".txt");
+        }
+        if (trajectoryWriter.open(filenames)) {
+            sinks.push_back(&trajectoryWriter);
+        }
+        else {
+            result.ok = false;
+        }
+    }
+
+    if (config.Engine == 1 && config.MotionModel == 0) {
+        EventEngine engine(config, fleet, scheduler, sinks);
+        engine.run();
+    }
+    else {
+        TickEngine engine(config, fleet, scheduler, sinks);
+        engine.run();
+    }
+    trajectoryWriter.close();
+}
+
+// Runs the whole sweep and writes the summary.
+bool SweepRunner::run(const std::string& summaryFile) {
+    auto start = std::chrono::steady_clock::now();
+    prepareRuns();
+
+    int threads = spec.threads > 0 ? spec.threads : static_cast<int>(std::thread::hardware_concurrency());
+    ThreadPool pool(static_cast<std::size_t>(std::max(1, std::min<int>(threads, static_cast<int>(runCount)))));
+
+    // Runs differ in length, so threads pull the next run from a shared counter
+    std::atomic<std::size_t> nextRun{ 0 };
+    pool.runOnEachThread([this, &nextRun](std::size_t) {
+        for (std::size_t run = nextRun++; run < runCount; run = nextRun++) {
+            executeRun(run);
+        }
+        });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bool ok = writeSummary(summaryFile);
+    printStatistics(seconds);
+    for (const auto& result : results) {
+        ok = ok && result.ok;
+    }
+    return ok;
+}
+
+// Writes one CSV line per UAV and run.
+bool SweepRunner::writeSummary(const std::string& summaryFile) const {
+    std::ofstream file(summaryFile, std::ios_base::trunc | std::ios_base::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << summaryFile << std::endl;
+        return false;
+    }
+
+    std::string buffer = "run";
+    for (const auto& parameter : spec.parameters) {
+        buffer += "," + parameter.key;
+    }
+    buffer += ",commands,num,time_to_standby,path_length,final_x,final_y,final_azimuth\n";
+
+    char line[256];
+    for (std::size_t run = 0; run < results.size(); ++run) {
+        const RunResult& result = results[run];
+        std::string prefix = std::to_string(run);
+        for (double value : result.values) {
+            std::snprintf(line, sizeof(line), ",%.6g", value);
+            prefix += line;
+        }
+        prefix += "," + std::to_string(result.commandSet);
+
+        for (std::size_t i = 0; i < result.uavs.size(); ++i) {
+            const UAVSummary& uav = result.uavs[i];
+            std::snprintf(line, sizeof(line), ",%zu,%.3f,%.3f,%.3f,%.3f,%.4f\n",
+                i + 1, uav.timeToStandby, uav.pathLength, uav.finalX, uav.finalY, uav.finalAzimuth);
+            buffer += prefix;
+            buffer += line;
+        }
+        if (buffer.size() >= 1 << 20) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+// Prints the aggregated statistics of the sweep.
+void SweepRunner::printStatistics(double seconds) const {
+    std::size_t uavCount = 0;
+    std::size_t standbyCount = 0;
+    double standbySum = 0.0;
+    double standbyMin = std::numeric_limits<double>::infinity();
+    double standbyMax = 0.0;
+    double pathSum = 0.0;
+    double pathMin = std::numeric_limits<double>::infinity();
+    double pathMax = 0.0;
+    for (const auto& result : results) {
+        for (const auto& uav : result.uavs) {
+            ++uavCount;
+            pathSum += uav.pathLength;
+            pathMin = std::min(pathMin, uav.pathLength);
+            pathMax = std::max(pathMax, uav.pathLength);
+            if (uav.timeToStandby >= 0.0) {
+                ++standbyCount;
+                standbySum += uav.timeToStandby;
+                standbyMin = std::min(standbyMin, uav.timeToStandby);
+                standbyMax = std::max(standbyMax, uav.timeToStandby);
+            }
+        }
+    }
+
+    std::cout << "Sweep: " << runCount << " runs in " << std::fixed << std::setprecision(3) << seconds << " s ("
+        << std::setprecision(1) << (runCount > 0 ? seconds * 1e6 / runCount : 0.0) << " us per run)" << std::endl;
+    if (uavCount == 0) {
+        return;
+    }
+    std::cout << std::setprecision(2);
+    std::cout << "Path length: mean " << pathSum / uavCount << ", min " << pathMin << ", max " << pathMax << std::endl;
+    std::cout << "Reached standby: " << standbyCount << " of " << uavCount << " UAVs" << std::endl;
+    if (standbyCount > 0) {
+        std::cout << "Time to standby: mean " << standbySum / standbyCount << ", min " << standbyMin
+            << ", max " << standbyMax << std::endl;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CommandScheduler.h"
+#include "Config.h"
+
+// One swept parameter of a sweep specification.
+struct SweepParameter {
+    enum Kind {
+        Values,  // Grid dimension: every run uses one of `values`
+        Uniform, // Drawn for every run, uniformly in [a, b)
+        Normal   // Drawn for every run, normal distribution with mean a and deviation b
+    };
+
+    std::string key;            // SimParams.ini key
+    Kind kind = Values;
+    std::vector<double> values;
+    double a = 0.0;
+    double b = 0.0;
+};
+
+// Sweep specification, read from a key=value file:
+//
+//   V0=20:40:5           Range (inclusive), one grid dimension
+//   R=50,100,150         List, one grid dimension
+//   Az=uniform(0,6.28)   Drawn for every run
+//   Dt=normal(0.01,0.001)
+//   Commands=a.txt,b.txt Command files, one grid dimension (default: the usual commands file)
+//   Samples=100          Runs per grid point (Monte-Carlo repetitions)
+//   Seed=1               Seed of the random draws
+//   SweepThreads=0       Concurrent runs (0 = one per core)
+//   Trajectories=0,17    Runs that also write their full trajectories (Run<k>_UAV<num>.txt)
+//
+// Keys not listed keep their SimParams.ini value. The runs are the Cartesian product of the grid
+// dimensions, times Samples.
+struct SweepSpec {
+    std::vector<SweepParameter> parameters;
+    std::vector<std::string> commandFiles;
+    std::size_t samples = 1;
+    std::uint64_t seed = 1;
+    int threads = 0;
+    std::vector<std::size_t> trajectoryRuns;
+};
+
+/**
+* Reads a sweep specification.
+*
+* @param filename The specification file, relative to the current directory.
+* @param spec Receives the specification.
+* @return True if the file was read and every key is valid, false otherwise.
+*/
+bool readSweepSpec(const std::string& filename, SweepSpec& spec);
+
+// Runs all the variants of a sweep in one process.
+// The command files are read and bucketed once; every run copies a prepared scheduler, which shares
+// its buckets and only has its own cursors, runs its own single-threaded engine and keeps only
+// summary statistics in memory, while the runs are spread over a thread pool. The statistics of every UAV of every run go to a CSV file.
+class SweepRunner {
+public:
+    /**
+    * @param base The configuration the swept parameters are applied to.
+    * @param spec The sweep specification.
+    * @param commandSets The commands of every entry of spec.commandFiles (or a single set).
+    */
+    SweepRunner(const Config& base, const SweepSpec& spec, const std::vector<std::vector<Command>>& commandSets);
+
+    /**
+    * Returns the number of runs of the sweep.
+    */
+    std::size_t getRunCount() const { return runCount; }
+
+    /**
+    * Runs the whole sweep and writes the summary.
+    *
+    * @param summaryFile The CSV file receiving the statistics.
+    * @return True if all output files were written, false otherwise.
+    */
+    bool run(const std::string& summaryFile);
+
+private:
+    // Statistics of one UAV in one run
+    struct UAVSummary {
+        double timeToStandby = -1.0; // Time of the first sample in standby mode (-1 = never)
+        double pathLength = 0.0;     // Distance flown
+        double finalX = 0.0;
+        double finalY = 0.0;
+        double finalAzimuth = 0.0;
+    };
+
+    struct RunResult {
+        std::vector<double> values;  // Value of every swept parameter
+        std::size_t commandSet = 0;
+        std::size_t scheduler = 0;   // Index of the prepared scheduler in `schedulers`
+        std::vector<UAVSummary> uavs;
+        bool ok = true;
+    };
+
+    class SummarySink;
+
+    void prepareRuns();
+    void executeRun(std::size_t run);
+    bool writeSummary(const std::string& summaryFile) const;
+    void printStatistics(double seconds) const;
+
+    SweepSpec spec;
+    const std::vector<std::vector<Command>>& commandSets;
+    Config base;
+    std::size_t runCount = 1;
+    std::vector<Config> configs;
+    std::vector<RunResult> results;
+    std::vector<CommandScheduler> schedulers; // Prepared once per (command set, fleet size)
+};
+
+#endif // SWEEPRUNNER_H
@@ -0,0 +1,324 @@
+#include "TargetAssignment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "EventEngine.h"
+#include "SpatialGrid.h"
+
+namespace {
+    const std::size_t none = TargetAssigner::unassigned;
+
+    // Search radius growth stops at this many cells (SpatialGrid looks at most 64 cells away)
+    const double maxSearchCells = 64.0;
+
+    // Bid increment of the auction, relative to the largest candidate cost
+    const double epsilonFactor = 1e-4;
+
+    // Targets left without a UAV bid again with this many times `candidates` candidates
+    const std::size_t expansion = 4;
+}
+
+// Constructor
+TargetAssigner::TargetAssigner(std::size_t exactLimit, std::size_t candidates)
+    : exactLimit(exactLimit), candidates(candidates > 0 ? candidates : 1) {}
+
+// Returns the time a UAV needs to reach the loiter circle of a target.
+double TargetAssigner::cost(const UAVFleet& fleet, std::size_t index, const Command& target) {
+    double deltaX = target.x - fleet.x[index];
+    double deltaY = target.y - fleet.y[index];
+    return EventEngine::timeToLoiter(std::sqrt(deltaX * deltaX + deltaY * deltaY), fleet.v[index], fleet.r[index]);
+}
+
+// Assigns targets to distinct UAVs. The solvers work on positions in the list of usable UAVs,
+// which are turned into fleet indices at the end.
+double TargetAssigner::assign(const UAVFleet& fleet, const std::vector<std::size_t>& uavs,
+                              const std::vector<Command>& targets, std::vector<std::size_t>& assignment, Method method) {
+    assignment.assign(targets.size(), none);
+    // A UAV that does not move never reaches a target
+    std::vector<std::size_t> usable;
+    usable.reserve(uavs.size());
+    for (std::size_t index : uavs) {
+        if (fleet.v[index] > 0.0) {
+            usable.push_back(index);
+        }
+    }
+    if (usable.empty() || targets.empty()) {
+        return 0.0;
+    }
+
+    if (method == Automatic) {
+        method = usable.size() * targets.size() <= exactLimit * exactLimit ? Exact : Auction;
+    }
+    std::vector<std::size_t> chosen(targets.size(), none);
+    if (method == Exact) {
+        assignExact(fleet, usable, targets, chosen);
+    }
+    else {
+        assignAuction(fleet, usable, targets, chosen);
+    }
+
+    double total = 0.0;
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        if (chosen[t] != none) {
+            assignment[t] = usable[chosen[t]];
+            total += cost(fleet, assignment[t], targets[t]);
+        }
+    }
+    return total;
+}
+
+// Hungarian method with potentials (shortest augmenting paths) on the full cost matrix.
+// The smaller side forms the rows, so every row gets a column.
+void TargetAssigner::assignExact(const UAVFleet& fleet, const std::vector<std::size_t>& uavs,
+                                 const std::vector<Command>& targets, std::vector<std::size_t>& assignment) {
+    const bool targetRows = targets.size() <= uavs.size();
+    const std::size_t n = targetRows ? targets.size() : uavs.size();
+    const std::size_t m = targetRows ? uavs.size() : targets.size();
+    std::vector<double> costs(n * m);
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        for (std::size_t u = 0; u < uavs.size(); ++u) {
+            double value = cost(fleet, uavs[u], targets[t]);
+            costs[targetRows ? t * m + u : u * m + t] = value;
+        }
+    }
+
+    // Rows and columns are numbered from 1; column 0 is the start of every augmenting path
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> rowPotential(n + 1, 0.0);
+    std::vector<double> columnPotential(m + 1, 0.0);
+    std::vector<std::size_t> rowOf(m + 1, 0);  // Row matched to every column (0 = none)
+    std::vector<std::size_t> way(m + 1, 0);    // Previous column on the shortest path
+    std::vector<double> slack(m + 1);
+    std::vector<char> visited(m + 1);
+    for (std::size_t row = 1; row <= n; ++row) {
+        rowOf[0] = row;
+        std::size_t column = 0;
+        std::fill(slack.begin(), slack.end(), infinity);
+        std::fill(visited.begin(), visited.end(), 0);
+        do {
+            visited[column] = 1;
+            const std::size_t current = rowOf[column];
+            const double* rowCosts = costs.data() + (current - 1) * m;
+            double delta = infinity;
+            std::size_t nextColumn = 0;
+            for (std::size_t j = 1; j <= m; ++j) {
+                if (visited[j]) {
+                    continue;
+                }
+                double reduced = rowCosts[j - 1] - rowPotential[current] - columnPotential[j];
+                if (reduced < slack[j]) {
+                    slack[j] = reduced;
+                    way[j] = column;
+                }
+                if (slack[j] < delta) {
+                    delta = slack[j];
+                    nextColumn = j;
+                }
+            }
+            for (std::size_t j = 0; j <= m; ++j) {
+                if (visited[j]) {
+                    rowPotential[rowOf[j]] += delta;
+                    columnPotential[j] -= delta;
+                }
+                else {
+                    slack[j] -= delta;
+                }
+            }
+            column = nextColumn;
+        } while (rowOf[column] != 0);
+        // Augment along the path
+        do {
+            std::size_t previous = way[column];
+            rowOf[column] = rowOf[previous];
+            column = previous;
+        } while (column != 0);
+    }
+
+    for (std::size_t j = 1; j <= m; ++j) {
+        if (rowOf[j] != 0) {
+            std::size_t row = rowOf[j] - 1;
+            if (targetRows) {
+                assignment[row] = j - 1;
+            }
+            else {
+                assignment[j - 1] = row;
+            }
+        }
+    }
+}
+
+// Auction on a sparse candidate graph. Every target bids for its `candidates` cheapest UAVs
+// among the nearest ones (SpatialGrid). Leaving a target without a UAV is worth -penalty, just
+// above the largest candidate cost, so when candidates are scarce the surplus targets drop out
+// instead of raising the prices forever. The targets that dropped out bid once more with
+// `expansion` times more candidates, starting from the prices reached so far. No epsilon scaling:
+// the UAVs that end up unassigned must keep a zero price for the result to be optimal.
+void TargetAssigner::assignAuction(const UAVFleet& fleet, const std::vector<std::size_t>& uavs,
+                                   const std::vector<Command>& targets, std::vector<std::size_t>& assignment) {
+    double minX = fleet.x[uavs[0]], maxX = minX;
+    double minY = fleet.y[uavs[0]], maxY = minY;
+    for (std::size_t index : uavs) {
+        minX = std::min(minX, fleet.x[index]);
+        maxX = std::max(maxX, fleet.x[index]);
+        minY = std::min(minY, fleet.y[index]);
+        maxY = std::max(maxY, fleet.y[index]);
+    }
+    // About `candidates` UAVs per cell for an even spread (also when the UAVs lie on a line)
+    const std::size_t wanted = std::min(candidates, uavs.size());
+    const double width = maxX - minX;
+    const double height = maxY - minY;
+    const double perCell = static_cast<double>(wanted) / static_cast<double>(uavs.size());
+    double cellSize = std::max({ std::sqrt(width * height * perCell), std::max(width, height) * perCell, 1e-3 });
+    if (!std::isfinite(cellSize)) {
+        cellSize = 1.0;
+    }
+    SpatialGrid grid(cellSize);
+    grid.resize(uavs.size());
+    for (std::size_t u = 0; u < uavs.size(); ++u) {
+        grid.update(u, fleet.x[uavs[u]], fleet.y[uavs[u]], 0.0);
+    }
+    // Candidates of target t: [begins[t], ends[t]) of candidateUavs and candidateCosts
+    std::vector<std::size_t> begins(targets.size()), ends(targets.size());
+    candidateUavs.clear();
+    candidateCosts.clear();
+    std::vector<std::size_t> found;
+    std::vector<std::pair<double, std::size_t>> ranked;
+    auto findCandidates = [&](std::size_t t, std::size_t count) {
+        const Command& target = targets[t];
+        // A target away from the fleet searches from the nearest point of the fleet's bounding box
+        const double x = std::clamp(target.x, minX, maxX);
+        const double y = std::clamp(target.y, minY, maxY);
+        double radius = cellSize;
+        for (;;) {
+            grid.within(x, y, 0.0, radius, found);
+            if (found.size() >= count || radius >= maxSearchCells * cellSize) {
+                break;
+            }
+            radius = std::min(2.0 * radius, maxSearchCells * cellSize);
+        }
+        ranked.clear();
+        if (found.size() < count) {
+            // Out of the reach of the grid: rank all UAVs
+            for (std::size_t u = 0; u < uavs.size(); ++u) {
+                ranked.emplace_back(cost(fleet, uavs[u], target), u);
+            }
+        }
+        else {
+            for (std::size_t u : found) {
+                ranked.emplace_back(cost(fleet, uavs[u], target), u);
+            }
+        }
+        std::size_t kept = std::min(count, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(kept), ranked.end());
+        begins[t] = candidateUavs.size();
+        for (std::size_t i = 0; i < kept; ++i) {
+            candidateCosts.push_back(ranked[i].first);
+            candidateUavs.push_back(ranked[i].second);
+        }
+        ends[t] = candidateUavs.size();
+    };
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        findCandidates(t, wanted);
+    }
+
+    // Leaving a target without a UAV is worse than any assignment over the candidate graph
+    double maxCost = 0.0;
+    for (double value : candidateCosts) {
+        maxCost = std::max(maxCost, value);
+    }
+    double penalty = 2.0 * maxCost + 1.0;
+    const double epsilon = std::max(maxCost * epsilonFactor, 1e-9);
+
+    std::vector<double> prices(uavs.size(), 0.0);
+    std::vector<std::size_t> owners(uavs.size(), none);
+    std::fill(assignment.begin(), assignment.end(), none);
+    std::vector<std::size_t> waiting;
+    waiting.reserve(targets.size());
+    auto runAuction = [&]() {
+        while (!waiting.empty()) {
+            std::size_t t = waiting.back();
+            waiting.pop_back();
+            double best = -std::numeric_limits<double>::infinity();
+            double second = -penalty;
+            std::size_t bestUav = none;
+            for (std::size_t e = begins[t]; e < ends[t]; ++e) {
+                double value = -candidateCosts[e] - prices[candidateUavs[e]];
+                if (value > best) {
+                    second = std::max(second, best);
+                    best = value;
+                    bestUav = candidateUavs[e];
+                }
+                else if (value > second) {
+                    second = value;
+                }
+            }
+            if (bestUav == none || best <= -penalty) {
+                continue; // Priced out of all its candidates
+            }
+            prices[bestUav] += best - second + epsilon;
+            std::size_t previous = owners[bestUav];
+            if (previous != none) {
+                assignment[previous] = none;
+                waiting.push_back(previous);
+            }
+            owners[bestUav] = t;
+            assignment[t] = bestUav;
+        }
+    };
+
+    for (std::size_t t = targets.size(); t-- > 0;) {
+        waiting.push_back(t);
+    }
+    runAuction();
+
+    // Second round for the targets without a UAV while some UAV is free
+    const std::size_t count = std::min(wanted * expansion, uavs.size());
+    if (count > wanted && std::find(owners.begin(), owners.end(), none) != owners.end()) {
+        for (std::size_t t = targets.size(); t-- > 0;) {
+            if (assignment[t] == none) {
+                findCandidates(t, count);
+                waiting.push_back(t);
+            }
+        }
+        for (std::size_t e = 0; e < candidateCosts.size(); ++e) {
+            maxCost = std::max(maxCost, candidateCosts[e]);
+        }
+        penalty = 2.0 * maxCost + 1.0;
+        runAuction();
+    }
+
+    assignRemaining(fleet, uavs, targets, assignment);
+}
+
+// Gives every target still without a UAV the cheapest free UAV, in target order.
+void TargetAssigner::assignRemaining(const UAVFleet& fleet, const std::vector<std::size_t>& uavs,
+                                     const std::vector<Command>& targets, std::vector<std::size_t>& assignment) {
+    std::vector<char> taken(uavs.size(), 0);
+    std::size_t freeCount = uavs.size();
+    for (std::size_t u : assignment) {
+        if (u != none) {
+            taken[u] = 1;
+            --freeCount;
+        }
+    }
+    for (std::size_t t = 0; t < targets.size() && freeCount > 0; ++t) {
+        if (assignment[t] != none) {
+            continue;
+        }
+        double best = std::numeric_limits<double>::infinity();
+        std::size_t bestUav = none;
+        for (std::size_t u = 0; u < uavs.size(); ++u) {
+            if (!taken[u]) {
+                double value = cost(fleet, uavs[u], targets[t]);
+                if (bestUav == none || value < best) {
+                    best = value;
+                    bestUav = u;
+                }
+            }
+        }
+        assignment[t] = bestUav;
+        taken[bestUav] = 1;
+        --freeCount;
+    }
+}
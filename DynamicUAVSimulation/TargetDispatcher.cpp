@@ -0,0 +1,93 @@
+#include "TargetDispatcher.h"
+
+#include <algorithm>
+#include "Checkpoint.h"
+
+// Constructor - sorts the targets by time, keeping the file order of equal times.
+// Like other commands, targets with a time that is not positive are ignored.
+TargetDispatcher::TargetDispatcher(const std::vector<Command>& targets, std::size_t exactLimit, std::size_t candidates)
+    : assigner(exactLimit, candidates) {
+    for (const Command& target : targets) {
+        if (target.time > 0.0) {
+            upcoming.push_back(target);
+        }
+    }
+    targetCount = upcoming.size();
+    std::stable_sort(upcoming.begin(), upcoming.end(),
+        [](const Command& a, const Command& b) { return a.time < b.time; });
+}
+
+// Adds a target while the simulation runs.
+void TargetDispatcher::add(const Command& target) {
+    auto position = std::upper_bound(upcoming.begin() + static_cast<std::ptrdiff_t>(cursor), upcoming.end(), target.time,
+        [](double time, const Command& other) { return time < other.time; });
+    upcoming.insert(position, target);
+    ++targetCount;
+}
+
+// Releases the targets whose time has come and assigns the waiting ones to the free UAVs.
+std::size_t TargetDispatcher::dispatch(const UAVFleet& fleet, CommandScheduler& scheduler, double currentTime) {
+    while (cursor < upcoming.size() && upcoming[cursor].time <= currentTime) {
+        pending.push_back(upcoming[cursor++]);
+    }
+    if (cursor == upcoming.size()) {
+        upcoming.clear();
+        cursor = 0;
+    }
+    if (pending.empty()) {
+        return 0;
+    }
+
+    freeUavs.clear();
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        const std::vector<Command>& commands = scheduler.commandsOf(i);
+        if (commands.empty() || (commands.back().time < currentTime && fleet.standbyModeFlag[i])) {
+            freeUavs.push_back(i);
+        }
+    }
+    if (freeUavs.empty()) {
+        return 0;
+    }
+
+    totalCost += assigner.assign(fleet, freeUavs, pending, assignment);
+    std::size_t count = 0;
+    std::size_t kept = 0;
+    for (std::size_t t = 0; t < pending.size(); ++t) {
+        Command command = pending[t];
+        if (assignment[t] == TargetAssigner::unassigned) {
+            pending[kept++] = command;
+            continue;
+        }
+        command.num = static_cast<int>(assignment[t]) + 1;
+        scheduler.insert(command, currentTime);
+        ++count;
+    }
+    pending.resize(kept);
+    assigned += count;
+    return count;
+}
+
+// Saves the targets that have no UAV yet.
+void TargetDispatcher::saveState(StateWriter& state) const {
+    std::vector<Command> waiting(upcoming.begin() + static_cast<std::ptrdiff_t>(cursor), upcoming.end());
+    state.writeVector(waiting);
+    state.writeVector(pending);
+    state.write<std::uint64_t>(targetCount);
+    state.write<std::uint64_t>(assigned);
+    state.write(totalCost);
+}
+
+// Restores the targets saved by saveState().
+bool TargetDispatcher::restoreState(StateReader& state) {
+    std::uint64_t targets = 0;
+    std::uint64_t done = 0;
+    cursor = 0;
+    state.readVector(upcoming);
+    state.readVector(pending);
+    state.read(targets);
+    state.read(done);
+    state.read(totalCost);
+    targetCount = static_cast<std::size_t>(targets);
+    assigned = static_cast<std::size_t>(done);
+    return state.ok();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef TARGETDISPATCHER_H
+#define TARGETDISPATCHER_H
+
+#include <cstddef>
+#include <vector>
+#include "CommandScheduler.h"
+#include "TargetAssignment.h"
+#include "UAVFleet.h"
+
+class StateReader;
+class StateWriter;
+
+// Dispatches the commands addressed to UAV 0 ("any UAV") to the fleet.
+// Such a command is a target: it is released at its time, and at every synchronization point the
+// released targets that have no UAV yet are assigned by a TargetAssigner to the free UAVs, from
+// their current positions. A UAV is free when it has no pending command and either has never
+// received one or loiters at the destination of its last one. Every assignment becomes a command
+// of the chosen UAV in the scheduler, taking effect at the next step like a streamed command.
+// Assignments are never revised: a new batch (from the command file or the command stream) is
+// solved against the UAVs that are free at that moment, and targets that found no UAV wait for
+// the next UAV to become free.
+class TargetDispatcher {
+public:
+    /**
+    * @param targets The commands addressed to UAV 0, in file order.
+    * @param exactLimit Batches with at most exactLimit^2 UAV-target pairs are solved exactly.
+    * @param candidates UAVs each target bids for in the auction of larger batches.
+    */
+    TargetDispatcher(const std::vector<Command>& targets, std::size_t exactLimit, std::size_t candidates);
+
+    /**
+    * Adds a target while the simulation runs (command stream).
+    */
+    void add(const Command& target);
+
+    /**
+    * Releases the targets whose time has come and assigns the waiting ones to the free UAVs.
+    * Called by the engine at a synchronization point.
+    *
+    * @param fleet The fleet, at the current time.
+    * @param scheduler The scheduler receiving the commands of the assigned targets.
+    * @param currentTime The current simulation time.
+    * @return The number of targets assigned.
+    */
+    std::size_t dispatch(const UAVFleet& fleet, CommandScheduler& scheduler, double currentTime);
+
+    std::size_t getTargetCount() const { return targetCount; }
+    std::size_t getAssignedCount() const { return assigned; }
+    std::size_t getWaitingCount() const { return pending.size() + (upcoming.size() - cursor); }
+    double getTotalCost() const { return totalCost; }
+
+    void saveState(StateWriter& state) const;
+    bool restoreState(StateReader& state);
+
+private:
+    TargetAssigner assigner;
+    std::vector<Command> upcoming; // Targets not released yet, sorted by time
+    std::size_t cursor = 0;        // Released targets of `upcoming`
+    std::vector<Command> pending;  // Released targets without a UAV
+    std::size_t targetCount = 0;
+    std::size_t assigned = 0;
+    double totalCost = 0.0;        // Predicted time to target of all assignments
+    std::vector<std::size_t> freeUavs;
+    std::vector<std::size_t> assignment;
+};
+
+#endif // TARGETDISPATCHER_H
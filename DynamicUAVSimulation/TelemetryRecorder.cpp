@@ -0,0 +1,122 @@
+#include "TelemetryRecorder.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const char* reasonName(TelemetryRecorder::DumpReason reason) {
+        switch (reason) {
+        case TelemetryRecorder::DumpOnDemand:
+            return "demand";
+        case TelemetryRecorder::DumpOnTrigger:
+            return "trigger";
+        default:
+            return "end";
+        }
+    }
+}
+
+// Constructor - allocates the rings of all UAVs
+TelemetryRecorder::TelemetryRecorder(const std::vector<int>& nums, std::size_t capacity, double postTriggerTime)
+    : nums(nums), capacity(capacity > 0 ? capacity : 1), postTriggerTime(postTriggerTime),
+      rings(nums.size() * this->capacity), counts(nums.size(), 0) {}
+
+// Returns the number of samples kept per UAV to cover the given time window.
+std::size_t TelemetryRecorder::capacityFor(double window, double interval) {
+    if (interval <= 0.0 || window <= 0.0) {
+        return 1;
+    }
+    return static_cast<std::size_t>(std::ceil(window / interval)) + 1;
+}
+
+// Stores a sample in the ring of the UAV, overwriting the oldest one when full.
+void TelemetryRecorder::record(std::size_t index, const TrajectorySample& sample) {
+    std::uint64_t count = counts[index];
+    rings[index * capacity + count % capacity] = sample;
+    counts[index] = count + 1;
+
+    // A position that is no longer finite is an anomaly worth keeping
+    if (!std::isfinite(sample.x) || !std::isfinite(sample.y)) {
+        trigger(sample.time);
+    }
+}
+
+// Nothing is written until a dump.
+void TelemetryRecorder::flush() {}
+
+// Requests a dump at the next synchronization point.
+void TelemetryRecorder::requestDump() {
+    dumpRequested = true;
+}
+
+// Requests a dump because of an anomaly.
+void TelemetryRecorder::trigger(double time) {
+    if (!triggered.exchange(true)) {
+        triggerTime = time;
+    }
+}
+
+// Writes the dumps requested since the last synchronization point.
+void TelemetryRecorder::synchronize(double time) {
+    if (dumpRequested.exchange(false)) {
+        dump(DumpOnDemand, time);
+    }
+    if (triggered.load() && time >= triggerTime + postTriggerTime) {
+        triggered = false;
+        // Trigger dumps are at least one ring length apart, so a persistent anomaly
+        // does not write the same history over and over
+        std::uint64_t recorded = counts.empty() ? 0 : counts[0];
+        if (!hasTriggerDump || recorded - countAtTriggerDump >= capacity) {
+            dump(DumpOnTrigger, time);
+            hasTriggerDump = true;
+            countAtTriggerDump = recorded;
+        }
+    }
+}
+
+// Writes the buffered samples of all UAVs to a new dump file.
+bool TelemetryRecorder::dump(DumpReason reason, double time) {
+    std::string filename = "UAVRecorder_" + std::to_string(++dumpCount) + "_" + reasonName(reason) + ".txt";
+    std::ofstream file(filename, std::ios_base::trunc | std::ios_base::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    std::string buffer;
+    char line[256];
+    std::snprintf(line, sizeof(line), "# reason=%s time=%.2f capacity=%zu\n# num time x y z azimuth mode\n",
+        reasonName(reason), time, capacity);
+    buffer += line;
+
+    for (std::size_t i = 0; i < nums.size(); ++i) {
+        std::uint64_t count = counts[i];
+        std::size_t stored = count < capacity ? static_cast<std::size_t>(count) : capacity;
+        std::size_t first = count < capacity ? 0 : static_cast<std::size_t>(count % capacity);
+        for (std::size_t k = 0; k < stored; ++k) {
+            const TrajectorySample& sample = rings[i * capacity + (first + k) % capacity];
+            int length = std::snprintf(line, sizeof(line), "%d %.2f %.2f %.2f %.2f %.2f %u\n",
+                nums[i], sample.time, sample.x, sample.y, sample.z, sample.azimuth, static_cast<unsigned>(sample.mode));
+            if (length > 0) {
+                buffer.append(line, static_cast<std::size_t>(length) < sizeof(line) ? static_cast<std::size_t>(length) : sizeof(line) - 1);
+            }
+        }
+        if (buffer.size() >= 1 << 20) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            dumpBytes += buffer.size();
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    dumpBytes += buffer.size();
+
+    std::cout << "Telemetry dump written to " << filename << std::endl;
+    return static_cast<bool>(file);
+}
+
+// Returns the bytes written by the dumps.
+std::uint64_t TelemetryRecorder::bytesWritten() const {
+    return dumpBytes;
+}
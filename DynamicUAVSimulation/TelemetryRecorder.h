@@ -0,0 +1,90 @@
+#pragma once
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TrajectorySink.h"
+
+// Keeps the last samples of every UAV in memory instead of logging the whole run.
+// Every UAV owns a fixed-capacity ring buffer; all rings are allocated once, in the constructor,
+// so recording never allocates and memory does not grow with TimeLim.
+// A dump writes the buffered history of all UAVs to "UAVRecorder_<n>_<reason>.txt". Dumps are
+// requested at any time and carried out at the next synchronization point of the engine, when
+// no UAV is being recorded.
+class TelemetryRecorder : public TrajectorySink {
+public:
+    enum DumpReason {
+        DumpOnDemand,  // Requested by the user (e.g. a signal)
+        DumpOnTrigger, // Requested when an anomaly was detected
+        DumpAtEnd      // End of the run
+    };
+
+    /**
+    * @param nums The UAV numbers, indexed by UAV index (written in the dumps).
+    * @param capacity The number of samples kept per UAV.
+    * @param postTriggerTime The simulation time recorded after a trigger before the dump is written,
+    *                        so the dump covers both sides of the anomaly.
+    */
+    TelemetryRecorder(const std::vector<int>& nums, std::size_t capacity, double postTriggerTime);
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+    void flush() override;
+    void synchronize(double time) override;
+    std::uint64_t bytesWritten() const override;
+
+    /**
+    * Requests a dump at the next synchronization point.
+    * Only sets an atomic flag, so it may be called from any thread or from a signal handler.
+    */
+    void requestDump();
+
+    /**
+    * Requests a dump because of an anomaly. The dump is written once postTriggerTime has elapsed.
+    * Trigger dumps are at least one ring length apart; triggers arriving sooner are ignored.
+    * May be called from record() of any UAV.
+    *
+    * @param time The simulation time of the anomaly.
+    */
+    void trigger(double time);
+
+    /**
+    * Writes the buffered samples of all UAVs to a new dump file.
+    * Must not run concurrently with record().
+    *
+    * @param reason Why the dump is written (part of the file name).
+    * @param time The current simulation time.
+    * @return True if the file was written, false otherwise.
+    */
+    bool dump(DumpReason reason, double time);
+
+    /**
+    * Returns the number of samples kept per UAV to cover the given time window.
+    *
+    * @param window The time window, in seconds.
+    * @param interval The time between two recorded samples.
+    */
+    static std::size_t capacityFor(double window, double interval);
+
+private:
+    std::vector<int> nums;
+    std::size_t capacity;
+    double postTriggerTime;
+    std::vector<TrajectorySample> rings;  // UAV i owns rings[i * capacity, (i + 1) * capacity)
+    std::vector<std::uint64_t> counts;    // Samples recorded so far per UAV
+    std::atomic<bool> dumpRequested{ false };
+    std::atomic<bool> triggered{ false };
+    double triggerTime = 0.0;
+    bool hasTriggerDump = false;
+    std::uint64_t countAtTriggerDump = 0;  // Samples of UAV 0 at the last trigger dump
+    unsigned dumpCount = 0;
+    std::uint64_t dumpBytes = 0;
+};
+
+#endif // TELEMETRYRECORDER_H
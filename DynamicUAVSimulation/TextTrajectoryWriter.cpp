@@ -0,0 +1,279 @@
+#include "TextTrajectoryWriter.h"
+
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include "Checkpoint.h"
+#include "Profiler.h"
+
+namespace {
+    // Longest value with two decimals: sign, 309 integer digits, point and decimals (or "-nan")
+    const std::size_t maxValueChars = 313;
+
+    // Appends a value with two decimals and a separator; the same text as printf("%.2f").
+    char* appendValue(char* out, double value, char separator) {
+        out = std::to_chars(out, out + maxValueChars, value, std::chars_format::fixed, 2).ptr;
+        *out = separator;
+        return out + 1;
+    }
+}
+
+// Constructor
+TextTrajectoryWriter::TextTrajectoryWriter(std::size_t flushBytes, double flushInterval, bool altitude,
+                                           double indexInterval)
+    : flushBytes(flushBytes), flushInterval(flushInterval), altitude(altitude), indexInterval(indexInterval) {}
+
+// Destructor - makes sure nothing buffered is lost
+TextTrajectoryWriter::~TextTrajectoryWriter() {
+    close();
+}
+
+// Creates (or truncates) one output file per UAV, and its index file.
+bool TextTrajectoryWriter::open(const std::vector<std::string>& filenames, bool append) {
+    channels.clear();
+    channels.resize(filenames.size());
+    const std::ios_base::openmode mode = append ? std::ios_base::app : std::ios_base::trunc;
+
+    const bool indexed = indexInterval > 0.0;
+
+    bool descriptorsExhausted = false;
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        Channel& channel = channels[i];
+        channel.filename = filenames[i];
+        channel.buffer.reserve(flushBytes);
+        const std::string indexFile = indexed ? trajectoryIndexFilename(channel.filename) : std::string();
+
+        if (!descriptorsExhausted) {
+            channel.file.open(channel.filename, mode);
+            if (channel.file.is_open() && indexed) {
+                channel.indexFile.open(indexFile, std::ios_base::binary | mode);
+            }
+        }
+        bool opened = channel.file.is_open() && (!indexed || channel.indexFile.is_open());
+        if (!opened && i > 0 && !descriptorsExhausted) {
+            // Most likely out of file descriptors: release the previous handles
+            // and write the remaining UAVs with open/append/close on every flush.
+            descriptorsExhausted = true;
+            channel.file.close();
+            channel.indexFile.close();
+            channels[i - 1].file.close();
+            channels[i - 1].indexFile.close();
+            channels[i - 1].persistent = false;
+        }
+        if (descriptorsExhausted) {
+            channel.persistent = false;
+            channel.file.open(channel.filename, mode);
+            channel.file.close();
+            // Verify the file really exists since we no longer hold a handle
+            std::ofstream probe(channel.filename, std::ios_base::app);
+            if (!probe.is_open()) {
+                std::cerr << "Failed to open file: " << channel.filename << std::endl;
+                return false;
+            }
+        }
+        else if (!opened) {
+            std::cerr << "Failed to open file: " << (channel.file.is_open() ? indexFile : channel.filename) << std::endl;
+            return false;
+        }
+
+        if (indexed && !append) {
+            TrajectoryIndexHeader header = makeTrajectoryIndexHeader(indexInterval);
+            std::ofstream output;
+            std::ofstream& target = channel.persistent ? channel.indexFile : output;
+            if (!channel.persistent) {
+                output.open(indexFile, std::ios_base::binary | std::ios_base::trunc);
+            }
+            if (!target.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !target.flush()) {
+                std::cerr << "Failed to open file: " << indexFile << std::endl;
+                return false;
+            }
+            channel.indexBytes = sizeof(header);
+        }
+    }
+    return true;
+}
+
+// Formats one "<time> <x> <y> <azimuth> [<z>]" line into the UAV buffer.
+void TextTrajectoryWriter::record(std::size_t index, const TrajectorySample& sample) {
+    Channel& channel = channels[index];
+
+    char line[5 * (maxValueChars + 1)];
+    char* end = appendValue(line, sample.time, ' ');
+    end = appendValue(end, sample.x, ' ');
+    end = appendValue(end, sample.y, ' ');
+    if (altitude) {
+        end = appendValue(end, sample.azimuth, ' ');
+        end = appendValue(end, sample.z, '\n');
+    }
+    else {
+        end = appendValue(end, sample.azimuth, '\n');
+    }
+    if (indexInterval > 0.0) {
+        // The index holds the values as written (two decimals), so that it agrees with the text
+        TrajectorySample written = sample;
+        const char* value = std::from_chars(line, end, written.time).ptr;
+        value = std::from_chars(value + 1, end, written.x).ptr;
+        std::from_chars(value + 1, end, written.y);
+        if (channel.index.add(written, channel.bytesWritten + channel.buffer.size(), indexInterval)) {
+            writeIndex(channel);
+        }
+    }
+    channel.buffer.append(line, static_cast<std::size_t>(end - line));
+
+    if (channel.buffer.size() >= flushBytes ||
+        (flushInterval > 0.0 && sample.time - channel.lastFlushTime >= flushInterval)) {
+        channel.lastFlushTime = sample.time;
+        flushChannel(channel);
+    }
+}
+
+// Writes the buffer of a single UAV to its file.
+void TextTrajectoryWriter::flushChannel(Channel& channel) {
+    if (channel.buffer.empty()) {
+        writeIndexBuffer(channel);
+        return;
+    }
+    UAVSIM_PROFILE_COUNT_N(OutputBytes, channel.buffer.size());
+    UAVSIM_PROFILE_COUNT(OutputWriteCalls);
+    if (channel.persistent) {
+        channel.file.write(channel.buffer.data(), static_cast<std::streamsize>(channel.buffer.size()));
+        channel.file.flush();
+    }
+    else {
+        UAVSIM_PROFILE_COUNT(OutputFileOpens);
+        std::ofstream outputFile(channel.filename, std::ios_base::app); // Open in append mode
+        if (!outputFile.is_open()) {
+            std::cerr << "Failed to open file: " << channel.filename << std::endl;
+            return;
+        }
+        outputFile.write(channel.buffer.data(), static_cast<std::streamsize>(channel.buffer.size()));
+    }
+    channel.bytesWritten += channel.buffer.size();
+    channel.buffer.clear();
+    writeIndexBuffer(channel);
+}
+
+// Appends the buffered index entries of a UAV to its index file. Entries go to the index only
+// once their lines are in the trajectory file.
+void TextTrajectoryWriter::writeIndexBuffer(Channel& channel) {
+    if (channel.indexBuffer.empty()) {
+        return;
+    }
+    std::ofstream output;
+    std::ofstream& target = channel.persistent ? channel.indexFile : output;
+    if (!channel.persistent) {
+        UAVSIM_PROFILE_COUNT(OutputFileOpens);
+        output.open(trajectoryIndexFilename(channel.filename), std::ios_base::binary | std::ios_base::app);
+    }
+    if (!target.write(channel.indexBuffer.data(), static_cast<std::streamsize>(channel.indexBuffer.size())) ||
+        !target.flush()) {
+        std::cerr << "Failed to write file: " << trajectoryIndexFilename(channel.filename) << std::endl;
+        return;
+    }
+    channel.indexBytes += channel.indexBuffer.size();
+    channel.indexBuffer.clear();
+}
+
+// Moves the entry of the last completed span to the index buffer of a UAV.
+void TextTrajectoryWriter::writeIndex(Channel& channel, bool finish) {
+    TrajectoryIndexEntry entry;
+    while (channel.index.takeEntry(entry, finish)) {
+        channel.indexBuffer.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+}
+
+// Writes all UAV buffers to their files.
+void TextTrajectoryWriter::flush() {
+    for (auto& channel : channels) {
+        flushChannel(channel);
+    }
+}
+
+// Returns the number of bytes written to the files so far.
+std::uint64_t TextTrajectoryWriter::bytesWritten() const {
+    std::uint64_t total = closedBytes;
+    for (const auto& channel : channels) {
+        total += channel.bytesWritten;
+    }
+    return total;
+}
+
+// Saves the length of every file and the lines still buffered.
+void TextTrajectoryWriter::saveState(StateWriter& state) const {
+    state.write<std::uint64_t>(channels.size());
+    for (const auto& channel : channels) {
+        state.write(channel.bytesWritten);
+        state.write(channel.lastFlushTime);
+        state.writeString(channel.buffer);
+        if (indexInterval > 0.0) {
+            state.write(channel.indexBytes);
+            state.writeString(channel.indexBuffer);
+            channel.index.saveState(state);
+        }
+    }
+}
+
+// Cuts every file back to its length at the checkpoint and restores the buffered lines.
+// Lines written after the checkpoint are produced again by the resumed run.
+bool TextTrajectoryWriter::restoreState(StateReader& state) {
+    std::uint64_t count = 0;
+    if (!state.read(count) || count != channels.size()) {
+        return false;
+    }
+    for (auto& channel : channels) {
+        state.read(channel.bytesWritten);
+        state.read(channel.lastFlushTime);
+        state.readString(channel.buffer);
+        if (!state.ok()) {
+            return false;
+        }
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(channel.filename, error);
+        if (error || size < channel.bytesWritten) {
+            std::cerr << "Error: " << channel.filename << " is shorter than at the checkpoint" << std::endl;
+            return false;
+        }
+        std::filesystem::resize_file(channel.filename, channel.bytesWritten, error);
+        if (error) {
+            std::cerr << "Failed to truncate file: " << channel.filename << std::endl;
+            return false;
+        }
+        if (indexInterval > 0.0) {
+            state.read(channel.indexBytes);
+            state.readString(channel.indexBuffer);
+            if (!channel.index.restoreState(state)) {
+                return false;
+            }
+            std::string indexFile = trajectoryIndexFilename(channel.filename);
+            size = std::filesystem::file_size(indexFile, error);
+            if (error || size < channel.indexBytes) {
+                std::cerr << "Error: " << indexFile << " is shorter than at the checkpoint" << std::endl;
+                return false;
+            }
+            std::filesystem::resize_file(indexFile, channel.indexBytes, error);
+            if (error) {
+                std::cerr << "Failed to truncate file: " << indexFile << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Flushes all buffers and closes the files; the last span of every UAV goes to its index.
+void TextTrajectoryWriter::close() {
+    for (auto& channel : channels) {
+        writeIndex(channel, true);
+    }
+    flush();
+    for (auto& channel : channels) {
+        closedBytes += channel.bytesWritten;
+        if (channel.file.is_open()) {
+            channel.file.close();
+        }
+        if (channel.indexFile.is_open()) {
+            channel.indexFile.close();
+        }
+    }
+    channels.clear();
+}
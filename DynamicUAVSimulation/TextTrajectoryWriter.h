@@ -0,0 +1,89 @@
+#pragma once
+#ifndef TEXTTRAJECTORYWRITER_H
+#define TEXTTRAJECTORYWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TrajectoryIndex.h"
+#include "TrajectorySink.h"
+
+// Writes the "UAV<n>.txt" trajectory files.
+// Every file is opened once for the whole run and lines are collected in a per-UAV buffer,
+// which is written out when it exceeds a byte threshold or when a time threshold elapses.
+// The produced text is the "<time> <x> <y> <azimuth>" format with two decimals, followed by
+// "<z>" when the altitude column is enabled (3D motion model). With an index interval, every
+// file also gets a "UAV<n>.idx" time index (see TrajectoryIndex.h), written with the data.
+class TextTrajectoryWriter : public TrajectorySink {
+public:
+    /**
+    * @param flushBytes The buffer size (in bytes) per UAV that triggers a write to the file.
+    * @param flushInterval The simulation time (in seconds) after which a UAV buffer is written
+    *                      even if it is not full. Zero or less disables the time threshold.
+    * @param altitude Append the altitude to every line.
+    * @param indexInterval Seconds between two entries of the time index; zero or less writes no index.
+    */
+    TextTrajectoryWriter(std::size_t flushBytes, double flushInterval, bool altitude = false,
+                         double indexInterval = 0.0);
+    ~TextTrajectoryWriter() override;
+
+    TextTrajectoryWriter(const TextTrajectoryWriter&) = delete;
+    TextTrajectoryWriter& operator=(const TextTrajectoryWriter&) = delete;
+
+    /**
+    * Creates (or truncates) one output file per UAV, and its index file.
+    *
+    * @param filenames The file names, indexed by UAV index.
+    * @param append Keep the existing content of the files (to resume from a checkpoint).
+    * @return True if all files were created, false otherwise.
+    */
+    bool open(const std::vector<std::string>& filenames, bool append = false);
+
+    void record(std::size_t index, const TrajectorySample& sample) override;
+    void flush() override;
+    std::uint64_t bytesWritten() const override;
+
+    /**
+    * Saves the length of every file (and index) and the lines still buffered.
+    */
+    void saveState(StateWriter& state) const override;
+
+    /**
+    * Cuts every file (and index) back to its length at the checkpoint and restores the buffered lines.
+    */
+    bool restoreState(StateReader& state) override;
+
+    /**
+    * Flushes all buffers and closes the files.
+    */
+    void close();
+
+private:
+    struct Channel {
+        std::string filename;
+        std::ofstream file;
+        std::string buffer;
+        double lastFlushTime = 0.0;
+        std::uint64_t bytesWritten = 0;
+        bool persistent = true; // False when the handles could not be kept open (e.g. descriptor limit)
+        TrajectoryIndexBuilder index;
+        std::ofstream indexFile;       // Open index file (persistent channels with an index)
+        std::string indexBuffer;       // Index entries not yet written
+        std::uint64_t indexBytes = 0;  // Bytes written to the index file
+    };
+
+    void flushChannel(Channel& channel);
+    void writeIndex(Channel& channel, bool finish = false);
+    void writeIndexBuffer(Channel& channel);
+
+    std::size_t flushBytes;
+    double flushInterval;
+    bool altitude; // Lines end with the altitude
+    double indexInterval; // Seconds between index entries (0 = no index)
+    std::vector<Channel> channels;
+    std::uint64_t closedBytes = 0; // Bytes written by channels that were closed
+};
+
+#endif // TEXTTRAJECTORYWRITER_H
@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+namespace {
+    // Iterations a thread busy-waits before going to sleep
+    const int spinIterations = 20000;
+
+    // Partition boundaries are aligned to this many items, so that even arrays of bytes
+    // (64-byte aligned) are never written by two threads within the same cache line
+    const std::size_t partitionAlignment = 64;
+}
+
+// Constructor - starts the worker threads
+ThreadPool::ThreadPool(std::size_t threadCount) {
+    for (std::size_t part = 1; part < threadCount; ++part) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, part);
+    }
+}
+
+// Destructor - stops and joins the worker threads
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Returns the range of a thread in a loop of the given size.
+void ThreadPool::partition(std::size_t count, std::size_t parts, std::size_t part, std::size_t& begin, std::size_t& end) {
+    std::size_t blocks = (count + partitionAlignment - 1) / partitionAlignment;
+    std::size_t firstBlock = blocks * part / parts;
+    std::size_t lastBlock = blocks * (part + 1) / parts;
+    begin = firstBlock * partitionAlignment;
+    end = lastBlock * partitionAlignment;
+    if (begin > count) {
+        begin = count;
+    }
+    if (end > count) {
+        end = count;
+    }
+}
+
+// Runs the task on one range per thread and waits for all of them.
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& task) {
+    if (workers.empty()) {
+        task(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->count = count;
+        remaining.store(workers.size(), std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    wake.notify_all();
+
+    // The calling thread handles the first range
+    std::size_t begin, end;
+    partition(count, size(), 0, begin, end);
+    task(begin, end);
+
+    // Barrier: wait until every worker finished its range
+    for (int spin = 0; spin < spinIterations; ++spin) {
+        if (remaining.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return remaining.load(std::memory_order_acquire) == 0; });
+}
+
+// Runs the task once on every thread of the pool.
+void ThreadPool::runOnEachThread(const std::function<void(std::size_t)>& task) {
+    // One alignment block per thread, so every range is exactly one block
+    parallelFor(size() * partitionAlignment, [&task](std::size_t begin, std::size_t end) {
+        if (begin < end) {
+            task(begin / partitionAlignment);
+        }
+        });
+}
+
+// Waits for loops and runs the range of this worker.
+void ThreadPool::workerLoop(std::size_t part) {
+    std::uint64_t seen = 0;
+    while (true) {
+        // Spin first: the next tick usually starts right away
+        std::uint64_t current = generation.load(std::memory_order_acquire);
+        for (int spin = 0; current == seen && spin < spinIterations; ++spin) {
+            std::this_thread::yield();
+            current = generation.load(std::memory_order_acquire);
+        }
+        if (current == seen) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return generation.load(std::memory_order_acquire) != seen; });
+            current = generation.load(std::memory_order_acquire);
+        }
+        // task, count and stopping are written before the generation is published
+        if (stopping) {
+            return;
+        }
+        seen = current;
+        const std::function<void(std::size_t, std::size_t)>* currentTask = task;
+        std::size_t currentCount = count;
+
+        std::size_t begin, end;
+        partition(currentCount, size(), part, begin, end);
+        if (begin < end) {
+            (*currentTask)(begin, end);
+        }
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_one();
+        }
+    }
+}
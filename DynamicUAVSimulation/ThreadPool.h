@@ -0,0 +1,78 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads running data-parallel loops.
+// The calling thread takes part in every loop, so a pool of size 1 has no worker threads at all.
+// Workers spin for a short while before sleeping, which keeps the per-loop synchronization
+// cheap when loops are issued back to back (one per simulation tick).
+class ThreadPool {
+public:
+    /**
+    * @param threadCount The number of threads taking part in a loop, including the caller.
+    */
+    explicit ThreadPool(std::size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+    * Returns the number of threads taking part in a loop, including the caller.
+    */
+    std::size_t size() const { return workers.size() + 1; }
+
+    /**
+    * Splits [0, count) into one contiguous range per thread, runs the task on every range and
+    * waits until all ranges are done. Range boundaries are multiples of 64 so that two threads
+    * never write to the same cache line of a fleet array.
+    *
+    * @param count The number of items.
+    * @param task The function called with the [begin, end) range of each thread.
+    */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& task);
+
+    /**
+    * Runs the task once on every thread of the pool and waits for all of them.
+    * Useful for loops whose items have very different costs: the threads then pull
+    * items from a shared counter instead of getting a fixed range.
+    *
+    * @param task The function called with the zero-based thread index.
+    */
+    void runOnEachThread(const std::function<void(std::size_t)>& task);
+
+    /**
+    * Returns the range of a thread in a loop of the given size.
+    *
+    * @param count The number of items.
+    * @param parts The number of threads.
+    * @param part The zero-based thread index.
+    * @param begin Receives the first item of the range.
+    * @param end Receives one past the last item of the range.
+    */
+    static void partition(std::size_t count, std::size_t parts, std::size_t part, std::size_t& begin, std::size_t& end);
+
+private:
+    void workerLoop(std::size_t part);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t, std::size_t)>* task = nullptr;
+    std::size_t count = 0;
+    std::atomic<std::uint64_t> generation{ 0 };
+    std::atomic<std::size_t> remaining{ 0 };
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,331 @@
+#include "TickEngine.h"
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include "Profiler.h"
+#include "UAV.h"
+
+namespace {
+    // Smallest number of UAVs worth giving to a thread
+    const std::size_t minUAVsPerThread = 256;
+
+    // True if the command counts as new at every step: the engine keeps whole command times
+    bool restartsEveryStep(const Command& command) {
+        return static_cast<double>(static_cast<int>(command.time)) != command.time;
+    }
+}
+
+// Constructor
+TickEngine::TickEngine(const Config& config, UAVFleet& fleet, CommandScheduler& scheduler, const std::vector<TrajectorySink*>& sinks)
+    : config(config), fleet(fleet), scheduler(scheduler), sinks(sinks),
+      uavCommands(fleet.size(), -1), loiter(config.LoiterFastPath ? fleet.size() : 0, config.LoiterRenormalizeSteps),
+      kinematics(fleet, config), validating(config.PrecisionValidation && config.MotionModel != 1),
+      compactState(floatState && config.MotionModel != 1 && !validating),
+      divergences(validating ? fleet.size() : 0, 0.0), divergenceTimes(validating ? fleet.size() : 0, 0.0),
+      pacer(config.RealTimeFactor, config.RealTimeSpin), pool(threadCountFor(config.Threads, fleet.size())) {}
+
+// Returns the number of threads used for a fleet of the given size.
+std::size_t TickEngine::threadCountFor(int requested, std::size_t fleetSize) {
+    std::size_t threads = requested > 0 ? static_cast<std::size_t>(requested) : std::thread::hardware_concurrency();
+    std::size_t useful = (fleetSize + minUAVsPerThread - 1) / minUAVsPerThread;
+    if (requested <= 0 && threads > useful) {
+        threads = useful;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+// Runs the simulation until the time limit.
+void TickEngine::run() {
+    const std::size_t ticksPerSync = config.TicksPerSync > 0 ? static_cast<std::size_t>(config.TicksPerSync) : 1;
+    std::vector<double> tickTimes;
+    tickTimes.reserve(ticksPerSync);
+
+    // UAVs with a loiter restarted every step stay in double for the whole run (a resumed run
+    // gets their flags from the checkpoint)
+    if ((compactState || validating) && doubleState.size() != fleet.size()) {
+        doubleState.assign(fleet.size(), 0);
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            for (const Command& command : scheduler.commandsOf(i)) {
+                if (restartsEveryStep(command)) {
+                    doubleState[i] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    // The single precision state starts from the fleet, also when resuming
+    if (compactState) {
+        compact.load(fleet);
+    }
+    if (validating) {
+        shadow.load(fleet);
+    }
+
+    // Main simulation loop
+    pacer.start(currentTime);
+    while (currentTime <= config.TimeLim) {
+        UAVSIM_PROFILE_SYNC();
+        UAVSIM_PROFILE_SCOPE(PhaseTick);
+
+        // Soft real time: wait for the wall clock, then pick up the commands received meanwhile
+        {
+            UAVSIM_PROFILE_SCOPE(PhasePacing);
+            pacer.waitUntil(currentTime);
+        }
+        if (commandStream != nullptr) {
+            UAVSIM_PROFILE_SCOPE(PhaseCommands);
+            commandStream->drainInto(scheduler, currentTime, targetDispatcher);
+        }
+        if (targetDispatcher != nullptr) {
+            UAVSIM_PROFILE_SCOPE(PhaseAssignment);
+            targetDispatcher->dispatch(fleet, scheduler, currentTime);
+        }
+
+        // Times of the ticks run before the next synchronization
+        tickTimes.clear();
+        while (tickTimes.size() < ticksPerSync && currentTime <= config.TimeLim) {
+            tickTimes.push_back(currentTime);
+            // Increment current time by time step
+            currentTime += config.Dt;
+        }
+
+        pool.parallelFor(fleet.size(), [this, &tickTimes](std::size_t begin, std::size_t end) {
+            stepRange(begin, end, tickTimes);
+            });
+
+        {
+            UAVSIM_PROFILE_SCOPE(PhaseSynchronize);
+            for (TrajectorySink* sink : sinks) {
+                sink->synchronize(tickTimes.back());
+            }
+        }
+
+        // The state goes to memory here; the checkpoint writer puts it on disk in the background
+        if (checkpointer != nullptr && checkpointer->isDue(tickTimes.back())) {
+            UAVSIM_PROFILE_SCOPE(PhaseCheckpoint);
+            saveState(checkpointState);
+            checkpointer->submit(tickTimes.back(), checkpointState);
+        }
+    }
+
+    pacer.finish(currentTime);
+
+    UAVSIM_PROFILE_SCOPE(PhaseFlush);
+    for (TrajectorySink* sink : sinks) {
+        sink->flush();
+    }
+}
+
+// Saves the complete simulation state.
+void TickEngine::saveState(StateWriter& state) const {
+    // Parameters the state depends on, checked when it is restored
+    state.write<std::uint32_t>(0);
+    state.write<std::uint64_t>(fleet.size());
+    state.write(config.Dt);
+    state.write(config.OutputInterval);
+    state.write<std::uint64_t>(sinks.size());
+    state.write<std::int32_t>(config.MotionModel);
+
+    state.write(currentTime);
+    state.writeVector(uavCommands);
+    state.writeVector(doubleState);
+    loiter.saveState(state);
+    kinematics.saveState(state);
+    fleet.saveState(state);
+    scheduler.saveState(state);
+    state.write<std::uint8_t>(targetDispatcher != nullptr ? 1 : 0);
+    if (targetDispatcher != nullptr) {
+        targetDispatcher->saveState(state);
+    }
+    for (const TrajectorySink* sink : sinks) {
+        sink->saveState(state);
+    }
+}
+
+// Restores a state saved by saveState() with the same parameters.
+bool TickEngine::restoreState(StateReader& state) {
+    std::uint32_t kind = 0;
+    std::uint64_t fleetSize = 0;
+    std::uint64_t sinkCount = 0;
+    double dt = 0.0;
+    double outputInterval = 0.0;
+    std::int32_t motionModel = 0;
+    state.read(kind);
+    state.read(fleetSize);
+    state.read(dt);
+    state.read(outputInterval);
+    state.read(sinkCount);
+    state.read(motionModel);
+    if (!state.ok() || kind != 0 || fleetSize != fleet.size() || dt != config.Dt ||
+        outputInterval != config.OutputInterval || sinkCount != sinks.size() || motionModel != config.MotionModel) {
+        std::cerr << "Error: The checkpoint does not match the simulation parameters" << std::endl;
+        return false;
+    }
+
+    state.read(currentTime);
+    state.readVector(uavCommands);
+    state.readVector(doubleState);
+    if (!loiter.restoreState(state) || !kinematics.restoreState(state)) {
+        std::cerr << "Error: The checkpoint is damaged" << std::endl;
+        return false;
+    }
+    if (!fleet.restoreState(state) || !scheduler.restoreState(state)) {
+        std::cerr << "Error: The checkpoint is damaged" << std::endl;
+        return false;
+    }
+    std::uint8_t hasTargets = 0;
+    state.read(hasTargets);
+    if ((hasTargets != 0) != (targetDispatcher != nullptr)) {
+        std::cerr << "Error: The checkpoint does not match the simulation parameters" << std::endl;
+        return false;
+    }
+    if (targetDispatcher != nullptr && !targetDispatcher->restoreState(state)) {
+        std::cerr << "Error: The checkpoint is damaged" << std::endl;
+        return false;
+    }
+    for (TrajectorySink* sink : sinks) {
+        if (!sink->restoreState(state)) {
+            std::cerr << "Error: The outputs cannot be resumed from the checkpoint" << std::endl;
+            return false;
+        }
+    }
+    return state.ok();
+}
+
+// Runs the given ticks on the UAVs in [begin, end).
+void TickEngine::stepRange(std::size_t begin, std::size_t end, const std::vector<double>& tickTimes) {
+    for (double tickTime : tickTimes) {
+        // This loop iterates over each UAV and writes its details to the outputs.
+        {
+            UAVSIM_PROFILE_SCOPE(PhaseRecord);
+            for (std::size_t i = begin; i < end; ++i) {
+                TrajectorySample sample = compactState && !doubleState[i] ? compact.sample(fleet, i, tickTime)
+                                                                           : sampleOf(fleet, i, tickTime);
+                for (TrajectorySink* sink : sinks) {
+                    sink->record(i, sample);
+                }
+            }
+        }
+
+        // Time at the end of the step, computed exactly as the main loop does
+        double stepTime = tickTime + config.Dt;
+
+        if (config.MotionModel == 1) {
+            UAVSIM_PROFILE_SCOPE(PhaseKinematics);
+            // Commands only change setpoints; the whole range then moves in one vectorized pass
+            for (std::size_t i = begin; i < end; ++i) {
+                const Command* command = scheduler.advance(i, stepTime);
+                if (command != nullptr) {
+                    kinematics.setCommand(fleet, i, *command);
+                }
+            }
+            kinematics.step(fleet, config.Dt, begin, end);
+            UAVSIM_PROFILE_COUNT_N(KinematicsUpdates, end - begin);
+            UAVSIM_PROFILE_STANDBY(fleet.standbyModeFlag.data(), begin, end);
+            continue;
+        }
+
+        // Iterate through each UAV
+        {
+            UAVSIM_PROFILE_SCOPE(PhaseNavigate);
+            for (std::size_t i = begin; i < end; ++i) {
+                // Latest command of the UAV whose time is valid and not outdated
+                const Command* command = scheduler.advance(i, stepTime);
+                if (command != nullptr) {
+                    bool newCommand = uavCommands[i] != command->time;
+                    // Update the latest command time for the UAV, kept in whole seconds as it always was:
+                    // a command with a fractional time counts as new at every step
+                    uavCommands[i] = static_cast<int>(command->time);
+                    fleet.cruising[i] = 0;
+                    if ((compactState || validating) && !doubleState[i] && restartsEveryStep(*command)) {
+                        // A streamed or dispatched command: the UAV continues in double from here
+                        if (compactState) {
+                            compact.store(fleet, i, i + 1);
+                        }
+                        doubleState[i] = 1;
+                    }
+                    if (compactState && !doubleState[i]) {
+                        compact.navigateToTarget(i, config.Dt, command->x, command->y, newCommand);
+                        continue;
+                    }
+                    if (validating && !doubleState[i]) {
+                        shadow.navigateToTarget(i, config.Dt, command->x, command->y, newCommand);
+                    }
+                    UAV uav = fleet[i];
+                    if (newCommand) {
+                        uav.setStandbyModeFlag(false);
+                    }
+                    if (config.LoiterFastPath && fleet.standbyModeFlag[i]) {
+                        // A whole step on the circle: rotate instead of calling cos/sin
+                        loiter.step(fleet, i, config.Dt, command->x, command->y);
+                        UAVSIM_PROFILE_COUNT(LoiterFastPathSteps);
+                    }
+                    else {
+                        if (config.LoiterFastPath) {
+                            loiter.invalidate(i);
+                        }
+                        uav.navigateToTarget(config.Dt, command->x, command->y); // Execute navigation command
+                    }
+                }
+            }
+        }
+
+        UAVSIM_PROFILE_STANDBY(compactState ? compact.standbyFlags() : fleet.standbyModeFlag.data(), begin, end);
+
+        // UAVs that did not receive any command yet keep flying straight, in one pass over the range
+        {
+            UAVSIM_PROFILE_SCOPE(PhaseCruise);
+            UAVSIM_PROFILE_COUNT_FLAGS(CruiseUpdates, fleet.cruising.data(), begin, end);
+            if (compactState) {
+                compact.linearFlightUpdate(config.Dt, fleet.cruising.data(), begin, end);
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (doubleState[i] && fleet.cruising[i]) {
+                        linearFlightUpdate(fleet, config.Dt, i, i + 1);
+                    }
+                }
+            }
+            else {
+                linearFlightUpdate(fleet, config.Dt, begin, end);
+            }
+            if (validating) {
+                shadow.linearFlightUpdate(config.Dt, fleet.cruising.data(), begin, end);
+            }
+        }
+
+        // The fleet went through UAV::navigateToTarget: compare the single precision state with it
+        if (validating) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (doubleState[i]) {
+                    continue;
+                }
+                double divergence = std::hypot(shadow.positionX(i) - fleet.x[i], shadow.positionY(i) - fleet.y[i]);
+                if (divergence > divergences[i]) {
+                    divergences[i] = divergence;
+                    divergenceTimes[i] = stepTime;
+                }
+            }
+        }
+    }
+
+    // The rest of the simulation reads the fleet
+    if (compactState) {
+        compact.store(fleet, begin, end, doubleState.data());
+    }
+}
+
+// Returns the largest position difference between the single precision state and the fleet.
+double TickEngine::getPrecisionDivergence(std::size_t& index, double& time) const {
+    double largest = 0.0;
+    index = 0;
+    time = 0.0;
+    for (std::size_t i = 0; i < divergences.size(); ++i) {
+        if (divergences[i] > largest) {
+            largest = divergences[i];
+            index = i;
+            time = divergenceTimes[i];
+        }
+    }
+    return largest;
+}
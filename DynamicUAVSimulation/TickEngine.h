@@ -0,0 +1,139 @@
+#pragma once
+#ifndef TICKENGINE_H
+#define TICKENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Checkpoint.h"
+#include "CommandScheduler.h"
+#include "CommandStream.h"
+#include "Config.h"
+#include "FleetState.h"
+#include "Kinematics.h"
+#include "LoiterFastPath.h"
+#include "Pacer.h"
+#include "TargetDispatcher.h"
+#include "ThreadPool.h"
+#include "TrajectorySink.h"
+#include "UAVFleet.h"
+
+// Fixed-step simulation loop.
+// Every tick records the state of each UAV in the trajectory sinks, advances the clock by Dt
+// and moves each UAV: towards its active command if it has one, in a straight line otherwise.
+// With MotionModel=1 the UAVs are moved by the 3D model of Kinematics instead.
+// A build with UAVSIM_FLOAT_STATE moves the planar state in single precision (FleetState<StateScalar>)
+// and copies it into the fleet at the end of every synchronization period; the loiter fast path
+// only applies to the double state. UAVs with a command whose time is not whole restart their loiter
+// at every step, which only the double model can follow (see FleetState.h): they are moved in the
+// fleet, in double, for the whole run when the command is in the command file, and from the
+// activation of the command on when it is streamed or dispatched. PrecisionValidation (in any
+// build) moves the fleet in double precision with UAV::navigateToTarget, as a default build does,
+// steps a FleetState<float> along with it for the UAVs a float build moves in float, and keeps, for
+// every one of them, the largest distance between the two positions.
+//
+// The fleet is split into contiguous ranges, one per thread of a persistent thread pool. A thread
+// runs TicksPerSync ticks on its range before the threads meet at a barrier. UAVs never share
+// state, so the results are identical to a serial run whatever the thread count.
+class TickEngine {
+public:
+    /**
+    * @param config The simulation parameters (Dt, TimeLim, Threads, TicksPerSync, RealTimeFactor, RealTimeSpin,
+    *               LoiterFastPath, LoiterRenormalizeSteps, MotionModel and the limits of the 3D model).
+    * @param fleet The fleet to simulate.
+    * @param scheduler The commands of the fleet.
+    * @param sinks The trajectory outputs. record() is called concurrently for different UAVs.
+    */
+    TickEngine(const Config& config, UAVFleet& fleet, CommandScheduler& scheduler, const std::vector<TrajectorySink*>& sinks);
+
+    /**
+    * Runs the simulation until the time limit.
+    */
+    void run();
+
+    /**
+    * Sets the source of the commands received while the simulation runs.
+    * The stream is drained into the scheduler at every synchronization point.
+    *
+    * @param stream The command stream, or nullptr for none.
+    */
+    void setCommandStream(CommandStream* stream) { commandStream = stream; }
+
+    /**
+    * Sets the dispatcher of the targets (commands addressed to UAV 0).
+    * It assigns the released targets to the free UAVs at every synchronization point.
+    * Must be set before restoreState(), since its targets are part of the state.
+    *
+    * @param dispatcher The target dispatcher, or nullptr for none.
+    */
+    void setTargetDispatcher(TargetDispatcher* dispatcher) { targetDispatcher = dispatcher; }
+
+    /**
+    * Sets the writer of the periodic checkpoints (CheckpointInterval).
+    *
+    * @param writer The checkpoint writer, or nullptr for none.
+    */
+    void setCheckpointer(Checkpointer* writer) { checkpointer = writer; }
+
+    /**
+    * Saves the complete simulation state: engine, fleet, commands and trajectory outputs.
+    * Only valid between two runs of the loop, e.g. from a synchronization point.
+    */
+    void saveState(StateWriter& state) const;
+
+    /**
+    * Restores a state saved by saveState() with the same parameters; run() then continues from it.
+    *
+    * @return True if the state was restored, false if it does not match the simulation.
+    */
+    bool restoreState(StateReader& state);
+
+    double getCurrentTime() const { return currentTime; }
+    const Pacer& getPacer() const { return pacer; }
+
+    /**
+    * Returns the largest distance between the position of the single precision state and the one
+    * of the fleet, moved in double precision (PrecisionValidation; 0 when disabled).
+    *
+    * @param index Receives the zero-based index of the UAV.
+    * @param time Receives the simulation time at which it was reached.
+    */
+    double getPrecisionDivergence(std::size_t& index, double& time) const;
+    std::size_t getThreadCount() const { return pool.size(); }
+
+    /**
+    * Returns the number of threads used for a fleet of the given size.
+    *
+    * @param requested The requested number of threads (0 = one per core).
+    * @param fleetSize The number of UAVs.
+    */
+    static std::size_t threadCountFor(int requested, std::size_t fleetSize);
+
+private:
+    // Runs the given ticks on the UAVs in [begin, end).
+    void stepRange(std::size_t begin, std::size_t end, const std::vector<double>& tickTimes);
+
+    const Config& config;
+    UAVFleet& fleet;
+    CommandScheduler& scheduler;
+    std::vector<TrajectorySink*> sinks;
+    std::vector<int> uavCommands; // Last executed command time of every UAV (-1 = none)
+    LoiterFastPath loiter;        // Incremental rotation of the loitering UAVs (empty when disabled)
+    Kinematics kinematics;        // 3D motion model (empty unless MotionModel=1)
+    bool validating;              // PrecisionValidation with the planar model
+    bool compactState;            // The planar model moves `compact` instead of the fleet
+    FleetState<StateScalar> compact;  // Planar state of a UAVSIM_FLOAT_STATE build
+    FleetState<float> shadow;     // Single precision state stepped along the fleet (PrecisionValidation)
+    std::vector<std::uint8_t> doubleState; // UAVs moved in the fleet, in double, by a float build or its validation
+    std::vector<double> divergences;     // Largest position difference of every UAV
+    std::vector<double> divergenceTimes; // Time of that difference
+    CommandStream* commandStream = nullptr;
+    TargetDispatcher* targetDispatcher = nullptr;
+    Checkpointer* checkpointer = nullptr;
+    StateWriter checkpointState; // Reused buffer of the checkpoints
+    Pacer pacer; // Soft real time (RealTimeFactor)
+    double currentTime = 0.0;
+    ThreadPool pool;
+};
+
+#endif // TICKENGINE_H
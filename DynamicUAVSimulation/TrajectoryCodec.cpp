@@ -0,0 +1,212 @@
+#include "TrajectoryCodec.h"
+
+#include <cmath>
+#include <cstring>
+#include "Checkpoint.h"
+
+namespace {
+    enum Field { Time, X, Y, Azimuth, Z, FieldCount };
+
+    // Control byte codes of x, y and azimuth
+    const unsigned codeZero = 0;
+    const unsigned codePlusOne = 1;
+    const unsigned codeMinusOne = 2;
+    const unsigned codeVarint = 3;
+    const unsigned altitudeFlag = 0x40;
+    const unsigned timeFlag = 0x80;
+
+    // Quantizes a value; values out of range (or not finite) are stored as 0. The range keeps the
+    // deltas of delta within 64 bits.
+    std::int64_t quantize(double value, double resolution) {
+        double scaled = value / resolution;
+        if (!(std::fabs(scaled) < 1.0e18)) {
+            return 0;
+        }
+        return std::llround(scaled);
+    }
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    void appendVarint(std::string& out, std::int64_t value) {
+        std::uint64_t bits = zigzag(value);
+        while (bits >= 0x80) {
+            out.push_back(static_cast<char>((bits & 0x7F) | 0x80));
+            bits >>= 7;
+        }
+        out.push_back(static_cast<char>(bits));
+    }
+
+    bool readVarint(const unsigned char*& position, const unsigned char* end, std::int64_t& value) {
+        std::uint64_t bits = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (position == end) {
+                return false;
+            }
+            unsigned char byte = *position++;
+            bits |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                value = unzigzag(bits);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Two-bit code of a delta of delta: small values are stored in the control byte
+    unsigned smallCode(std::int64_t value) {
+        return value == 0 ? codeZero : value == 1 ? codePlusOne : value == -1 ? codeMinusOne : codeVarint;
+    }
+
+    bool readCoded(unsigned code, const unsigned char*& position, const unsigned char* end, std::int64_t& value) {
+        switch (code) {
+        case codeZero: value = 0; return true;
+        case codePlusOne: value = 1; return true;
+        case codeMinusOne: value = -1; return true;
+        default: return readVarint(position, end, value);
+        }
+    }
+
+    TrajectorySample toSample(const std::int64_t values[FieldCount], const TrajectoryResolution& resolution) {
+        TrajectorySample sample = {};
+        sample.time = static_cast<double>(values[Time]) * resolution.time;
+        sample.x = static_cast<double>(values[X]) * resolution.position;
+        sample.y = static_cast<double>(values[Y]) * resolution.position;
+        sample.azimuth = static_cast<double>(values[Azimuth]) * resolution.angle;
+        sample.z = static_cast<double>(values[Z]) * resolution.position;
+        return sample;
+    }
+}
+
+// Quantizes a sample and appends its delta of delta to the payload.
+void TrajectoryBlockEncoder::add(const TrajectorySample& sample, const TrajectoryResolution& resolution) {
+    const std::int64_t values[FieldCount] = {
+        quantize(sample.time, resolution.time), quantize(sample.x, resolution.position),
+        quantize(sample.y, resolution.position), quantize(sample.azimuth, resolution.angle),
+        quantize(sample.z, resolution.position)
+    };
+    if (count++ == 0) {
+        for (int f = 0; f < FieldCount; ++f) {
+            first[f] = values[f];
+            previous[f] = values[f];
+            delta[f] = 0;
+        }
+        return;
+    }
+
+    std::int64_t change[FieldCount];
+    for (int f = 0; f < FieldCount; ++f) {
+        std::int64_t newDelta = values[f] - previous[f];
+        change[f] = newDelta - delta[f];
+        delta[f] = newDelta;
+        previous[f] = values[f];
+    }
+    unsigned codeX = smallCode(change[X]);
+    unsigned codeY = smallCode(change[Y]);
+    unsigned codeAzimuth = smallCode(change[Azimuth]);
+    unsigned control = codeX | codeY << 2 | codeAzimuth << 4 |
+        (change[Z] != 0 ? altitudeFlag : 0) | (change[Time] != 0 ? timeFlag : 0);
+    payload.push_back(static_cast<char>(control));
+    if (codeX == codeVarint) {
+        appendVarint(payload, change[X]);
+    }
+    if (codeY == codeVarint) {
+        appendVarint(payload, change[Y]);
+    }
+    if (codeAzimuth == codeVarint) {
+        appendVarint(payload, change[Azimuth]);
+    }
+    if (change[Z] != 0) {
+        appendVarint(payload, change[Z]);
+    }
+    if (change[Time] != 0) {
+        appendVarint(payload, change[Time]);
+    }
+}
+
+// Appends the current block to `out` and starts a new one.
+bool TrajectoryBlockEncoder::finishBlock(std::uint32_t uav, std::string& out, CompressedBlockIndexEntry& entry) {
+    if (count == 0) {
+        return false;
+    }
+    CompressedBlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "UAVB", 4);
+    header.uav = uav;
+    header.sampleCount = count;
+    header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    std::memcpy(header.first, first, sizeof(first));
+    header.lastTime = previous[Time];
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out += payload;
+
+    entry.uav = uav;
+    entry.sampleCount = count;
+    entry.firstTime = first[Time];
+    entry.lastTime = previous[Time];
+    entry.offset = 0;
+
+    count = 0;
+    payload.clear();
+    return true;
+}
+
+// Saves the block being encoded.
+void TrajectoryBlockEncoder::saveState(StateWriter& state) const {
+    state.write(first);
+    state.write(previous);
+    state.write(delta);
+    state.write(count);
+    state.writeString(payload);
+}
+
+// Restores the block saved by saveState().
+bool TrajectoryBlockEncoder::restoreState(StateReader& state) {
+    state.read(first);
+    state.read(previous);
+    state.read(delta);
+    state.read(count);
+    state.readString(payload);
+    return state.ok();
+}
+
+// Decodes the payload of a block.
+bool decodeTrajectoryBlock(const CompressedBlockHeader& header, const char* payload,
+                           const TrajectoryResolution& resolution, std::vector<TrajectorySample>& samples) {
+    if (header.sampleCount == 0) {
+        return false;
+    }
+    std::int64_t values[FieldCount];
+    std::int64_t delta[FieldCount] = {};
+    std::memcpy(values, header.first, sizeof(values));
+    samples.push_back(toSample(values, resolution));
+
+    const unsigned char* position = reinterpret_cast<const unsigned char*>(payload);
+    const unsigned char* end = position + header.payloadBytes;
+    for (std::uint32_t i = 1; i < header.sampleCount; ++i) {
+        if (position == end) {
+            return false;
+        }
+        unsigned control = *position++;
+        std::int64_t change[FieldCount] = {};
+        if (!readCoded(control & 3, position, end, change[X]) ||
+            !readCoded((control >> 2) & 3, position, end, change[Y]) ||
+            !readCoded((control >> 4) & 3, position, end, change[Azimuth]) ||
+            ((control & altitudeFlag) != 0 && !readVarint(position, end, change[Z])) ||
+            ((control & timeFlag) != 0 && !readVarint(position, end, change[Time]))) {
+            return false;
+        }
+        // Wrapping arithmetic: a corrupted payload must not overflow
+        for (int f = 0; f < FieldCount; ++f) {
+            delta[f] = static_cast<std::int64_t>(static_cast<std::uint64_t>(delta[f]) + static_cast<std::uint64_t>(change[f]));
+            values[f] = static_cast<std::int64_t>(static_cast<std::uint64_t>(values[f]) + static_cast<std::uint64_t>(delta[f]));
+        }
+        samples.push_back(toSample(values, resolution));
+    }
+    return position == end;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#ifndef TRAJECTORYCODEC_H
+#define TRAJECTORYCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TrajectorySink.h"
+
+// Compressed trajectory file ("UAVTrajectories.uavz", all values little-endian).
+//
+// The file header is followed by a table of nUav int32 UAV numbers and then by blocks. A block
+// holds up to `blockSamples` consecutive samples of one UAV: a block header with the first sample
+// and the time range, then the encoded payload of the other samples. Blocks are self-contained,
+// so any block can be decoded on its own. Time, position and azimuth are quantized to fixed point
+// (value / resolution rounded to the nearest integer) and stored as the difference between two
+// consecutive deltas (delta of delta), which is almost always -1, 0 or +1 for a UAV in straight
+// or circular flight. Every sample starts with a control byte:
+//   bits 0-1, 2-3, 4-5: x, y and azimuth; 0 = 0, 1 = +1, 2 = -1, 3 = zigzag varint follows
+//   bit 6: a zigzag varint for z follows (otherwise 0)
+//   bit 7: a zigzag varint for the time follows (otherwise 0)
+// followed by the varints (LEB128) in the order x, y, azimuth, z, time. A steady sample takes one
+// byte. A closed file ends with an index of all blocks and a trailer pointing to it; a file whose
+// writer did not finish can still be read by walking the blocks from the start.
+struct CompressedTrajectoryHeader {
+    char magic[8];             // "UAVZTRJ" followed by a NUL
+    std::uint32_t version;     // Format version
+    std::uint32_t nUav;        // Number of UAVs (entries of the number table)
+    std::uint32_t blockSamples;// Most samples in a block
+    std::uint32_t flags;       // Combination of the flags below
+    double timeResolution;     // Seconds per time unit
+    double positionResolution; // Meters per x, y and z unit
+    double angleResolution;    // Radians per azimuth unit
+    std::uint64_t reserved[2];
+
+    static constexpr std::uint32_t Altitude = 1; // The altitude is part of the trajectory (3D model)
+};
+
+struct CompressedBlockHeader {
+    char magic[4];             // "UAVB"
+    std::uint32_t uav;         // Zero-based UAV index
+    std::uint32_t sampleCount; // Samples in the block (at least 1)
+    std::uint32_t payloadBytes;// Bytes of encoded samples after this header
+    std::int64_t first[5];     // Quantized time, x, y, azimuth and z of the first sample
+    std::int64_t lastTime;     // Quantized time of the last sample
+};
+
+struct CompressedBlockIndexEntry {
+    std::uint32_t uav;
+    std::uint32_t sampleCount;
+    std::int64_t firstTime;    // Quantized times of the first and last samples
+    std::int64_t lastTime;
+    std::uint64_t offset;      // Offset of the block header in the file
+};
+
+struct CompressedTrajectoryTrailer {
+    std::uint64_t indexOffset; // Offset of the block index
+    std::uint64_t blockCount;  // Entries of the block index
+    char magic[8];             // "UAVZIDX" followed by a NUL
+};
+
+static_assert(sizeof(CompressedTrajectoryHeader) == 64, "CompressedTrajectoryHeader must stay 64 bytes");
+static_assert(sizeof(CompressedBlockHeader) == 64, "CompressedBlockHeader must stay 64 bytes");
+static_assert(sizeof(CompressedBlockIndexEntry) == 32, "CompressedBlockIndexEntry must stay 32 bytes");
+static_assert(sizeof(CompressedTrajectoryTrailer) == 24, "CompressedTrajectoryTrailer must stay 24 bytes");
+
+// Quantization steps of the five fields
+struct TrajectoryResolution {
+    double time = 1e-6;
+    double position = 0.001;
+    double angle = 0.0001;
+};
+
+// Encodes the samples of one UAV into blocks.
+class TrajectoryBlockEncoder {
+public:
+    /**
+    * Adds a sample to the current block.
+    */
+    void add(const TrajectorySample& sample, const TrajectoryResolution& resolution);
+
+    /**
+    * Appends the current block (header and payload) to `out` and starts a new one.
+    * Does nothing if the block is empty.
+    *
+    * @param uav The UAV index stored in the block header.
+    * @param out Receives the block.
+    * @param entry Receives the index entry of the block (its offset is left to the caller).
+    * @return True if a block was appended.
+    */
+    bool finishBlock(std::uint32_t uav, std::string& out, CompressedBlockIndexEntry& entry);
+
+    std::uint32_t size() const { return count; }
+
+    void saveState(StateWriter& state) const;
+    bool restoreState(StateReader& state);
+
+private:
+    std::int64_t first[5] = {};
+    std::int64_t previous[5] = {};
+    std::int64_t delta[5] = {};
+    std::uint32_t count = 0;
+    std::string payload;
+};
+
+/**
+* Decodes the payload of a block.
+*
+* @param header The block header.
+* @param payload The encoded samples (header.payloadBytes bytes).
+* @param resolution The quantization steps of the file.
+* @param samples Receives the samples of the block (appended).
+* @return True if the payload held exactly header.sampleCount samples, false otherwise.
+*/
+bool decodeTrajectoryBlock(const CompressedBlockHeader& header, const char* payload,
+                           const TrajectoryResolution& resolution, std::vector<TrajectorySample>& samples);
+
+#endif // TRAJECTORYCODEC_H
@@ -0,0 +1,339 @@
+#include "TrajectoryIndex.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "Checkpoint.h"
+
+namespace {
+    // Parses the next "<time> <x> <y> <azimuth> [<z>]" line starting at `position` and moves
+    // `position` past it. Returns false for an incomplete or malformed line.
+    bool parseLine(const char*& position, const char* end, TrajectorySample& sample) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+        if (lineEnd == nullptr) {
+            position = end; // Incomplete last line (the writer was interrupted)
+            return false;
+        }
+        double values[5] = {};
+        int count = 0;
+        const char* p = position;
+        while (count < 5) {
+            while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                ++p;
+            }
+            if (p == lineEnd) {
+                break;
+            }
+            std::from_chars_result result = std::from_chars(p, lineEnd, values[count]);
+            if (result.ec != std::errc()) {
+                break;
+            }
+            p = result.ptr;
+            ++count;
+        }
+        position = lineEnd + 1;
+        if (count < 4) {
+            return false;
+        }
+        sample.time = values[0];
+        sample.x = values[1];
+        sample.y = values[2];
+        sample.azimuth = values[3];
+        sample.z = values[4];
+        sample.mode = 0;
+        return true;
+    }
+
+    void extend(double& low, double& high, double value) {
+        low = std::min(low, value);
+        high = std::max(high, value);
+    }
+}
+
+// Returns the name of the index of a trajectory file.
+std::string trajectoryIndexFilename(const std::string& trajectoryFile) {
+    std::string::size_type dot = trajectoryFile.find_last_of('.');
+    std::string::size_type slash = trajectoryFile.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return trajectoryFile + ".idx";
+    }
+    return trajectoryFile.substr(0, dot) + ".idx";
+}
+
+// Accounts for a line; starts a new span when the interval has elapsed.
+bool TrajectoryIndexBuilder::add(const TrajectorySample& sample, std::uint64_t offset, double interval) {
+    if (hasSpan && sample.time - span.time < interval) {
+        ++span.lines;
+        span.endTime = sample.time;
+        extend(span.minX, span.maxX, sample.x);
+        extend(span.minY, span.maxY, sample.y);
+        return false;
+    }
+    bool completes = hasSpan;
+    if (completes) {
+        completed = span;
+        hasCompleted = true;
+    }
+    span.time = sample.time;
+    span.offset = offset;
+    span.lines = 1;
+    span.endTime = sample.time;
+    span.minX = span.maxX = sample.x;
+    span.minY = span.maxY = sample.y;
+    hasSpan = true;
+    return completes;
+}
+
+// Returns the entry of the last completed span, or the current span when finishing.
+bool TrajectoryIndexBuilder::takeEntry(TrajectoryIndexEntry& entry, bool finish) {
+    if (hasCompleted) {
+        entry = completed;
+        hasCompleted = false;
+        return true;
+    }
+    if (finish && hasSpan) {
+        entry = span;
+        hasSpan = false;
+        return true;
+    }
+    return false;
+}
+
+// Saves the span being built.
+void TrajectoryIndexBuilder::saveState(StateWriter& state) const {
+    state.write(span);
+    state.write(completed);
+    state.write(hasSpan);
+    state.write(hasCompleted);
+}
+
+// Restores the span being built.
+bool TrajectoryIndexBuilder::restoreState(StateReader& state) {
+    state.read(span);
+    state.read(completed);
+    state.read(hasSpan);
+    state.read(hasCompleted);
+    return state.ok();
+}
+
+// Maps a trajectory file and loads (or builds) its index.
+bool TrajectoryIndex::open(const std::string& trajectoryFile, double buildInterval) {
+    file.close();
+    entries.clear();
+    fromFile = false;
+    interval = buildInterval;
+    if (!file.openReadOnly(trajectoryFile)) {
+        std::cerr << "Failed to open file: " << trajectoryFile << std::endl;
+        return false;
+    }
+    fromFile = loadIndexFile(trajectoryIndexFilename(trajectoryFile));
+    // The last span of an index file is rebuilt: it may not cover the end of an unfinished run
+    buildIndex(fromFile ? entries.size() - 1 : 0);
+    return true;
+}
+
+// Loads an index file written along the trajectory. Returns false if it is missing or does not
+// match the trajectory file.
+bool TrajectoryIndex::loadIndexFile(const std::string& indexFile) {
+    std::ifstream input(indexFile, std::ios_base::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    TrajectoryIndexHeader header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "UAVTIDX", 8) != 0 || header.version != 1 ||
+        header.entrySize != sizeof(TrajectoryIndexEntry) || !(header.interval >= 0.0)) {
+        std::cerr << "Warning: " << indexFile << " is not a trajectory index; it is rebuilt in memory" << std::endl;
+        return false;
+    }
+    TrajectoryIndexEntry entry;
+    while (input.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+        if (entry.offset >= file.size() || (!entries.empty() && entry.offset <= entries.back().offset)) {
+            std::cerr << "Warning: " << indexFile << " does not match its trajectory; it is rebuilt in memory" << std::endl;
+            entries.clear();
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    if (entries.empty()) {
+        return false;
+    }
+    interval = header.interval;
+    return true;
+}
+
+// Builds the index entries from entry `first` on by reading the trajectory.
+void TrajectoryIndex::buildIndex(std::size_t first) {
+    std::uint64_t offset = first < entries.size() ? entries[first].offset : 0;
+    entries.resize(std::min(first, entries.size()));
+
+    TrajectoryIndexBuilder builder;
+    TrajectoryIndexEntry entry;
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    const char* position = begin + offset;
+    while (position < end) {
+        const char* line = position;
+        TrajectorySample sample;
+        if (!parseLine(position, end, sample)) {
+            continue;
+        }
+        if (builder.add(sample, static_cast<std::uint64_t>(line - begin), interval) && builder.takeEntry(entry, false)) {
+            entries.push_back(entry);
+        }
+    }
+    if (builder.takeEntry(entry, true)) {
+        entries.push_back(entry);
+    }
+}
+
+// Returns the index of the last span starting at or before a time, or entries.size() if none does.
+std::size_t TrajectoryIndex::spanBefore(double time) const {
+    auto it = std::upper_bound(entries.begin(), entries.end(), time,
+        [](double value, const TrajectoryIndexEntry& entry) { return value < entry.time; });
+    return it == entries.begin() ? entries.size() : static_cast<std::size_t>(it - entries.begin()) - 1;
+}
+
+// Finds the last sample at or before a time: a binary search over the spans, then a read of one span.
+bool TrajectoryIndex::sampleAt(double time, TrajectorySample& sample) const {
+    std::size_t span = spanBefore(time);
+    if (span == entries.size()) {
+        return false;
+    }
+    const char* end = file.data() + file.size();
+    const char* position = file.data() + entries[span].offset;
+    TrajectorySample line;
+    bool found = false;
+    while (position < end) {
+        if (!parseLine(position, end, line)) {
+            continue;
+        }
+        if (line.time > time) {
+            break;
+        }
+        sample = line;
+        found = true;
+    }
+    return found;
+}
+
+// Extracts the samples between two times, reading from the first span that can hold one.
+void TrajectoryIndex::window(double begin, double end, std::vector<TrajectorySample>& samples) const {
+    samples.clear();
+    auto first = std::lower_bound(entries.begin(), entries.end(), begin,
+        [](const TrajectoryIndexEntry& entry, double value) { return entry.endTime < value; });
+    if (first == entries.end()) {
+        return;
+    }
+    const char* fileEnd = file.data() + file.size();
+    const char* position = file.data() + first->offset;
+    TrajectorySample sample;
+    while (position < fileEnd) {
+        if (!parseLine(position, fileEnd, sample)) {
+            continue;
+        }
+        if (sample.time > end) {
+            break;
+        }
+        if (sample.time >= begin) {
+            samples.push_back(sample);
+        }
+    }
+}
+
+// Bounding box of the positions in equal time buckets. With at least two spans per bucket on
+// average the index alone answers; otherwise the lines of the window are read.
+void TrajectoryIndex::overview(double begin, double end, std::size_t buckets,
+                               std::vector<TrajectoryOverviewBucket>& result) const {
+    result.clear();
+    if (buckets == 0 || !(end > begin)) {
+        return;
+    }
+    const double width = (end - begin) / static_cast<double>(buckets);
+    result.resize(buckets);
+    for (std::size_t i = 0; i < buckets; ++i) {
+        TrajectoryOverviewBucket& bucket = result[i];
+        bucket.begin = begin + width * static_cast<double>(i);
+        bucket.end = i + 1 == buckets ? end : begin + width * static_cast<double>(i + 1);
+        bucket.lines = 0;
+        bucket.minX = bucket.maxX = bucket.minY = bucket.maxY = 0.0;
+    }
+    auto add = [&](double time, std::uint64_t lines, double minX, double maxX, double minY, double maxY) {
+        std::size_t i = std::min(static_cast<std::size_t>((time - begin) / width), buckets - 1);
+        TrajectoryOverviewBucket& bucket = result[i];
+        if (bucket.lines == 0) {
+            bucket.minX = minX;
+            bucket.maxX = maxX;
+            bucket.minY = minY;
+            bucket.maxY = maxY;
+        }
+        else {
+            extend(bucket.minX, bucket.maxX, minX);
+            extend(bucket.minX, bucket.maxX, maxX);
+            extend(bucket.minY, bucket.maxY, minY);
+            extend(bucket.minY, bucket.maxY, maxY);
+        }
+        bucket.lines += lines;
+    };
+
+    auto first = std::lower_bound(entries.begin(), entries.end(), begin,
+        [](const TrajectoryIndexEntry& entry, double value) { return entry.time < value; });
+    auto last = std::upper_bound(first, entries.end(), end,
+        [](double value, const TrajectoryIndexEntry& entry) { return value < entry.time; });
+    if (static_cast<std::size_t>(last - first) >= 2 * buckets) {
+        for (auto it = first; it != last; ++it) {
+            add(it->time, it->lines, it->minX, it->maxX, it->minY, it->maxY);
+        }
+        return;
+    }
+    std::vector<TrajectorySample> samples;
+    window(begin, end, samples);
+    for (const TrajectorySample& sample : samples) {
+        add(sample.time, 1, sample.x, sample.x, sample.y, sample.y);
+    }
+}
+
+// Writes the index of an existing trajectory file.
+bool TrajectoryIndex::writeIndexFile(const std::string& trajectoryFile, double interval) {
+    TrajectoryIndex index;
+    if (!(interval >= 0.0)) {
+        std::cerr << "Error: invalid index interval " << interval << std::endl;
+        return false;
+    }
+    // Build from the trajectory alone, even if an index file exists
+    index.interval = interval;
+    if (!index.file.openReadOnly(trajectoryFile)) {
+        std::cerr << "Failed to open file: " << trajectoryFile << std::endl;
+        return false;
+    }
+    index.buildIndex(0);
+
+    std::string indexFile = trajectoryIndexFilename(trajectoryFile);
+    std::ofstream output(indexFile, std::ios_base::binary | std::ios_base::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Failed to open file: " << indexFile << std::endl;
+        return false;
+    }
+    TrajectoryIndexHeader header = makeTrajectoryIndexHeader(interval);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(index.entries.data()),
+                 static_cast<std::streamsize>(index.entries.size() * sizeof(TrajectoryIndexEntry)));
+    if (!output) {
+        std::cerr << "Failed to write file: " << indexFile << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Returns the header of an index file.
+TrajectoryIndexHeader makeTrajectoryIndexHeader(double interval) {
+    TrajectoryIndexHeader header = {};
+    std::memcpy(header.magic, "UAVTIDX", 8);
+    header.version = 1;
+    header.entrySize = sizeof(TrajectoryIndexEntry);
+    header.interval = interval;
+    return header;
+}
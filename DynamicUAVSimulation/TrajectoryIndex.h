@@ -0,0 +1,141 @@
+#pragma once
+#ifndef TRAJECTORYINDEX_H
+#define TRAJECTORYINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "TrajectorySink.h"
+
+// Sparse time index of a "UAV<n>.txt" trajectory file, stored next to it as "UAV<n>.idx"
+// (all values little-endian): a header, then one entry per span of the trajectory. A span starts
+// with the first line at least `interval` seconds after the start of the previous span; its entry
+// gives the byte offset of that line, the number of lines and the bounding box of the positions,
+// so an overview of a long run can be drawn from the index alone.
+struct TrajectoryIndexHeader {
+    char magic[8];        // "UAVTIDX" followed by a NUL
+    std::uint32_t version;// Format version
+    std::uint32_t entrySize; // Size of an entry in bytes
+    double interval;      // Seconds between the starts of two spans
+    std::uint64_t reserved;
+};
+
+struct TrajectoryIndexEntry {
+    double time;          // Time of the first line of the span
+    std::uint64_t offset; // Byte offset of the first line of the span
+    std::uint64_t lines;  // Lines in the span
+    double endTime;       // Time of the last line of the span
+    double minX, maxX, minY, maxY; // Bounding box of the positions in the span
+};
+
+static_assert(sizeof(TrajectoryIndexHeader) == 32, "TrajectoryIndexHeader must stay 32 bytes");
+static_assert(sizeof(TrajectoryIndexEntry) == 64, "TrajectoryIndexEntry must stay 64 bytes");
+
+/**
+* Returns the name of the index of a trajectory file: "UAV1.txt" -> "UAV1.idx".
+*/
+std::string trajectoryIndexFilename(const std::string& trajectoryFile);
+
+/**
+* Returns the header of an index file whose spans start every `interval` seconds.
+*/
+TrajectoryIndexHeader makeTrajectoryIndexHeader(double interval);
+
+// Builds the index of a trajectory while its lines are written.
+class TrajectoryIndexBuilder {
+public:
+    /**
+    * Accounts for a line written at the given byte offset; returns true when the line starts a
+    * new span (the entry of the previous one is then available from takeEntry()).
+    */
+    bool add(const TrajectorySample& sample, std::uint64_t offset, double interval);
+
+    /**
+    * Returns the entry of the last completed span, or the current span when `finish` is set.
+    *
+    * @param entry Receives the entry.
+    * @return True if there is such an entry.
+    */
+    bool takeEntry(TrajectoryIndexEntry& entry, bool finish);
+
+    void saveState(StateWriter& state) const;
+    bool restoreState(StateReader& state);
+
+private:
+    TrajectoryIndexEntry span = {};
+    TrajectoryIndexEntry completed = {};
+    bool hasSpan = false;
+    bool hasCompleted = false;
+};
+
+// Bounding box of the positions in one bucket of an overview
+struct TrajectoryOverviewBucket {
+    double begin;         // Time range of the bucket
+    double end;
+    std::uint64_t lines;  // Lines in the bucket (0 = empty, the bounds are then meaningless)
+    double minX, maxX, minY, maxY;
+};
+
+// Random access to a trajectory file through its index.
+// The trajectory file is memory-mapped. Without an index file, one is built in memory by a single
+// pass over the trajectory.
+class TrajectoryIndex {
+public:
+    /**
+    * Maps a trajectory file and loads (or builds) its index.
+    *
+    * @param trajectoryFile The "UAV<n>.txt" file.
+    * @param buildInterval Seconds between the spans of an index built in memory.
+    * @return True if the trajectory could be read, false otherwise.
+    */
+    bool open(const std::string& trajectoryFile, double buildInterval = 1.0);
+
+    /**
+    * Finds the last sample at or before a time.
+    *
+    * @param time The time, in seconds.
+    * @param sample Receives the sample.
+    * @return True if there is a sample at or before the time.
+    */
+    bool sampleAt(double time, TrajectorySample& sample) const;
+
+    /**
+    * Extracts the samples between two times (inclusive).
+    */
+    void window(double begin, double end, std::vector<TrajectorySample>& samples) const;
+
+    /**
+    * Splits [begin, end] into equal buckets and gives the bounding box of the positions in each.
+    * When a bucket covers several spans, the bounds come from the index alone (each span counts
+    * in the bucket of its first line); otherwise the lines are read.
+    *
+    * @param buckets The number of buckets (e.g. the pixel width of a plot).
+    */
+    void overview(double begin, double end, std::size_t buckets, std::vector<TrajectoryOverviewBucket>& result) const;
+
+    const std::vector<TrajectoryIndexEntry>& getEntries() const { return entries; }
+    bool hasIndexFile() const { return fromFile; }
+
+    /**
+    * Writes the index of an existing trajectory file.
+    *
+    * @param trajectoryFile The "UAV<n>.txt" file.
+    * @param interval Seconds between the starts of two spans.
+    * @return True if the index file was written, false otherwise.
+    */
+    static bool writeIndexFile(const std::string& trajectoryFile, double interval);
+
+private:
+    bool loadIndexFile(const std::string& indexFile);
+    void buildIndex(std::size_t first);
+    std::size_t spanBefore(double time) const;
+
+    MappedFile file;
+    std::vector<TrajectoryIndexEntry> entries;
+    double interval = 0.0;
+    bool fromFile = false;
+};
+
+#endif // TRAJECTORYINDEX_H
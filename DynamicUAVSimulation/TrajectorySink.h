@@ -0,0 +1,75 @@
+#pragma once
+#ifndef TRAJECTORYSINK_H
+#define TRAJECTORYSINK_H
+
+#include <cstddef>
+#include <cstdint>
+
+class StateReader;
+class StateWriter;
+
+// Structure to hold a single trajectory sample of one UAV
+struct TrajectorySample {
+    double time;       // Simulation time of the sample
+    double x;          // X coordinate
+    double y;          // Y coordinate
+    double azimuth;    // Azimuth angle
+    double z;          // Z coordinate
+    std::uint8_t mode; // Combination of the mode bits below
+
+    static constexpr std::uint8_t StandbyMode = 1;    // Circling around the target (isStandbyModeFlag)
+    static constexpr std::uint8_t AzimuthUpdated = 2; // Heading set towards the current target (isAzimuthUpdated)
+    static constexpr std::uint8_t Cruising = 4;       // No command received yet, flying straight from the start point
+};
+
+// Interface implemented by every trajectory output (text files, binary files, ...).
+// Samples of different UAVs are independent: an implementation keeps its state per UAV index,
+// and record() may be called concurrently for different indices.
+class TrajectorySink {
+public:
+    virtual ~TrajectorySink() = default;
+
+    /**
+    * Records one sample of a UAV.
+    *
+    * @param index The zero-based index of the UAV in the fleet.
+    * @param sample The sample to record.
+    */
+    virtual void record(std::size_t index, const TrajectorySample& sample) = 0;
+
+    /**
+    * Pushes all pending samples to the underlying storage.
+    */
+    virtual void flush() = 0;
+
+    /**
+    * Called by the engines between two parallel sections, while no record() call is running.
+    * Outputs that need a consistent view of all UAVs (e.g. snapshot dumps) do their work here.
+    *
+    * @param time The time of the last recorded samples.
+    */
+    virtual void synchronize(double time) { (void)time; }
+
+    /**
+    * Returns the number of bytes this output has written so far.
+    */
+    virtual std::uint64_t bytesWritten() const { return 0; }
+
+    /**
+    * Saves the state needed to resume the output after a restart (see Checkpoint.h).
+    * Called at a synchronization point.
+    *
+    * @param state The checkpoint being built.
+    */
+    virtual void saveState(StateWriter& state) const { (void)state; }
+
+    /**
+    * Restores the state saved by saveState() and continues the output from there.
+    *
+    * @param state The checkpoint being read.
+    * @return True if the state was restored, false otherwise.
+    */
+    virtual bool restoreState(StateReader& state) { (void)state; return true; }
+};
+
+#endif // TRAJECTORYSINK_H
@@ -1,86 +1,117 @@
 #include "UAV.h"
+#include "Profiler.h"
+#include "UAVFleet.h"
 
 // Constructor with parameters
 UAV::UAV(int _num, double _x, double _y, double _azimuth, double _z, double _v, double _r)
-    : num(_num), x(_x), y(_y), azimuth(_azimuth), z(_z), v(_v), r(_r) {}
+    : storage(new UAVFleet(1)), fleet(storage.get()), index(0) {
+    setNum(_num);
+    setX(_x);
+    setY(_y);
+    setAzimuth(_azimuth);
+    setZ(_z);
+    setV(_v);
+    setR(_r);
+}
 
 // Default constructor
-UAV::UAV() : num(0), x(0.0), y(0.0), azimuth(0.0), z(0.0), v(0.0), r(0.0) {}
+UAV::UAV() : storage(new UAVFleet(1)), fleet(storage.get()), index(0) {}
+
+// View of a fleet entry
+UAV::UAV(UAVFleet& _fleet, std::size_t _index) : fleet(&_fleet), index(_index) {}
+
+// Copy constructor
+UAV::UAV(const UAV& other)
+    : storage(other.storage ? new UAVFleet(*other.storage) : nullptr),
+      fleet(storage ? storage.get() : other.fleet), index(other.index) {}
+
+// Copy assignment
+UAV& UAV::operator=(const UAV& other) {
+    if (this != &other) {
+        storage.reset(other.storage ? new UAVFleet(*other.storage) : nullptr);
+        fleet = storage ? storage.get() : other.fleet;
+        index = other.index;
+    }
+    return *this;
+}
+
+// Destructor
+UAV::~UAV() = default;
 
 // Accessors
 int UAV::getNum() const {
-    return num;
+    return fleet->num[index];
 }
 
 double UAV::getX() const {
-    return x;
+    return fleet->x[index];
 }
 
 double UAV::getY() const {
-    return y;
+    return fleet->y[index];
 }
 
 double UAV::getAzimuth() const {
-    return azimuth;
+    return fleet->azimuth[index];
 }
 
 double UAV::getZ() const {
-    return z;
+    return fleet->z[index];
 }
 
 double UAV::getV() const {
-    return v;
+    return fleet->v[index];
 }
 
 double UAV::getR() const {
-    return r;
+    return fleet->r[index];
 }
 
 bool UAV::isAzimuthUpdated() const {
-    return azimuthUpdated;
+    return fleet->azimuthUpdated[index] != 0;
 }
 
 
 bool UAV::isStandbyModeFlag() const {
-    return standbyModeFlag;
+    return fleet->standbyModeFlag[index] != 0;
 }
 
 
 // Mutators
 void UAV::setNum(int _num) {
-    num = _num;
+    fleet->num[index] = _num;
 }
 
 void UAV::setX(double _x) {
-    x = _x;
+    fleet->x[index] = _x;
 }
 
 void UAV::setY(double _y) {
-    y = _y;
+    fleet->y[index] = _y;
 }
 
 void UAV::setAzimuth(double _azimuth) {
-    azimuth = _azimuth;
+    fleet->azimuth[index] = _azimuth;
 }
 
 void UAV::setZ(double _z) {
-    z = _z;
+    fleet->z[index] = _z;
 }
 
 void UAV::setV(double _v) {
-    v = _v;
+    fleet->v[index] = _v;
 }
 
 void UAV::setR(double _r) {
-    r = _r;
+    fleet->r[index] = _r;
 }
 
 void UAV::setAzimuthUpdated(bool updated) {
-    azimuthUpdated = updated;
+    fleet->azimuthUpdated[index] = updated ? 1 : 0;
 }
 
 void UAV::setStandbyModeFlag(bool flag) {
-    standbyModeFlag = flag;
+    fleet->standbyModeFlag[index] = flag ? 1 : 0;
 }
 
 
@@ -139,9 +170,10 @@ void UAV::navigateToTarget(double duration, double destX, double destY) {
     double azimuthToDest = std::atan2(deltaY, deltaX);
 
     // Check if we are currently at a distance equal to the radius from the destination
-    if (distanceToDest == getR()|| standbyModeFlag) {
+    if (distanceToDest == getR()|| isStandbyModeFlag()) {
         // If so, move in a circle
-        standbyModeFlag = true;
+        UAVSIM_PROFILE_COUNT(NavigateStandby);
+        setStandbyModeFlag(true);
         standbyMode(destX, destY, duration);
     }
     // Check if we are inside the circle (a small distance from the radius to the center)
@@ -152,12 +184,13 @@ void UAV::navigateToTarget(double duration, double destX, double destY) {
         double timeToRadius =getR()/ getV();
 
         // Update UAV azimuth towards the destination if it hasn't been updated before
-        if (!azimuthUpdated) {
+        if (!isAzimuthUpdated()) {
             setAzimuth(azimuthToDest);
-            azimuthUpdated = true;
+            setAzimuthUpdated(true);
         }
         if ((timeToDest+ timeToRadius) < duration) {
-            azimuthUpdated = false;
+            UAVSIM_PROFILE_COUNT(NavigateInsideArrive);
+            setAzimuthUpdated(false);
             // Move towards the radius linearly
             linearFlightUpdate(timeToDest);
 
@@ -168,6 +201,7 @@ void UAV::navigateToTarget(double duration, double destX, double destY) {
             standbyMode(destX, destY, remainingDuration);
         }
         else{
+            UAVSIM_PROFILE_COUNT(NavigateInsideStraight);
             linearFlightUpdate(duration);
         }
     }
@@ -178,8 +212,9 @@ void UAV::navigateToTarget(double duration, double destX, double destY) {
 
         // Check if the UAV is skipping the destination Or if the UAV is inside the radius of destination
         if (finalDistanceToDest < getR() || finalDistanceToDest - getR() > distanceToDest) {
+            UAVSIM_PROFILE_COUNT(NavigateOvershoot);
             // Calculate the time to reach the radius from the current position
-            double timeToRadiusFromCenter = (abs(getR() - distanceToDest)) / getV();
+            double timeToRadiusFromCenter = std::abs(getR() - distanceToDest) / getV();
 
             // Update UAV azimuth
             setAzimuth(azimuthToDest);
@@ -190,12 +225,13 @@ void UAV::navigateToTarget(double duration, double destX, double destY) {
             // Calculate remaining duration for circling around the center
             double remainingDuration = duration - timeToRadiusFromCenter;
 
-            standbyModeFlag = true;
+            setStandbyModeFlag(true);
 
             // Perform circular movement around the center with the remaining duration
             standbyMode(destX, destY, remainingDuration);
         }
         else {
+            UAVSIM_PROFILE_COUNT(NavigateApproach);
             // Update UAV azimuth
             setAzimuth(azimuthToDest);
 
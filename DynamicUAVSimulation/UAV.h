@@ -3,12 +3,25 @@
 #define UAV_H
 
 #include <cmath>
+#include <cstddef>
+#include <memory>
 
+class UAVFleet;
+
+// A single UAV.
+// The state lives in a UAVFleet: a UAV obtained from a fleet is a view of one entry of the
+// fleet arrays, while a UAV built with the other constructors owns a private one-entry fleet.
 class UAV {
 public:
     // Constructors
     UAV(int _num, double _x, double _y, double _azimuth, double _z, double _v, double _r);
     UAV();
+    UAV(UAVFleet& _fleet, std::size_t _index); // View of entry _index of _fleet
+
+    // Copying a view gives another view of the same entry; copying a standalone UAV copies its state
+    UAV(const UAV& other);
+    UAV& operator=(const UAV& other);
+    ~UAV();
 
     // Accessors
     int getNum() const;
@@ -67,16 +80,9 @@ public:
     void standbyMode(double destX, double destY, double duration);
 
 private:
-    int num;
-    double x;
-    double y;
-    double azimuth;
-    double z;
-    double v;
-    double r;
-
-    bool azimuthUpdated = false; 
-    bool standbyModeFlag = false;
+    std::unique_ptr<UAVFleet> storage; // Owned state of a standalone UAV, empty for views
+    UAVFleet* fleet;
+    std::size_t index;
 
 };
 
@@ -0,0 +1,86 @@
+#include "UAVFleet.h"
+
+#include <cmath>
+#include "Checkpoint.h"
+#include "UAV.h"
+
+// Constructor
+UAVFleet::UAVFleet(std::size_t count) {
+    resize(count);
+}
+
+// Changes the number of UAVs.
+void UAVFleet::resize(std::size_t count) {
+    num.resize(count, 0);
+    x.resize(count, 0.0);
+    y.resize(count, 0.0);
+    azimuth.resize(count, 0.0);
+    z.resize(count, 0.0);
+    v.resize(count, 0.0);
+    r.resize(count, 0.0);
+    azimuthUpdated.resize(count, 0);
+    standbyModeFlag.resize(count, 0);
+    cruising.resize(count, 1);
+}
+
+// Returns a view of a single UAV.
+UAV UAVFleet::operator[](std::size_t index) {
+    return UAV(*this, index);
+}
+
+// Saves every field of every UAV into a checkpoint.
+void UAVFleet::saveState(StateWriter& state) const {
+    state.writeVector(num);
+    state.writeVector(x);
+    state.writeVector(y);
+    state.writeVector(azimuth);
+    state.writeVector(z);
+    state.writeVector(v);
+    state.writeVector(r);
+    state.writeVector(azimuthUpdated);
+    state.writeVector(standbyModeFlag);
+    state.writeVector(cruising);
+}
+
+// Restores the fleet saved by saveState().
+bool UAVFleet::restoreState(StateReader& state) {
+    const std::size_t count = size();
+    state.readVector(num);
+    state.readVector(x);
+    state.readVector(y);
+    state.readVector(azimuth);
+    state.readVector(z);
+    state.readVector(v);
+    state.readVector(r);
+    state.readVector(azimuthUpdated);
+    state.readVector(standbyModeFlag);
+    state.readVector(cruising);
+    return state.ok() && size() == count && x.size() == count && cruising.size() == count;
+}
+
+// Advances every cruising UAV of the fleet in a straight line for the given duration.
+void linearFlightUpdate(UAVFleet& fleet, double duration) {
+    linearFlightUpdate(fleet, duration, 0, fleet.size());
+}
+
+// Advances the cruising UAVs in [begin, end) in a straight line for the given duration.
+void linearFlightUpdate(UAVFleet& fleet, double duration, std::size_t begin, std::size_t end) {
+    const std::size_t count = end - begin;
+    double* __restrict x = fleet.x.data() + begin;
+    double* __restrict y = fleet.y.data() + begin;
+    const double* __restrict azimuth = fleet.azimuth.data() + begin;
+    const double* __restrict v = fleet.v.data() + begin;
+    const std::uint8_t* __restrict cruising = fleet.cruising.data() + begin;
+
+    // Same expressions as UAV::linearFlightUpdate, so both paths give identical results.
+    // X and Y are updated in separate passes: a cos and a sin of the same angle in one loop are
+    // fused into a scalar sincos call, which keeps the compiler from using vector math routines.
+    for (std::size_t i = 0; i < count; ++i) {
+        double newX = x[i] + v[i] * std::cos(azimuth[i]) * duration;
+        x[i] = cruising[i] ? newX : x[i];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        double newY = y[i] + v[i] * std::sin(azimuth[i]) * duration;
+        y[i] = cruising[i] ? newY : y[i];
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef UAVFLEET_H
+#define UAVFLEET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include "TrajectorySink.h"
+
+// Allocator returning cache-line aligned memory, so every fleet array starts on a SIMD boundary.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+class UAV;
+
+// Structure-of-arrays storage for a fleet of UAVs.
+// Every UAV field lives in its own contiguous, aligned array indexed by the UAV index.
+// UAV objects obtained with operator[] are views that read and write these arrays.
+class UAVFleet {
+public:
+    explicit UAVFleet(std::size_t count = 0);
+
+    /**
+    * Changes the number of UAVs. New UAVs are zero-initialized.
+    *
+    * @param count The new number of UAVs.
+    */
+    void resize(std::size_t count);
+
+    std::size_t size() const { return num.size(); }
+
+    /**
+    * Returns a view of a single UAV.
+    *
+    * @param index The zero-based index of the UAV.
+    */
+    UAV operator[](std::size_t index);
+
+    /**
+    * Saves every field of every UAV into a checkpoint.
+    */
+    void saveState(StateWriter& state) const;
+
+    /**
+    * Restores the fleet saved by saveState(). The fleet must have the same size.
+    *
+    * @return True if the fleet was restored, false otherwise.
+    */
+    bool restoreState(StateReader& state);
+
+    AlignedVector<int> num;
+    AlignedVector<double> x;
+    AlignedVector<double> y;
+    AlignedVector<double> azimuth;
+    AlignedVector<double> z;
+    AlignedVector<double> v;
+    AlignedVector<double> r;
+    AlignedVector<std::uint8_t> azimuthUpdated;
+    AlignedVector<std::uint8_t> standbyModeFlag;
+    AlignedVector<std::uint8_t> cruising; // 1 while the UAV has not received any command
+};
+
+/**
+* Returns the current state of a UAV as a trajectory sample.
+*
+* @param fleet The fleet holding the UAV.
+* @param index The zero-based index of the UAV.
+* @param time The simulation time of the sample.
+*/
+inline TrajectorySample sampleOf(const UAVFleet& fleet, std::size_t index, double time) {
+    std::uint8_t mode = 0;
+    if (fleet.standbyModeFlag[index]) {
+        mode |= TrajectorySample::StandbyMode;
+    }
+    if (fleet.azimuthUpdated[index]) {
+        mode |= TrajectorySample::AzimuthUpdated;
+    }
+    if (fleet.cruising[index]) {
+        mode |= TrajectorySample::Cruising;
+    }
+    return { time, fleet.x[index], fleet.y[index], fleet.azimuth[index], fleet.z[index], mode };
+}
+
+/**
+* Advances every cruising UAV of the fleet in a straight line for the given duration.
+*
+* Equivalent to calling UAV::linearFlightUpdate on each cruising UAV, written as a single
+* branch-free pass over the fleet arrays so the compiler can vectorize it.
+*
+* @param fleet The fleet to update.
+* @param duration The time in seconds for which the UAVs move.
+*/
+void linearFlightUpdate(UAVFleet& fleet, double duration);
+
+/**
+* Same as linearFlightUpdate(fleet, duration), restricted to the UAVs in [begin, end).
+*/
+void linearFlightUpdate(UAVFleet& fleet, double duration, std::size_t begin, std::size_t end);
+
+#endif // UAVFLEET_H
@@ -4,8 +4,145 @@ Created on Wed Mar 20 01:56:18 2024
 
 @author: 97254
 """
+import os
+import struct
+
 import matplotlib.pyplot as plt
 
+BINARY_FILE = "UAVTrajectories.bin"
+COMPRESSED_FILE = "UAVTrajectories.uavz"
+MAX_TEXT_POINTS = 200000  # Longer text trajectories are downsampled through their time index
+
+
+def read_binary_trajectories(path):
+    """Maps the binary trajectory file written with BinaryOutput=1.
+
+    Returns one numpy record array (fields time, x, y, azimuth) per UAV.
+    """
+    import numpy as np
+
+    with open(path, "rb") as f:
+        header = f.read(256)
+    (magic, version, n_uav, record_size, field_count, dt, capacity,
+     counts_offset, data_offset, fields) = struct.unpack("<8sIIIIdQQQ200s", header)
+    if magic != b"UAVTRAJ\0" or version != 1:
+        raise ValueError(f"{path} is not a UAV trajectory file")
+
+    fields = fields.rstrip(b"\0").decode().split(",")
+    dtype = np.dtype([tuple(field.split(":")) for field in fields])
+    counts = np.memmap(path, dtype="<u8", mode="r", offset=counts_offset, shape=(n_uav,))
+    data = np.memmap(path, dtype=dtype, mode="r", offset=data_offset, shape=(n_uav, capacity))
+    return [data[i, :counts[i]] for i in range(n_uav)]
+
+
+def _read_varint(data, pos):
+    """Reads a zigzag LEB128 varint; returns (value, new position)."""
+    bits = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        bits |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return (bits >> 1) ^ -(bits & 1), pos
+
+
+def read_compressed_trajectories(path):
+    """Decodes the compressed trajectory file written with CompressedOutput=1.
+
+    Returns one dict of lists (time, x, y, azimuth, z) per UAV, in UAV index order.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    (magic, version, n_uav, _block_samples, _flags, time_res, position_res, angle_res) = \
+        struct.unpack_from("<8sIIIIddd", data, 0)
+    if magic != b"UAVZTRJ\0" or version != 1:
+        raise ValueError(f"{path} is not a compressed UAV trajectory file")
+    resolutions = (time_res, position_res, position_res, angle_res, position_res)
+    trajectories = [{"time": [], "x": [], "y": [], "azimuth": [], "z": []} for _ in range(n_uav)]
+    names = ("time", "x", "y", "azimuth", "z")
+    small = (0, 1, -1)
+
+    # Walk the blocks; the block index at the end of a closed file is not needed for a full read
+    pos = 64 + 4 * n_uav
+    while pos + 64 <= len(data) and data[pos:pos + 4] == b"UAVB":
+        uav, count, payload_bytes = struct.unpack_from("<III", data, pos + 4)
+        values = list(struct.unpack_from("<5q", data, pos + 16))
+        deltas = [0, 0, 0, 0, 0]
+        pos += 64
+        end = pos + payload_bytes
+        if end > len(data):
+            break  # Incomplete last block of a run that did not finish
+        columns = [trajectories[uav][name] for name in names]
+        for i in range(count):
+            if i > 0:
+                control = data[pos]
+                pos += 1
+                changes = [0, 0, 0, 0, 0]
+                for field, shift in ((1, 0), (2, 2), (3, 4)):
+                    code = (control >> shift) & 3
+                    if code == 3:
+                        changes[field], pos = _read_varint(data, pos)
+                    else:
+                        changes[field] = small[code]
+                if control & 0x40:
+                    changes[4], pos = _read_varint(data, pos)
+                if control & 0x80:
+                    changes[0], pos = _read_varint(data, pos)
+                for field in range(5):
+                    deltas[field] += changes[field]
+                    values[field] += deltas[field]
+            for field in range(5):
+                columns[field].append(values[field] * resolutions[field])
+        pos = end
+    return trajectories
+
+
+def read_trajectory_index(path):
+    """Reads the UAV<num>.idx time index written with TrajectoryIndexInterval > 0.
+
+    Returns a list of (time, offset, lines) per span, or None without a valid index.
+    """
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < 32:
+        return None
+    magic, version, entry_size, _interval = struct.unpack_from("<8sIId", data, 0)
+    if magic != b"UAVTIDX\0" or version != 1 or entry_size != 64:
+        return None
+    return [struct.unpack_from("<dQQ", data, pos) for pos in range(32, len(data) - 63, 64)]
+
+
+def read_text_trajectory(path, max_points=MAX_TEXT_POINTS):
+    """Reads the x and y columns of a UAV<num>.txt file line by line.
+
+    A long trajectory with a time index is downsampled: only the first line of every span (or
+    of every few spans) is read, by seeking to the offsets of the index.
+    """
+    x_values = []
+    y_values = []
+    index = read_trajectory_index(os.path.splitext(path)[0] + ".idx")
+    with open(path, "rb") as file:
+        if index and sum(entry[2] for entry in index) > max_points:
+            step = max(1, len(index) // max_points)
+            for _time, offset, _lines in index[::step]:
+                file.seek(offset)
+                parts = file.readline().split()
+                if len(parts) >= 3:
+                    x_values.append(float(parts[1]))
+                    y_values.append(float(parts[2]))
+            return x_values, y_values
+        for line in file:
+            parts = line.split()
+            if len(parts) >= 3:
+                x_values.append(float(parts[1]))  # x coordinate
+                y_values.append(float(parts[2]))  # y coordinate
+    return x_values, y_values
+
+
 # Read simulation parameters from SimParams.ini
 with open("SimParams.ini", "r") as params_file:
     params_data = params_file.readlines()
@@ -21,19 +158,21 @@ if N_uav is None:
     print("Error: N_uav not found in SimParams.ini")
     exit()
 
+# Prefer the binary output when the simulation wrote one, then the compressed output
+binary_trajectories = None
+if os.path.exists(BINARY_FILE):
+    binary_trajectories = read_binary_trajectories(BINARY_FILE)
+elif os.path.exists(COMPRESSED_FILE):
+    binary_trajectories = read_compressed_trajectories(COMPRESSED_FILE)
+
 # Loop through each UAV file
 for uav_num in range(1, N_uav + 1):
-    # Read data from the text file for the current UAV
-    with open(f"UAV{uav_num}.txt", "r") as file:
-        data = file.readlines()
-
-    # Extract x and y coordinates from the data
-    x_values = []
-    y_values = []
-    for line in data:
-        parts = line.strip().split()
-        x_values.append(float(parts[1]))  # x coordinate
-        y_values.append(float(parts[2]))  # y coordinate
+    if binary_trajectories is not None:
+        x_values = binary_trajectories[uav_num - 1]["x"]
+        y_values = binary_trajectories[uav_num - 1]["y"]
+    else:
+        # Read the x and y coordinates from the text file for the current UAV
+        x_values, y_values = read_text_trajectory(f"UAV{uav_num}.txt")
 
     # Plot the graph with filled markers
     plt.figure(figsize=(8, 6))
@@ -0,0 +1,116 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "TargetAssignment.h"
+
+namespace {
+    void randomBatch(std::size_t uavCount, std::size_t targetCount, double halfWidth, std::mt19937_64& rng,
+                     UAVFleet& fleet, std::vector<std::size_t>& uavs, std::vector<Command>& targets) {
+        std::uniform_real_distribution<double> position(-halfWidth, halfWidth);
+        std::uniform_real_distribution<double> speed(20.0, 40.0);
+        std::uniform_real_distribution<double> radius(50.0, 150.0);
+        std::uniform_real_distribution<double> heading(0.0, 6.28);
+        fleet.resize(uavCount);
+        uavs.resize(uavCount);
+        targets.clear();
+        for (std::size_t i = 0; i < uavCount; ++i) {
+            fleet.num[i] = static_cast<int>(i + 1);
+            fleet.x[i] = position(rng);
+            fleet.y[i] = position(rng);
+            fleet.azimuth[i] = heading(rng);
+            fleet.v[i] = speed(rng);
+            fleet.r[i] = radius(rng);
+            uavs[i] = i;
+        }
+        for (std::size_t t = 0; t < targetCount; ++t) {
+            Command target;
+            target.time = 1.0;
+            target.num = 0;
+            target.x = position(rng);
+            target.y = position(rng);
+            targets.push_back(target);
+        }
+    }
+
+    // Checks that the UAVs are distinct and that the returned cost is the sum of the pair costs.
+    double checkAssignment(const UAVFleet& fleet, const std::vector<Command>& targets,
+                           const std::vector<std::size_t>& assignment, double total) {
+        CHECK_EQUAL(assignment.size(), targets.size());
+        std::vector<std::size_t> used;
+        double sum = 0.0;
+        for (std::size_t t = 0; t < assignment.size(); ++t) {
+            if (assignment[t] != TargetAssigner::unassigned) {
+                used.push_back(assignment[t]);
+                sum += TargetAssigner::cost(fleet, assignment[t], targets[t]);
+            }
+        }
+        std::sort(used.begin(), used.end());
+        CHECK(std::adjacent_find(used.begin(), used.end()) == used.end());
+        CHECK_NEAR(total, sum, 1e-6 * std::max(1.0, sum));
+        return sum;
+    }
+}
+
+// The Hungarian method finds the optimum of every permutation of a small batch.
+TEST_CASE(assignment, exact_is_optimal) {
+    std::mt19937_64 rng(11);
+    TargetAssigner assigner(500, 32);
+    for (int batch = 0; batch < 20; ++batch) {
+        UAVFleet fleet;
+        std::vector<std::size_t> uavs;
+        std::vector<Command> targets;
+        randomBatch(6, 6, 3000.0, rng, fleet, uavs, targets);
+        std::vector<std::size_t> assignment;
+        double exact = assigner.assign(fleet, uavs, targets, assignment, TargetAssigner::Exact);
+        checkAssignment(fleet, targets, assignment, exact);
+
+        std::vector<std::size_t> permutation(uavs);
+        double best = std::numeric_limits<double>::infinity();
+        do {
+            double total = 0.0;
+            for (std::size_t t = 0; t < targets.size(); ++t) {
+                total += TargetAssigner::cost(fleet, permutation[t], targets[t]);
+            }
+            best = std::min(best, total);
+        } while (std::next_permutation(permutation.begin(), permutation.end()));
+        CHECK_NEAR(exact, best, 1e-9 * best);
+    }
+}
+
+// The auction assigns every target to a distinct UAV and stays close to the Hungarian optimum.
+TEST_CASE(assignment, auction_is_close_to_exact) {
+    std::mt19937_64 rng(12);
+    TargetAssigner assigner(500, 32);
+    for (std::size_t size : { 40, 200 }) {
+        UAVFleet fleet;
+        std::vector<std::size_t> uavs;
+        std::vector<Command> targets;
+        randomBatch(size, size, 5000.0, rng, fleet, uavs, targets);
+        std::vector<std::size_t> assignment;
+        double exact = assigner.assign(fleet, uavs, targets, assignment, TargetAssigner::Exact);
+        checkAssignment(fleet, targets, assignment, exact);
+        double auction = assigner.assign(fleet, uavs, targets, assignment, TargetAssigner::Auction);
+        checkAssignment(fleet, targets, assignment, auction);
+        CHECK(std::count(assignment.begin(), assignment.end(), TargetAssigner::unassigned) == 0);
+        CHECK(auction >= exact * (1.0 - 1e-9));
+        CHECK(auction <= exact * 1.03);
+    }
+}
+
+// With more targets than UAVs, every UAV gets one target and the rest are reported unassigned.
+TEST_CASE(assignment, more_targets_than_uavs) {
+    std::mt19937_64 rng(13);
+    TargetAssigner assigner(500, 32);
+    UAVFleet fleet;
+    std::vector<std::size_t> uavs;
+    std::vector<Command> targets;
+    randomBatch(5, 9, 2000.0, rng, fleet, uavs, targets);
+    for (TargetAssigner::Method method : { TargetAssigner::Exact, TargetAssigner::Auction }) {
+        std::vector<std::size_t> assignment;
+        double total = assigner.assign(fleet, uavs, targets, assignment, method);
+        checkAssignment(fleet, targets, assignment, total);
+        CHECK_EQUAL(std::count(assignment.begin(), assignment.end(), TargetAssigner::unassigned), 4);
+    }
+}
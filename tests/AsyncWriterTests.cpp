@@ -0,0 +1,187 @@
+#include "TestHarness.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "AsyncTrajectoryWriter.h"
+#include "BinaryTrajectoryWriter.h"
+#include "TextTrajectoryWriter.h"
+
+namespace {
+    // Logs the calls it receives, in order: a sample as (index, time), a synchronization as (-1, time).
+    // A delay makes every synchronization slow, like an output waiting for the disk.
+    class CallLog : public TrajectorySink {
+    public:
+        struct Call {
+            long index;
+            double time;
+            bool operator==(const Call& other) const { return index == other.index && time == other.time; }
+        };
+
+        void record(std::size_t index, const TrajectorySample& sample) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            calls.push_back({ static_cast<long>(index), sample.time });
+        }
+        void flush() override {}
+        void synchronize(double time) override {
+            std::this_thread::sleep_for(delay);
+            std::lock_guard<std::mutex> lock(mutex);
+            calls.push_back({ -1, time });
+        }
+
+        std::vector<Call> calls;
+        std::chrono::milliseconds delay{ 0 };
+
+    private:
+        std::mutex mutex;
+    };
+
+    TrajectorySample sampleAt(double time) {
+        return { time, 1.0, 2.0, 0.5, 0.0, 0 };
+    }
+
+    std::string readFile(const std::filesystem::path& filename) {
+        std::ifstream file(filename, std::ios_base::binary);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    // Writes the text and binary files of a small fleet, directly or through the async writer.
+    void writeTrajectories(const std::filesystem::path& directory, bool async, AsyncTrajectoryWriter::BackpressurePolicy policy,
+                           int bufferCount) {
+        const std::size_t fleetSize = 3;
+        const std::size_t stepsPerSync = 4;
+        const double dt = 0.01;
+        std::vector<std::string> filenames;
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            filenames.push_back((directory / ("UAV" + std::to_string(i + 1) + ".txt")).string());
+        }
+        TextTrajectoryWriter text(256, 0.25);
+        BinaryTrajectoryWriter binary(64);
+        CHECK(text.open(filenames));
+        CHECK(binary.open((directory / "UAVTrajectories.bin").string(), fleetSize, dt, 500));
+        std::vector<TrajectorySink*> outputs = { &text, &binary };
+
+        // Two synchronization periods per buffer, so with few buffers the engine regularly finds them all busy
+        const std::size_t bufferBytes = 2 * fleetSize * stepsPerSync * sizeof(TrajectorySample);
+        AsyncTrajectoryWriter writer(outputs, fleetSize, stepsPerSync, bufferBytes, bufferCount, policy);
+        std::vector<TrajectorySink*> sinks = async ? std::vector<TrajectorySink*>{ &writer } : outputs;
+        for (int step = 1; step <= 400; ++step) {
+            double time = step * dt;
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                TrajectorySample sample = { time, 10.0 * time + static_cast<double>(i), -3.0 * time, 0.001 * step, 100.0, 0 };
+                for (TrajectorySink* sink : sinks) {
+                    sink->record(i, sample);
+                }
+            }
+            // One period is cut short
+            if (step % stepsPerSync == 0 || step == 399) {
+                for (TrajectorySink* sink : sinks) {
+                    sink->synchronize(time);
+                }
+            }
+        }
+        writer.close();
+        CHECK_EQUAL(writer.getDroppedCount(), 0u);
+        text.close();
+        binary.close();
+    }
+
+    // Checks that the files of two directories are identical.
+    void checkSameFiles(const std::filesystem::path& expected, const std::filesystem::path& actual) {
+        std::size_t compared = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(expected)) {
+            std::filesystem::path other = actual / entry.path().filename();
+            CHECK(readFile(entry.path()) == readFile(other));
+            ++compared;
+        }
+        CHECK_EQUAL(compared, 4u);
+    }
+}
+
+// Samples recorded after the last synchronization reach the outputs on flush() and close().
+TEST_CASE(async, flushes_samples_after_the_last_synchronization) {
+    CallLog log;
+    AsyncTrajectoryWriter writer({ &log }, 2, 4, 1 << 20, 2, AsyncTrajectoryWriter::WaitForBuffer);
+    for (int k = 0; k < 3; ++k) {
+        writer.record(0, sampleAt(k));
+        writer.record(1, sampleAt(k));
+    }
+    writer.synchronize(2.0);
+    writer.record(0, sampleAt(3.0));
+    writer.record(1, sampleAt(3.0));
+    writer.flush();
+    CHECK_EQUAL(log.calls.size(), 9u);
+    if (log.calls.size() == 9) {
+        CHECK(log.calls[6] == CallLog::Call({ -1, 2.0 }));
+        CHECK(log.calls[7] == CallLog::Call({ 0, 3.0 }));
+        CHECK(log.calls[8] == CallLog::Call({ 1, 3.0 }));
+    }
+
+    writer.record(1, sampleAt(4.0));
+    writer.close();
+    CHECK_EQUAL(log.calls.size(), 10u);
+    CHECK(log.calls.back() == CallLog::Call({ 1, 4.0 }));
+}
+
+// Behind the writer thread, the text and binary outputs produce the same files as when the engine
+// calls them directly: with the wait policy, and with the drop policy as long as a buffer is free
+// (here every period of the run fits in the buffers).
+TEST_CASE(async, outputs_match_synchronous_writers) {
+    std::filesystem::path directory = testDirectory("async_outputs");
+    for (const char* name : { "sync", "wait", "drop" }) {
+        std::filesystem::create_directories(directory / name);
+    }
+    writeTrajectories(directory / "sync", false, AsyncTrajectoryWriter::WaitForBuffer, 2);
+    writeTrajectories(directory / "wait", true, AsyncTrajectoryWriter::WaitForBuffer, 2);
+    checkSameFiles(directory / "sync", directory / "wait");
+    writeTrajectories(directory / "drop", true, AsyncTrajectoryWriter::DropSamples, 64);
+    checkSameFiles(directory / "sync", directory / "drop");
+    std::filesystem::remove_all(directory);
+}
+
+// An output slower than the engine makes the drop policy discard whole buffers: every sample is
+// either written or counted as dropped, and the outputs only see complete periods, each followed
+// by its synchronization.
+TEST_CASE(async, drop_policy_keeps_whole_periods) {
+    const std::size_t fleetSize = 3;
+    const std::size_t stepsPerSync = 2;
+    CallLog log;
+    log.delay = std::chrono::milliseconds(2);
+    AsyncTrajectoryWriter writer({ &log }, fleetSize, stepsPerSync, 1, 2, AsyncTrajectoryWriter::DropSamples);
+    const int periods = 100;
+    for (int period = 0; period < periods; ++period) {
+        for (std::size_t step = 0; step < stepsPerSync; ++step) {
+            for (std::size_t i = 0; i < fleetSize; ++i) {
+                writer.record(i, sampleAt(static_cast<double>(period) + 0.5 * static_cast<double>(step)));
+            }
+        }
+        writer.synchronize(static_cast<double>(period) + 0.5);
+    }
+    writer.close();
+    CHECK(writer.getDroppedCount() > 0);
+
+    std::size_t written = 0;
+    std::vector<double> periodTimes;
+    bool wholePeriods = true;
+    double previousEnd = -1.0;
+    for (const CallLog::Call& call : log.calls) {
+        if (call.index >= 0) {
+            ++written;
+            periodTimes.push_back(call.time);
+            continue;
+        }
+        // The samples of the period ending at call.time are those recorded at call.time - 0.5 and call.time
+        wholePeriods = wholePeriods && periodTimes.size() == fleetSize * stepsPerSync && call.time > previousEnd;
+        for (double time : periodTimes) {
+            wholePeriods = wholePeriods && time >= call.time - 0.5 && time <= call.time;
+        }
+        previousEnd = call.time;
+        periodTimes.clear();
+    }
+    CHECK(wholePeriods);
+    CHECK(periodTimes.empty());
+    CHECK_EQUAL(written + writer.getDroppedCount(), static_cast<std::uint64_t>(periods) * fleetSize * stepsPerSync);
+}
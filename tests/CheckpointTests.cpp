@@ -0,0 +1,202 @@
+#include "TestHarness.h"
+
+#include <cstring>
+#include <memory>
+#include "Checkpoint.h"
+#include "EventEngine.h"
+#include "Manager.h"
+#include "TickEngine.h"
+
+namespace {
+    // Keeps every recorded sample in memory.
+    class MemorySink : public TrajectorySink {
+    public:
+        explicit MemorySink(std::size_t count) : samples(count) {}
+        void record(std::size_t index, const TrajectorySample& sample) override { samples[index].push_back(sample); }
+        void flush() override {}
+
+        std::vector<std::vector<TrajectorySample>> samples;
+    };
+
+    struct RunResult {
+        std::vector<char> fleetState;
+        std::vector<std::vector<TrajectorySample>> samples;
+        double checkpointTime = 0.0;
+    };
+
+    Config scenarioConfig() {
+        Config config = Config();
+        config.Dt = 0.01;
+        config.N_uav = 8;
+        config.R = 80.0;
+        config.V0 = 25.0;
+        config.Az = 0.3;
+        config.TimeLim = 40.0;
+        config.Threads = 2;
+        return config;
+    }
+
+    // Transits, loiters (also restarted every step by fractional times), retargets and one UAV
+    // that never gets a command.
+    std::vector<Command> scenarioCommands() {
+        std::vector<Command> commands;
+        auto add = [&commands](double time, int num, double x, double y) {
+            Command command;
+            command.time = time;
+            command.num = num;
+            command.x = x;
+            command.y = y;
+            commands.push_back(command);
+        };
+        add(1.0, 1, 400.0, 300.0);
+        add(2.5, 2, 50.0, -40.0);
+        add(1.0, 3, -300.0, 200.0);
+        add(12.0, 3, 100.0, 100.0);
+        add(20.0, 3, -200.0, -100.0);
+        add(3.0, 4, 0.0, 0.0);
+        add(5.0, 5, 1000.0, 0.0);
+        add(16.0, 5, 1000.0, 500.0);
+        add(0.5, 6, 30.0, 30.0);
+        add(7.7, 7, -60.0, 90.0);
+        return commands;
+    }
+
+    bool sameSample(const TrajectorySample& a, const TrajectorySample& b) {
+        return a.time == b.time && a.x == b.x && a.y == b.y && a.azimuth == b.azimuth && a.z == b.z && a.mode == b.mode;
+    }
+
+    // Runs the scenario to the end in one go.
+    template <typename Engine>
+    RunResult runThrough(const Config& config) {
+        Config fleetConfig = config;
+        UAVFleet fleet;
+        initializeUAVs(fleetConfig, fleet);
+        CommandScheduler scheduler(scenarioCommands(), config.N_uav);
+        MemorySink sink(fleet.size());
+        Engine engine(config, fleet, scheduler, { &sink });
+        engine.run();
+
+        RunResult result;
+        StateWriter state;
+        fleet.saveState(state);
+        result.fleetState = state.data();
+        result.samples = sink.samples;
+        return result;
+    }
+
+    // Runs the scenario up to stopTime with periodic checkpoints, then resumes a new engine from
+    // the last checkpoint file and runs it to the end. Only the samples of the resumed run are kept.
+    template <typename Engine>
+    RunResult runResumed(const Config& config, double stopTime, const std::string& checkpointFile) {
+        Config interrupted = config;
+        interrupted.TimeLim = stopTime;
+        {
+            Config fleetConfig = config;
+            UAVFleet fleet;
+            initializeUAVs(fleetConfig, fleet);
+            CommandScheduler scheduler(scenarioCommands(), config.N_uav);
+            MemorySink sink(fleet.size());
+            Checkpointer checkpointer(checkpointFile, 5.0);
+            Engine engine(interrupted, fleet, scheduler, { &sink });
+            engine.setCheckpointer(&checkpointer);
+            checkpointer.startAt(0.0);
+            engine.run();
+            checkpointer.finish();
+        }
+
+        RunResult result;
+        Config fleetConfig = config;
+        UAVFleet fleet;
+        initializeUAVs(fleetConfig, fleet);
+        CommandScheduler scheduler(scenarioCommands(), config.N_uav);
+        MemorySink sink(fleet.size());
+        Engine engine(config, fleet, scheduler, { &sink });
+        std::vector<char> data;
+        CHECK(Checkpointer::load(checkpointFile, result.checkpointTime, data));
+        StateReader reader(data.data(), data.size());
+        CHECK(engine.restoreState(reader));
+        engine.run();
+
+        StateWriter state;
+        fleet.saveState(state);
+        result.fleetState = state.data();
+        result.samples = sink.samples;
+        return result;
+    }
+
+    // The resumed run must end in the same state and record the same samples, bit for bit, as the
+    // uninterrupted run from the checkpoint time on.
+    template <typename Engine>
+    void checkResume(const Config& config, const std::string& name) {
+        std::filesystem::path directory = testDirectory(name);
+        RunResult full = runThrough<Engine>(config);
+        RunResult resumed = runResumed<Engine>(config, 17.3, (directory / "Checkpoint.bin").string());
+        CHECK(resumed.checkpointTime >= 14.0 && resumed.checkpointTime <= 17.3);
+        CHECK(resumed.fleetState == full.fleetState);
+        CHECK_EQUAL(resumed.samples.size(), full.samples.size());
+        std::size_t compared = 0;
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < full.samples.size() && i < resumed.samples.size(); ++i) {
+            std::vector<TrajectorySample> tail;
+            for (const TrajectorySample& sample : full.samples[i]) {
+                if (sample.time > resumed.checkpointTime) {
+                    tail.push_back(sample);
+                }
+            }
+            CHECK_EQUAL(resumed.samples[i].size(), tail.size());
+            for (std::size_t s = 0; s < tail.size() && s < resumed.samples[i].size(); ++s) {
+                mismatches += sameSample(tail[s], resumed.samples[i][s]) ? 0 : 1;
+                ++compared;
+            }
+        }
+        CHECK(compared > 0);
+        CHECK_EQUAL(mismatches, 0u);
+        std::filesystem::remove_all(directory);
+    }
+}
+
+TEST_CASE(checkpoint, tick_engine_resumes_bit_exact) {
+    checkResume<TickEngine>(scenarioConfig(), "checkpoint_tick");
+}
+
+TEST_CASE(checkpoint, tick_engine_with_loiter_fast_path_resumes_bit_exact) {
+    Config config = scenarioConfig();
+    config.LoiterFastPath = true;
+    config.LoiterRenormalizeSteps = 7;
+    checkResume<TickEngine>(config, "checkpoint_loiter");
+}
+
+TEST_CASE(checkpoint, tick_engine_with_several_ticks_per_sync_resumes_bit_exact) {
+    Config config = scenarioConfig();
+    config.TicksPerSync = 8;
+    checkResume<TickEngine>(config, "checkpoint_ticks_per_sync");
+}
+
+TEST_CASE(checkpoint, event_engine_resumes_bit_exact) {
+    Config config = scenarioConfig();
+    config.Engine = 1;
+    checkResume<EventEngine>(config, "checkpoint_event");
+}
+
+// A state that does not match the simulation is refused.
+TEST_CASE(checkpoint, rejects_mismatching_state) {
+    Config config = scenarioConfig();
+    Config fleetConfig = config;
+    UAVFleet fleet;
+    initializeUAVs(fleetConfig, fleet);
+    CommandScheduler scheduler(scenarioCommands(), config.N_uav);
+    MemorySink sink(fleet.size());
+    TickEngine engine(config, fleet, scheduler, { &sink });
+    StateWriter state;
+    engine.saveState(state);
+
+    Config otherDt = config;
+    otherDt.Dt = 0.02;
+    TickEngine other(otherDt, fleet, scheduler, { &sink });
+    StateReader reader(state.data().data(), state.data().size());
+    CHECK(!other.restoreState(reader));
+
+    std::vector<char> truncated(state.data().begin(), state.data().begin() + state.data().size() / 2);
+    StateReader truncatedReader(truncated.data(), truncated.size());
+    CHECK(!engine.restoreState(truncatedReader));
+}
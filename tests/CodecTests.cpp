@@ -0,0 +1,171 @@
+#include "TestHarness.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "CompressedTrajectoryReader.h"
+#include "CompressedTrajectoryWriter.h"
+#include "TrajectoryCodec.h"
+
+namespace {
+    // A loiter followed by a transit and a few jumps, with every mode bit in use.
+    std::vector<TrajectorySample> makeTrajectory(std::size_t count, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> jump(-5000.0, 5000.0);
+        std::vector<TrajectorySample> samples;
+        double x = 1234.5678, y = -987.654321, azimuth = 0.1;
+        for (std::size_t k = 0; k < count; ++k) {
+            if (k < count / 2) {
+                azimuth = std::fmod(azimuth + 0.003, 2.0 * 3.14159265358979323846);
+            }
+            x += 25.0 * std::cos(azimuth) * 0.01;
+            y += 25.0 * std::sin(azimuth) * 0.01;
+            if (k % 997 == 996) {
+                x += jump(rng);
+                y += jump(rng);
+            }
+            samples.push_back({ 0.01 * static_cast<double>(k + 1), x, y, azimuth, 150.0 + 0.001 * k,
+                                static_cast<std::uint8_t>(k % 8) });
+        }
+        return samples;
+    }
+
+    // Decoded values are the samples rounded to the resolution of the file.
+    std::size_t countOffResolution(const std::vector<TrajectorySample>& original, const std::vector<TrajectorySample>& decoded,
+                                   const TrajectoryResolution& resolution) {
+        std::size_t off = 0;
+        for (std::size_t k = 0; k < original.size() && k < decoded.size(); ++k) {
+            const TrajectorySample& a = original[k];
+            const TrajectorySample& b = decoded[k];
+            bool close = std::abs(a.time - b.time) <= resolution.time * 0.5000001
+                && std::abs(a.x - b.x) <= resolution.position * 0.5000001
+                && std::abs(a.y - b.y) <= resolution.position * 0.5000001
+                && std::abs(a.z - b.z) <= resolution.position * 0.5000001
+                && std::abs(a.azimuth - b.azimuth) <= resolution.angle * 0.5000001;
+            off += close ? 0 : 1;
+        }
+        return off;
+    }
+
+    bool sameSample(const TrajectorySample& a, const TrajectorySample& b) {
+        return a.time == b.time && a.x == b.x && a.y == b.y && a.azimuth == b.azimuth && a.z == b.z && a.mode == b.mode;
+    }
+
+    // Splits an encoded block into its header and payload and decodes it.
+    bool decode(const std::string& block, const TrajectoryResolution& resolution, std::vector<TrajectorySample>& samples) {
+        CompressedBlockHeader header;
+        if (block.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, block.data(), sizeof(header));
+        if (block.size() != sizeof(header) + header.payloadBytes) {
+            return false;
+        }
+        return decodeTrajectoryBlock(header, block.data() + sizeof(header), resolution, samples);
+    }
+}
+
+// encode -> decode gives every sample back within half a quantization step, and decoded samples
+// encode to the same bytes again.
+TEST_CASE(codec, block_round_trip) {
+    const TrajectoryResolution resolution;
+    std::vector<TrajectorySample> original = makeTrajectory(5000, 1);
+    TrajectoryBlockEncoder encoder;
+    for (const TrajectorySample& sample : original) {
+        encoder.add(sample, resolution);
+    }
+    CHECK_EQUAL(encoder.size(), 5000u);
+    std::string block;
+    CompressedBlockIndexEntry entry;
+    CHECK(encoder.finishBlock(7, block, entry));
+    CHECK_EQUAL(entry.uav, 7u);
+    CHECK_EQUAL(entry.sampleCount, 5000u);
+    CHECK_EQUAL(encoder.size(), 0u);
+    CHECK(!encoder.finishBlock(7, block, entry));
+
+    std::vector<TrajectorySample> decoded;
+    CHECK(decode(block, resolution, decoded));
+    CHECK_EQUAL(decoded.size(), original.size());
+    CHECK_EQUAL(countOffResolution(original, decoded, resolution), 0u);
+    CHECK(block.size() < original.size() * 5 * sizeof(double) / 4);
+
+    for (const TrajectorySample& sample : decoded) {
+        encoder.add(sample, resolution);
+    }
+    std::string again;
+    CHECK(encoder.finishBlock(7, again, entry));
+    CHECK(again == block);
+
+    CHECK(!decode(block.substr(0, block.size() - 1), resolution, decoded));
+}
+
+// Coarser steps still keep every value within half a step.
+TEST_CASE(codec, coarse_resolution_round_trip) {
+    TrajectoryResolution resolution;
+    resolution.time = 0.001;
+    resolution.position = 0.25;
+    resolution.angle = 0.01;
+    std::vector<TrajectorySample> original = makeTrajectory(3000, 2);
+    TrajectoryBlockEncoder encoder;
+    for (const TrajectorySample& sample : original) {
+        encoder.add(sample, resolution);
+    }
+    std::string block;
+    CompressedBlockIndexEntry entry;
+    CHECK(encoder.finishBlock(0, block, entry));
+    std::vector<TrajectorySample> decoded;
+    CHECK(decode(block, resolution, decoded));
+    CHECK_EQUAL(decoded.size(), original.size());
+    CHECK_EQUAL(countOffResolution(original, decoded, resolution), 0u);
+}
+
+// A file written by CompressedTrajectoryWriter reads back whole and by time window.
+TEST_CASE(codec, file_round_trip) {
+    std::filesystem::path directory = testDirectory("codec_file");
+    const std::string filename = (directory / "UAVTrajectories.uavz").string();
+    const TrajectoryResolution resolution;
+    const std::size_t count = 2500;
+    std::vector<std::vector<TrajectorySample>> original = {
+        makeTrajectory(count, 3), makeTrajectory(count, 4), makeTrajectory(count, 5) };
+    {
+        CompressedTrajectoryWriter writer(256, resolution);
+        CHECK(writer.open(filename, { 1, 2, 5 }));
+        for (std::size_t k = 0; k < count; ++k) {
+            for (std::size_t i = 0; i < original.size(); ++i) {
+                writer.record(i, original[i][k]);
+            }
+            if (k % 100 == 99) {
+                writer.synchronize(original[0][k].time);
+            }
+        }
+        writer.close();
+    }
+
+    CompressedTrajectoryReader reader;
+    CHECK(reader.open(filename));
+    CHECK_EQUAL(reader.uavCount(), 3u);
+    CHECK(reader.getNums() == std::vector<int>({ 1, 2, 5 }));
+    for (std::size_t i = 0; i < original.size(); ++i) {
+        std::vector<TrajectorySample> decoded;
+        CHECK(reader.read(i, decoded));
+        CHECK_EQUAL(decoded.size(), count);
+        CHECK_EQUAL(countOffResolution(original[i], decoded, resolution), 0u);
+
+        std::vector<TrajectorySample> window;
+        CHECK(reader.read(i, 7.5, 12.25, window));
+        std::vector<TrajectorySample> expected;
+        for (const TrajectorySample& sample : decoded) {
+            if (sample.time >= 7.5 && sample.time <= 12.25) {
+                expected.push_back(sample);
+            }
+        }
+        CHECK(!expected.empty());
+        CHECK_EQUAL(window.size(), expected.size());
+        std::size_t mismatches = 0;
+        for (std::size_t k = 0; k < window.size() && k < expected.size(); ++k) {
+            mismatches += sameSample(window[k], expected[k]) ? 0 : 1;
+        }
+        CHECK_EQUAL(mismatches, 0u);
+    }
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,123 @@
+#include "TestHarness.h"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include "CommandFile.h"
+
+namespace {
+    bool sameValue(double a, double b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+
+    bool sameCommand(const Command& a, const Command& b) {
+        return a.time == b.time && a.num == b.num && a.x == b.x && a.y == b.y && sameValue(a.z, b.z) && sameValue(a.v, b.v);
+    }
+
+    bool sameCommands(const std::vector<Command>& a, const std::vector<Command>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t k = 0; k < a.size(); ++k) {
+            if (!sameCommand(a[k], b[k])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(commandfile, parses_a_line) {
+    const std::string line = "12.5 3 -100.25 2e3 150 30.5\n";
+    Command command;
+    CHECK(parseCommandLine(line.data(), line.data() + line.size(), command));
+    CHECK(command.time == 12.5 && command.num == 3 && command.x == -100.25 && command.y == 2000.0);
+    CHECK(command.z == 150.0 && command.v == 30.5);
+
+    const std::string planar = "1 2 3 4";
+    CHECK(parseCommandLine(planar.data(), planar.data() + planar.size(), command));
+    CHECK(command.time == 1.0 && command.num == 2 && command.x == 3.0 && command.y == 4.0);
+    CHECK(std::isnan(command.z) && std::isnan(command.v));
+
+    for (const std::string& bad : { std::string("1 2 3"), std::string("# 1 2 3 4"), std::string(""), std::string("time num x y") }) {
+        CHECK(!parseCommandLine(bad.data(), bad.data() + bad.size(), command));
+    }
+}
+
+// A text file and its binary conversion give the scheduler the same commands for every UAV,
+// ties included.
+TEST_CASE(commandfile, text_and_binary_are_equivalent) {
+    std::filesystem::path directory = testDirectory("commandfile_formats");
+    const std::string textFile = (directory / "SimCmds.txt").string();
+    const std::string binaryFile = (directory / "SimCmds.bin").string();
+    {
+        std::ofstream text(textFile);
+        text << "# time num x y [z [v]]\n"
+             << "5 1 100 200\n"
+             << "1.5 2 -300 400 120\n"
+             << "not a command\n"
+             << "\n"
+             << "1.5 2 -350 450 130 25\n"
+             << "0.5 1 10 20\n"
+             << "5 1 110 210\n"
+             << "3 4 1e3 -2.5e2 0 40\n"
+             << "2 3 0 0\n"
+             << "7 9 1 1\n"
+             << "2 3 5 5";
+    }
+    std::vector<Command> fromText;
+    CHECK(loadCommandFile(textFile, fromText, 1));
+    CHECK_EQUAL(fromText.size(), 9u);
+    CHECK(writeCommandFile(binaryFile, fromText));
+    std::vector<Command> fromBinary;
+    CHECK(loadCommandFile(binaryFile, fromBinary, 1));
+    CHECK_EQUAL(fromBinary.size(), fromText.size());
+
+    CommandScheduler textScheduler(fromText, 5);
+    CommandScheduler binaryScheduler(fromBinary, 5);
+    for (std::size_t i = 0; i < 5; ++i) {
+        CHECK(sameCommands(textScheduler.commandsOf(i), binaryScheduler.commandsOf(i)));
+        for (double time : { 1.0, 1.6, 2.5, 4.0, 6.0 }) {
+            const Command* a = textScheduler.advance(i, time);
+            const Command* b = binaryScheduler.advance(i, time);
+            CHECK((a == nullptr && b == nullptr) || (a != nullptr && b != nullptr && sameCommand(*a, *b)));
+        }
+    }
+    const Command* tie = textScheduler.activeCommand(1);
+    CHECK(tie != nullptr && tie->x == -300.0);
+    tie = textScheduler.activeCommand(0);
+    CHECK(tie != nullptr && tie->x == 100.0);
+    std::filesystem::remove_all(directory);
+}
+
+// A file large enough to be split into chunks parses to the same list, in file order, with any
+// number of threads.
+TEST_CASE(commandfile, parallel_parse_keeps_file_order) {
+    std::filesystem::path directory = testDirectory("commandfile_parallel");
+    const std::string textFile = (directory / "SimCmds.txt").string();
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> uav(1, 1000);
+    std::uniform_real_distribution<double> position(-50000.0, 50000.0);
+    std::size_t lines = 0;
+    {
+        std::ofstream text(textFile);
+        text.precision(10);
+        while (text.tellp() < 5 * (1 << 20)) {
+            text << 0.01 * static_cast<double>(lines % 9000) << " " << uav(rng) << " " << position(rng) << " " << position(rng);
+            if (lines % 3 == 0) {
+                text << " " << 100.0 + static_cast<double>(lines % 50);
+            }
+            text << (lines % 1000 == 0 ? "\n# comment\n" : "\n");
+            ++lines;
+        }
+    }
+    std::vector<Command> serial;
+    CHECK(loadCommandFile(textFile, serial, 1));
+    CHECK_EQUAL(serial.size(), lines);
+    for (std::size_t threads : { 2, 3, 4 }) {
+        std::vector<Command> parallel;
+        CHECK(loadCommandFile(textFile, parallel, threads));
+        CHECK(sameCommands(parallel, serial));
+    }
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,54 @@
+#include "TestHarness.h"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include "CommandStream.h"
+
+namespace {
+    // Drains the stream until it handled `expected` commands in total (added or ignored), or two
+    // seconds passed. Returns the number of commands handled.
+    std::size_t drainUntil(CommandStream& stream, CommandScheduler& scheduler, std::size_t expected) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (stream.getReceivedCount() + stream.getIgnoredCount() < expected && std::chrono::steady_clock::now() < deadline) {
+            stream.drainInto(scheduler, 0.0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return stream.getReceivedCount() + stream.getIgnoredCount();
+    }
+}
+
+// A line is only parsed once its newline arrived, so a command written in two pieces is not
+// picked up half-way ("2.0 1 300 4" would be a valid command on its own).
+TEST_CASE(commandstream, waits_for_complete_lines) {
+    std::filesystem::path directory = testDirectory("commandstream");
+    std::filesystem::path filename = directory / "Stream.txt";
+    {
+        std::ofstream file(filename, std::ios_base::binary);
+        file << "1.0 2 10 20\n2.0 1 300 4";
+    }
+    CommandScheduler scheduler({}, 2);
+    CommandStream stream(16, 0.001);
+    CHECK(stream.open(filename.string()));
+    CHECK_EQUAL(drainUntil(stream, scheduler, 1), 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_EQUAL(stream.drainInto(scheduler, 0.0), 0u);
+    CHECK(scheduler.commandsOf(0).empty());
+
+    {
+        std::ofstream file(filename, std::ios_base::binary | std::ios_base::app);
+        file << "00\n5 3 0 0\n";
+    }
+    // The command of UAV 3 is ignored: the fleet has two UAVs
+    CHECK_EQUAL(drainUntil(stream, scheduler, 3), 3u);
+    stream.close();
+    CHECK_EQUAL(stream.getReceivedCount(), 2u);
+    CHECK_EQUAL(stream.getIgnoredCount(), 1u);
+
+    CHECK_EQUAL(scheduler.commandsOf(0).size(), 1u);
+    const Command* active = scheduler.advance(0, 2.5);
+    CHECK(active != nullptr && active->x == 300.0 && active->y == 400.0);
+    active = scheduler.advance(1, 1.5);
+    CHECK(active != nullptr && active->x == 10.0 && active->y == 20.0);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,134 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include "EventEngine.h"
+#include "Manager.h"
+#include "TickEngine.h"
+
+namespace {
+    // Keeps every recorded sample in memory.
+    class MemorySink : public TrajectorySink {
+    public:
+        explicit MemorySink(std::size_t count) : samples(count) {}
+        void record(std::size_t index, const TrajectorySample& sample) override { samples[index].push_back(sample); }
+        void flush() override {}
+
+        std::vector<std::vector<TrajectorySample>> samples;
+    };
+
+    Config scenarioConfig() {
+        Config config = Config();
+        config.Dt = 0.01;
+        config.N_uav = 6;
+        config.R = 80.0;
+        config.V0 = 25.0;
+        config.Az = 0.3;
+        config.TimeLim = 30.0;
+        config.Threads = 1;
+        return config;
+    }
+
+    // Whole-second commands (the tick engine starts a command at the first whole second after its
+    // time): transits from far away, a start inside the loiter circle, retargets and one UAV
+    // that never gets a command.
+    std::vector<Command> scenarioCommands() {
+        std::vector<Command> commands;
+        auto add = [&commands](double time, int num, double x, double y) {
+            Command command;
+            command.time = time;
+            command.num = num;
+            command.x = x;
+            command.y = y;
+            commands.push_back(command);
+        };
+        add(1.0, 1, 400.0, 300.0);
+        add(2.0, 2, 50.0, -40.0);
+        add(1.0, 3, -300.0, 200.0);
+        add(12.0, 3, 100.0, 100.0);
+        add(3.0, 4, 0.0, 0.0);
+        add(5.0, 5, 600.0, 0.0);
+        add(16.0, 5, 600.0, 300.0);
+        return commands;
+    }
+
+    template <typename Engine>
+    std::vector<std::vector<TrajectorySample>> run(const Config& config) {
+        Config fleetConfig = config;
+        UAVFleet fleet;
+        initializeUAVs(fleetConfig, fleet);
+        CommandScheduler scheduler(scenarioCommands(), config.N_uav);
+        MemorySink sink(fleet.size());
+        Engine engine(config, fleet, scheduler, { &sink });
+        engine.run();
+        return sink.samples;
+    }
+
+    bool sameSamples(const std::vector<std::vector<TrajectorySample>>& a, const std::vector<std::vector<TrajectorySample>>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i].size() != b[i].size()) {
+                return false;
+            }
+            for (std::size_t s = 0; s < a[i].size(); ++s) {
+                const TrajectorySample& x = a[i][s];
+                const TrajectorySample& y = b[i][s];
+                if (x.time != y.time || x.x != y.x || x.y != y.y || x.azimuth != y.azimuth || x.z != y.z || x.mode != y.mode) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// The closed-form segments of the event engine follow the stepped trajectories of the tick engine
+// at every step time, within a few steps of flight (the tick engine reaches the circle and moves
+// around it in steps of Dt).
+TEST_CASE(engine, event_engine_follows_tick_engine) {
+    Config config = scenarioConfig();
+    std::vector<std::vector<TrajectorySample>> tick = run<TickEngine>(config);
+    config.Engine = 1;
+    std::vector<std::vector<TrajectorySample>> event = run<EventEngine>(config);
+
+    CHECK_EQUAL(event.size(), tick.size());
+    double largestGap = 0.0;
+    std::size_t compared = 0;
+    for (std::size_t i = 0; i < tick.size() && i < event.size(); ++i) {
+        // The event engine also records the time limit itself
+        CHECK_EQUAL(event[i].size(), tick[i].size() + 1);
+        for (std::size_t s = 0; s < tick[i].size() && s < event[i].size(); ++s) {
+            const TrajectorySample& stepped = tick[i][s];
+            const TrajectorySample& exact = event[i][s];
+            CHECK_NEAR(stepped.time, exact.time, 1e-6);
+            largestGap = std::max(largestGap, std::hypot(stepped.x - exact.x, stepped.y - exact.y));
+            ++compared;
+        }
+        if (!tick[i].empty() && event[i].size() == tick[i].size() + 1) {
+            const std::uint8_t standby = TrajectorySample::StandbyMode;
+            CHECK_EQUAL(event[i][tick[i].size() - 1].mode & standby, tick[i].back().mode & standby);
+        }
+    }
+    CHECK(compared > 0);
+    CHECK(largestGap > 0.0);
+    CHECK_NEAR(largestGap, 0.0, 4 * config.V0 * config.Dt);
+}
+
+// Each UAV is stepped by one thread from its own state, so the trajectories are the same bit for
+// bit whatever the number of threads and the ticks between two synchronizations.
+TEST_CASE(engine, output_does_not_depend_on_thread_count) {
+    Config config = scenarioConfig();
+    std::vector<std::vector<TrajectorySample>> reference = run<TickEngine>(config);
+    config.Threads = 3;
+    CHECK(sameSamples(run<TickEngine>(config), reference));
+    config.TicksPerSync = 16;
+    CHECK(sameSamples(run<TickEngine>(config), reference));
+
+    config = scenarioConfig();
+    config.Engine = 1;
+    reference = run<EventEngine>(config);
+    config.Threads = 3;
+    CHECK(sameSamples(run<EventEngine>(config), reference));
+}
+
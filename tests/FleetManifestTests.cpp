@@ -0,0 +1,74 @@
+#include "TestHarness.h"
+
+#include <fstream>
+#include "FleetManifest.h"
+
+namespace {
+    Config manifestConfig() {
+        Config config = Config();
+        config.Dt = 0.01;
+        config.R = 80.0;
+        config.V0 = 25.0;
+        config.Z0 = 120.0;
+        return config;
+    }
+
+    void writeText(const std::filesystem::path& file, const std::string& content) {
+        std::ofstream output(file, std::ios_base::binary);
+        output << content;
+    }
+}
+
+// Columns left out of a CSV manifest take the configuration values; the binary form of the fleet
+// loads back the same values.
+TEST_CASE(manifest, csv_and_binary) {
+    std::filesystem::path directory = testDirectory("manifest_formats");
+    const std::string csvFile = (directory / "Fleet.csv").string();
+    const std::string binaryFile = (directory / "Fleet.bin").string();
+    writeText(csvFile, "X0,Y0,V0,Az\n# comment\n0,0,25,0.5\n\n100.5,-50,30,1\n-20,7.25,12,2\n");
+    const Config config = manifestConfig();
+    UAVFleet fleet;
+    CHECK(loadFleetManifest(csvFile, config, fleet));
+    CHECK_EQUAL(fleet.size(), 3u);
+    if (fleet.size() == 3) {
+        CHECK(fleet.num[2] == 3 && fleet.x[1] == 100.5 && fleet.y[2] == 7.25 && fleet.v[1] == 30.0 && fleet.azimuth[2] == 2.0);
+        CHECK(fleet.r[0] == 80.0 && fleet.z[1] == 120.0);
+    }
+
+    CHECK(writeFleetManifest(binaryFile, fleet));
+    UAVFleet binary;
+    CHECK(loadFleetManifest(binaryFile, config, binary));
+    CHECK(binary.x == fleet.x && binary.y == fleet.y && binary.z == fleet.z);
+    CHECK(binary.v == fleet.v && binary.azimuth == fleet.azimuth && binary.r == fleet.r && binary.num == fleet.num);
+    std::filesystem::remove_all(directory);
+}
+
+// Manifests without UAVs, or with a speed or turning radius that is not positive, are refused,
+// also when the value comes from the configuration.
+TEST_CASE(manifest, rejects_empty_fleets_and_invalid_envelopes) {
+    std::filesystem::path directory = testDirectory("manifest_invalid");
+    const Config config = manifestConfig();
+    const std::pair<const char*, const char*> invalid[] = {
+        { "header_only.csv", "X0,Y0,V0,R\n# no UAV\n" },
+        { "zero_speed.csv", "X0,Y0,V0,R\n0,0,25,80\n0,0,0,80\n" },
+        { "negative_radius.csv", "X0,Y0,V0,R\n0,0,25,-1\n" },
+        { "zero_radius.csv", "X0,Y0,R\n0,0,0\n" },
+    };
+    for (const auto& manifest : invalid) {
+        UAVFleet fleet;
+        writeText(directory / manifest.first, manifest.second);
+        CHECK(!loadFleetManifest((directory / manifest.first).string(), config, fleet));
+    }
+
+    Config noSpeed = config;
+    noSpeed.V0 = 0.0;
+    writeText(directory / "default_speed.csv", "X0,Y0\n0,0\n");
+    UAVFleet fleet;
+    CHECK(!loadFleetManifest((directory / "default_speed.csv").string(), noSpeed, fleet));
+    CHECK(loadFleetManifest((directory / "default_speed.csv").string(), config, fleet));
+
+    UAVFleet empty;
+    CHECK(writeFleetManifest((directory / "empty.bin").string(), empty));
+    CHECK(!loadFleetManifest((directory / "empty.bin").string(), config, fleet));
+    std::filesystem::remove_all(directory);
+}
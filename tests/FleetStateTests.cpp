@@ -0,0 +1,55 @@
+#include "TestHarness.h"
+
+#include <cmath>
+#include <random>
+#include "Manager.h"
+#include "TickEngine.h"
+
+namespace {
+    // 40 UAVs taking 300 random commands over 20 s, like the sample scenario of the README. UAVs 1
+    // to 20 only get commands at whole seconds and move in float in a float build; the others get
+    // fractional times too (loiters restarted every step) and move in double.
+    std::vector<Command> sampleCommands(std::mt19937_64& rng) {
+        std::uniform_real_distribution<double> time(0.5, 19.0);
+        std::uniform_int_distribution<int> uav(1, 40);
+        std::uniform_real_distribution<double> position(-500.0, 500.0);
+        std::vector<Command> commands;
+        for (int k = 0; k < 300; ++k) {
+            Command command;
+            command.num = uav(rng);
+            command.time = command.num <= 20 || k % 10 == 0 ? std::round(time(rng)) : std::round(time(rng) * 1000.0) / 1000.0;
+            command.x = std::round(position(rng) * 10.0) / 10.0;
+            command.y = std::round(position(rng) * 10.0) / 10.0;
+            commands.push_back(command);
+        }
+        return commands;
+    }
+}
+
+// The single precision state follows the double model within centimeters on the sample scenario:
+// it takes the same branches, the UAVs with restarted loiters move in double, and what is left is
+// the rounding of the float azimuth over 20000 loiter steps (about 6 cm here).
+TEST_CASE(fleetstate, float_state_stays_within_centimeters) {
+    std::mt19937_64 rng(25);
+    Config config = Config();
+    config.Dt = 0.001;
+    config.N_uav = 40;
+    config.R = 80.0;
+    config.Y0 = 50.0;
+    config.Z0 = 200.0;
+    config.V0 = 30.0;
+    config.Az = 1.0;
+    config.TimeLim = 20.0;
+    config.PrecisionValidation = true;
+    UAVFleet fleet;
+    initializeUAVs(config, fleet);
+    CommandScheduler scheduler(sampleCommands(rng), config.N_uav);
+    TickEngine engine(config, fleet, scheduler, {});
+    engine.run();
+
+    std::size_t index = 0;
+    double time = 0.0;
+    double divergence = engine.getPrecisionDivergence(index, time);
+    CHECK(divergence > 0.0 && index < 20);
+    CHECK_NEAR(divergence, 0.0, 0.1);
+}
@@ -0,0 +1,101 @@
+#include "TestHarness.h"
+
+#include "TextTrajectoryWriter.h"
+#include "TrajectoryIndex.h"
+
+namespace {
+    const std::size_t sampleCount = 400;
+    const double sampleStep = 0.25; // Times and positions print exactly with two decimals
+
+    TrajectorySample sampleNumber(std::size_t k) {
+        double value = static_cast<double>(k);
+        return { value * sampleStep, 1.5 * value, -0.5 * value, 0.25, 0.0, 0 };
+    }
+
+    // Index of the last sample at or before a time, or sampleCount if there is none.
+    std::size_t lastSampleAt(double time) {
+        std::size_t found = sampleCount;
+        for (std::size_t k = 0; k < sampleCount && sampleNumber(k).time <= time; ++k) {
+            found = k;
+        }
+        return found;
+    }
+
+    // Compares sampleAt() and window() with a linear search over the samples.
+    void checkQueries(const TrajectoryIndex& index) {
+        std::size_t wrongSamples = 0;
+        for (int j = -10; j <= 1010; ++j) {
+            for (double time : { 0.1 * j, sampleStep * j }) {
+                TrajectorySample sample;
+                std::size_t expected = lastSampleAt(time);
+                bool found = index.sampleAt(time, sample);
+                if (expected == sampleCount) {
+                    wrongSamples += found ? 1 : 0;
+                }
+                else {
+                    TrajectorySample reference = sampleNumber(expected);
+                    wrongSamples += found && sample.time == reference.time && sample.x == reference.x
+                        && sample.y == reference.y && sample.azimuth == reference.azimuth ? 0 : 1;
+                }
+            }
+        }
+        CHECK_EQUAL(wrongSamples, 0u);
+
+        const double windows[][2] = { { 0.0, 0.0 }, { 3.1, 3.2 }, { 3.0, 12.5 }, { -5.0, 1.0 }, { 17.3, 64.75 },
+                                      { 99.5, 200.0 }, { 120.0, 130.0 }, { 10.0, 5.0 } };
+        for (const auto& bounds : windows) {
+            std::vector<TrajectorySample> samples;
+            index.window(bounds[0], bounds[1], samples);
+            std::vector<TrajectorySample> expected;
+            for (std::size_t k = 0; k < sampleCount; ++k) {
+                TrajectorySample reference = sampleNumber(k);
+                if (reference.time >= bounds[0] && reference.time <= bounds[1]) {
+                    expected.push_back(reference);
+                }
+            }
+            CHECK_EQUAL(samples.size(), expected.size());
+            std::size_t mismatches = 0;
+            for (std::size_t k = 0; k < samples.size() && k < expected.size(); ++k) {
+                mismatches += samples[k].time == expected[k].time && samples[k].x == expected[k].x
+                    && samples[k].y == expected[k].y ? 0 : 1;
+            }
+            CHECK_EQUAL(mismatches, 0u);
+        }
+    }
+}
+
+// Lookups give the same samples whether the index comes from the file written with the
+// trajectory, is built in memory or comes from writeIndexFile().
+TEST_CASE(index, sample_at_and_window) {
+    std::filesystem::path directory = testDirectory("index");
+    const std::string trajectoryFile = (directory / "UAV1.txt").string();
+    const std::string indexFile = trajectoryIndexFilename(trajectoryFile);
+    {
+        TextTrajectoryWriter writer(4096, 0.0, false, 2.0);
+        CHECK(writer.open({ trajectoryFile }));
+        for (std::size_t k = 0; k < sampleCount; ++k) {
+            writer.record(0, sampleNumber(k));
+        }
+        writer.close();
+    }
+    CHECK(std::filesystem::exists(indexFile));
+
+    TrajectoryIndex written;
+    CHECK(written.open(trajectoryFile));
+    CHECK(written.hasIndexFile());
+    CHECK(written.getEntries().size() >= 40);
+    checkQueries(written);
+
+    std::filesystem::remove(indexFile);
+    TrajectoryIndex built;
+    CHECK(built.open(trajectoryFile, 0.7));
+    CHECK(!built.hasIndexFile());
+    checkQueries(built);
+
+    CHECK(TrajectoryIndex::writeIndexFile(trajectoryFile, 5.0));
+    TrajectoryIndex rewritten;
+    CHECK(rewritten.open(trajectoryFile));
+    CHECK(rewritten.hasIndexFile());
+    checkQueries(rewritten);
+    std::filesystem::remove_all(directory);
+}
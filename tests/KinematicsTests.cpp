@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include "Kinematics.h"
+#include "Manager.h"
+
+namespace {
+    const double pi = 3.14159265358979323846;
+
+    // Magnitude of the heading change between two azimuths, the short way round.
+    double headingChange(double from, double to) {
+        return std::fabs(std::remainder(to - from, 2 * pi));
+    }
+}
+
+// A UAV sent to a target behind it turns at no more than v / R, climbs at no more than
+// MaxClimbRate and accelerates at no more than MaxAcceleration, then loiters at
+// LoiterRadiusFactor * R on the commanded altitude and speed. A UAV without a command keeps
+// flying straight.
+TEST_CASE(kinematics, turn_climb_and_acceleration_limits) {
+    Config config = Config();
+    config.Dt = 0.01;
+    config.N_uav = 2;
+    config.R = 50.0;
+    config.X0 = 0.0;
+    config.Y0 = 0.0;
+    config.Z0 = 100.0;
+    config.V0 = 20.0;
+    config.Az = 0.0;
+    config.MotionModel = 1;
+    config.MaxClimbRate = 4.0;
+    config.MaxAcceleration = 1.5;
+    config.LoiterRadiusFactor = 1.2;
+    UAVFleet fleet;
+    CHECK(initializeUAVs(config, fleet));
+    Kinematics kinematics(fleet, config);
+
+    Command command;
+    command.time = 0.5;
+    command.num = 1;
+    command.x = -600.0;
+    command.y = 0.0;
+    command.z = 180.0;
+    command.v = 30.0;
+    kinematics.setCommand(fleet, 0, command);
+
+    const double tolerance = 1e-9;
+    double largestTurnRatio = 0.0;
+    for (int k = 0; k < 12000; ++k) {
+        double azimuth = fleet.azimuth[0];
+        double z = fleet.z[0];
+        double v = fleet.v[0];
+        kinematics.step(fleet, config.Dt, 0, fleet.size());
+        double turnLimit = fleet.v[0] / config.R * config.Dt;
+        largestTurnRatio = std::max(largestTurnRatio, headingChange(azimuth, fleet.azimuth[0]) / turnLimit);
+        CHECK(fleet.z[0] - z <= config.MaxClimbRate * config.Dt + tolerance);
+        CHECK(std::fabs(fleet.v[0] - v) <= config.MaxAcceleration * config.Dt + tolerance);
+        CHECK(fleet.z[0] >= z && fleet.v[0] >= v);
+    }
+    // The heading turns at the full rate at the start, and never faster
+    CHECK_NEAR(largestTurnRatio, 1.0, 1e-6);
+
+    CHECK_EQUAL(fleet.z[0], 180.0);
+    CHECK_EQUAL(fleet.v[0], 30.0);
+    CHECK(fleet.standbyModeFlag[0] != 0);
+    CHECK_NEAR(std::hypot(fleet.x[0] - command.x, fleet.y[0] - command.y), config.LoiterRadiusFactor * config.R, 1.0);
+
+    CHECK_NEAR(fleet.x[1], config.V0 * config.Dt * 12000, 1e-6);
+    CHECK_NEAR(fleet.y[1], 0.0, 1e-9);
+    CHECK_EQUAL(fleet.z[1], config.Z0);
+    CHECK_EQUAL(fleet.v[1], config.V0);
+    CHECK(fleet.standbyModeFlag[1] == 0);
+}
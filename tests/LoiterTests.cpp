@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "Config.h"
+#include "LoiterFastPath.h"
+#include "UAV.h"
+
+// The tolerance stated in LoiterFastPath.h: with the default renormalization interval, the
+// position stays within 1e-9 m of UAV::standbyMode for radii up to 10 km, at every step and over
+// a few hundred re-synchronizations, and the azimuth is bit-identical.
+TEST_CASE(loiter, fast_path_matches_standby_mode) {
+    const std::size_t fleetSize = 1024;
+    const int steps = 20000;
+    const double dt = 0.01;
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    UAVFleet exact(fleetSize);
+    std::vector<double> destX(fleetSize), destY(fleetSize);
+    for (std::size_t i = 0; i < fleetSize; ++i) {
+        exact.num[i] = static_cast<int>(i + 1);
+        exact.v[i] = 10.0 + 40.0 * unit(rng);
+        exact.r[i] = i == 0 ? 10000.0 : 20.0 + 10000.0 * unit(rng) * unit(rng);
+        exact.azimuth[i] = 6.28 * unit(rng);
+        destX[i] = 1000.0 * unit(rng);
+        destY[i] = 1000.0 * unit(rng);
+        exact.standbyModeFlag[i] = 1;
+    }
+    UAVFleet fast = exact;
+    LoiterFastPath loiter(fleetSize, Config().LoiterRenormalizeSteps);
+
+    double maxError = 0.0;
+    std::size_t azimuthMismatches = 0;
+    for (int step = 0; step < steps; ++step) {
+        for (std::size_t i = 0; i < fleetSize; ++i) {
+            UAV uav(exact, i);
+            uav.standbyMode(destX[i], destY[i], dt);
+            loiter.step(fast, i, dt, destX[i], destY[i]);
+            maxError = std::max(maxError, std::hypot(fast.x[i] - exact.x[i], fast.y[i] - exact.y[i]));
+            azimuthMismatches += fast.azimuth[i] != exact.azimuth[i] ? 1 : 0;
+        }
+    }
+    CHECK_NEAR(maxError, 0.0, 1e-9);
+    CHECK_EQUAL(azimuthMismatches, 0u);
+}
+
+// A stale rotation (invalidate) or a changed step angle restarts from the exact position.
+TEST_CASE(loiter, rebuilds_after_invalidate_and_speed_change) {
+    UAVFleet exact(1);
+    exact.num[0] = 1;
+    exact.v[0] = 25.0;
+    exact.r[0] = 300.0;
+    exact.azimuth[0] = 1.0;
+    exact.standbyModeFlag[0] = 1;
+    UAVFleet fast = exact;
+    LoiterFastPath loiter(1, 64);
+    double maxError = 0.0;
+    for (int step = 0; step < 1000; ++step) {
+        if (step == 300) {
+            exact.v[0] = fast.v[0] = 40.0;
+        }
+        if (step == 600) {
+            exact.azimuth[0] = fast.azimuth[0] = 2.5;
+            loiter.invalidate(0);
+        }
+        UAV uav(exact, 0);
+        uav.standbyMode(100.0, -50.0, 0.01);
+        loiter.step(fast, 0, 0.01, 100.0, -50.0);
+        maxError = std::max(maxError, std::hypot(fast.x[0] - exact.x[0], fast.y[0] - exact.y[0]));
+    }
+    CHECK_NEAR(maxError, 0.0, 1e-9);
+}
@@ -0,0 +1,72 @@
+#include "TestHarness.h"
+
+#include "OutputSampler.h"
+
+namespace {
+    const double pi = 3.14159265358979323846;
+
+    // Keeps the samples it receives per UAV.
+    class SampleLog : public TrajectorySink {
+    public:
+        explicit SampleLog(std::size_t fleetSize) : samples(fleetSize) {}
+
+        void record(std::size_t index, const TrajectorySample& sample) override { samples[index].push_back(sample); }
+        void flush() override {}
+
+        std::vector<std::vector<TrajectorySample>> samples;
+    };
+
+    TrajectorySample step(double time, double x, double azimuth) {
+        return { time, x, 0.0, azimuth, 100.0, 0 };
+    }
+}
+
+// An output sample between two steps whose azimuth wraps past 0 turns the short way round and
+// stays within [0, 2 * pi).
+TEST_CASE(sampler, interpolated_azimuth_stays_normalized) {
+    SampleLog log(1);
+    OutputSampler sampler({ &log }, 0.5, { 1 });
+    sampler.record(0, step(0.0, 0.0, 0.1));
+    sampler.record(0, step(1.0, 10.0, 2 * pi - 0.3));
+    CHECK_EQUAL(log.samples[0].size(), 3u);
+    if (log.samples[0].size() == 3) {
+        CHECK_NEAR(log.samples[0][1].azimuth, 2 * pi - 0.1, 1e-12);
+    }
+
+    sampler.record(0, step(2.0, 20.0, 0.5));
+    CHECK_EQUAL(log.samples[0].size(), 5u);
+    for (const TrajectorySample& sample : log.samples[0]) {
+        CHECK(sample.azimuth >= 0.0 && sample.azimuth < 2 * pi);
+    }
+    if (log.samples[0].size() == 5) {
+        CHECK_NEAR(log.samples[0][3].azimuth, 0.1, 1e-12);
+        CHECK_NEAR(log.samples[0][4].azimuth, 0.5, 1e-12);
+    }
+}
+
+// Output samples fall at k * interval, interpolated linearly between the surrounding steps; a UAV
+// with decimation N keeps every N-th of them, the others keep all.
+TEST_CASE(sampler, interpolates_and_decimates) {
+    SampleLog log(2);
+    OutputSampler sampler({ &log }, 0.25, { 1, 3 });
+    for (int k = 0; k <= 10; ++k) {
+        double time = 0.3 * k;
+        sampler.record(0, step(time, 10.0 * time, 1.0));
+        sampler.record(1, step(time, -4.0 * time, 1.0));
+    }
+
+    CHECK_EQUAL(log.samples[0].size(), 13u);
+    for (std::size_t s = 0; s < log.samples[0].size(); ++s) {
+        const TrajectorySample& sample = log.samples[0][s];
+        CHECK_NEAR(sample.time, 0.25 * static_cast<double>(s), 1e-12);
+        CHECK_NEAR(sample.x, 10.0 * sample.time, 1e-9);
+        CHECK_NEAR(sample.azimuth, 1.0, 1e-12);
+    }
+
+    CHECK_EQUAL(log.samples[1].size(), 5u);
+    for (std::size_t s = 0; s < log.samples[1].size(); ++s) {
+        const TrajectorySample& sample = log.samples[1][s];
+        CHECK_NEAR(sample.time, 0.75 * static_cast<double>(s), 1e-12);
+        CHECK_NEAR(sample.x, -4.0 * sample.time, 1e-9);
+    }
+}
@@ -0,0 +1,91 @@
+#include "TestHarness.h"
+
+#include "CommandScheduler.h"
+
+namespace {
+    Command command(double time, int num, double x) {
+        Command result;
+        result.time = time;
+        result.num = num;
+        result.x = x;
+        result.y = 0.0;
+        return result;
+    }
+}
+
+// The active command is the latest one whose time is strictly before the current time.
+TEST_CASE(scheduler, latest_started_command_wins) {
+    CommandScheduler scheduler({ command(1.0, 1, 10.0), command(2.0, 1, 20.0), command(0.5, 2, 30.0) }, 2);
+    CHECK(scheduler.advance(0, 1.0) == nullptr);
+    const Command* active = scheduler.advance(0, 1.5);
+    CHECK(active != nullptr && active->x == 10.0);
+    active = scheduler.advance(0, 2.5);
+    CHECK(active != nullptr && active->x == 20.0);
+    active = scheduler.advance(1, 2.5);
+    CHECK(active != nullptr && active->x == 30.0);
+    CHECK(scheduler.activeCommand(0) == scheduler.advance(0, 2.5));
+}
+
+// Among commands with the same time, the one listed first in the file wins, even when the file
+// is not in time order.
+TEST_CASE(scheduler, first_listed_command_wins_a_tie) {
+    CommandScheduler scheduler({ command(3.0, 1, 5.0), command(1.0, 1, 10.0), command(1.0, 1, 20.0),
+                                 command(1.0, 1, 30.0) }, 1);
+    const Command* active = scheduler.advance(0, 2.0);
+    CHECK(active != nullptr && active->x == 10.0);
+    active = scheduler.advance(0, 4.0);
+    CHECK(active != nullptr && active->x == 5.0);
+    CHECK_EQUAL(scheduler.commandsOf(0).size(), 4u);
+}
+
+// Commands for unknown UAVs or with a time that is not positive are dropped.
+TEST_CASE(scheduler, ignores_commands_that_can_never_start) {
+    CommandScheduler scheduler({ command(1.0, 0, 1.0), command(1.0, 3, 2.0), command(0.0, 1, 3.0),
+                                 command(-1.0, 2, 4.0), command(1.0, 1, 7.0) }, 2);
+    CHECK_EQUAL(scheduler.commandsOf(0).size(), 1u);
+    CHECK(scheduler.commandsOf(1).empty());
+    const Command* active = scheduler.advance(0, 2.0);
+    CHECK(active != nullptr && active->x == 7.0);
+}
+
+// Streamed commands: late times are raised to the current time, a pending command with the same
+// time keeps winning, and active commands never move.
+TEST_CASE(scheduler, insert) {
+    CommandScheduler scheduler({ command(5.0, 1, 50.0) }, 1);
+    CHECK(scheduler.advance(0, 1.0) == nullptr);
+
+    CHECK(scheduler.insert(command(0.5, 1, 1.0), 2.0));
+    CHECK(scheduler.advance(0, 2.0) == nullptr);
+    const Command* active = scheduler.advance(0, 2.1);
+    CHECK(active != nullptr && active->x == 1.0 && active->time == 2.0);
+
+    CHECK(scheduler.insert(command(5.0, 1, 60.0), 2.1));
+    CHECK(scheduler.insert(command(1.0, 1, 70.0), 3.0));
+    active = scheduler.advance(0, 3.1);
+    CHECK(active != nullptr && active->x == 70.0);
+    active = scheduler.advance(0, 5.5);
+    CHECK(active != nullptr && active->x == 50.0);
+    CHECK_EQUAL(scheduler.commandsOf(0).size(), 4u);
+    CHECK(scheduler.commandsOf(0).front().x == 1.0);
+
+    CHECK(!scheduler.insert(command(1.0, 2, 0.0), 0.0));
+    CHECK(!scheduler.insert(command(1.0, 0, 0.0), 0.0));
+    CHECK(!scheduler.insert(command(0.0, 1, 0.0), 0.0));
+}
+
+// A copy shares the commands but has its own cursors; inserting into it leaves the original alone.
+TEST_CASE(scheduler, copies_are_independent) {
+    CommandScheduler original({ command(1.0, 1, 10.0), command(2.0, 1, 20.0) }, 1);
+    CommandScheduler copy = original;
+    const Command* active = copy.advance(0, 1.5);
+    CHECK(active != nullptr && active->x == 10.0);
+    CHECK(original.activeCommand(0) == nullptr);
+
+    CHECK(copy.insert(command(1.8, 1, 15.0), 1.5));
+    CHECK_EQUAL(copy.commandsOf(0).size(), 3u);
+    CHECK_EQUAL(original.commandsOf(0).size(), 2u);
+    active = original.advance(0, 1.9);
+    CHECK(active != nullptr && active->x == 10.0);
+    active = copy.advance(0, 1.9);
+    CHECK(active != nullptr && active->x == 15.0);
+}
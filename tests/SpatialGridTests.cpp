@@ -0,0 +1,67 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include "SpatialGrid.h"
+
+namespace {
+    struct Point {
+        double x, y, z;
+    };
+
+    double distance(const Point& a, const Point& b) {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+    // Compares the grid queries with a brute force search, for distances within a few cells and
+    // far beyond the cell reach of a query.
+    void checkQueries(double cellSize, double spread) {
+        std::mt19937_64 rng(21);
+        std::uniform_real_distribution<double> position(-spread, spread);
+        std::vector<Point> points(300);
+        SpatialGrid grid(cellSize);
+        grid.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            points[i] = { position(rng), position(rng), 100.0 + 0.01 * position(rng) };
+            grid.update(i, points[i].x, points[i].y, points[i].z);
+        }
+        grid.remove(17);
+        for (double range : { 0.5 * cellSize, 3.0 * cellSize, 63.5 * cellSize, 65.0 * cellSize, 1000.0 * cellSize }) {
+            std::vector<std::pair<std::size_t, std::size_t>> expectedPairs;
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                for (std::size_t j = i + 1; j < points.size(); ++j) {
+                    if (i != 17 && j != 17 && distance(points[i], points[j]) < range) {
+                        expectedPairs.push_back({ i, j });
+                    }
+                }
+            }
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            grid.forEachPairWithin(range, [&pairs](std::size_t i, std::size_t j, double) { pairs.push_back({ i, j }); });
+            std::sort(pairs.begin(), pairs.end());
+            CHECK(pairs == expectedPairs);
+
+            const Point center = { 0.3 * spread, -0.2 * spread, 100.0 };
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                if (i != 17 && distance(points[i], center) < range) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<std::size_t> found;
+            grid.within(center.x, center.y, center.z, range, found);
+            std::sort(found.begin(), found.end());
+            CHECK(found == expected);
+        }
+    }
+}
+
+TEST_CASE(grid, queries_match_brute_force) {
+    checkQueries(100.0, 2000.0);
+}
+
+// Queries reaching more than maxReach cells scan the occupied cells instead of the stencil.
+TEST_CASE(grid, queries_beyond_the_cell_reach_match_brute_force) {
+    checkQueries(1.0, 5000.0);
+}
@@ -0,0 +1,105 @@
+#include "TestHarness.h"
+
+#include <fstream>
+#include "SweepRunner.h"
+
+namespace {
+    std::string readFile(const std::filesystem::path& filename) {
+        std::ifstream file(filename, std::ios_base::binary);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    // Splits the summary into its rows and the rows into their fields.
+    std::vector<std::vector<std::string>> readCsv(const std::filesystem::path& filename) {
+        std::vector<std::vector<std::string>> rows;
+        std::istringstream lines(readFile(filename));
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::vector<std::string> fields;
+            std::istringstream iss(line);
+            std::string field;
+            while (std::getline(iss, field, ',')) {
+                fields.push_back(field);
+            }
+            rows.push_back(fields);
+        }
+        return rows;
+    }
+}
+
+// The runs are the grid points (last parameter fastest) times the command sets times the samples;
+// every run gets the values of its grid point and its own random draws, whatever the threads.
+TEST_CASE(sweep, grid_and_run_indexing) {
+    std::filesystem::path directory = testDirectory("sweep");
+    {
+        std::ofstream file(directory / "Sweep.txt");
+        file << "V0=20:30:10\nR=50,100\nAz=uniform(0,1)\nSamples=2\nSeed=7\nSweepThreads=1\n";
+    }
+    SweepSpec spec;
+    CHECK(readSweepSpec((directory / "Sweep.txt").string(), spec));
+    CHECK_EQUAL(spec.parameters.size(), 3u);
+
+    Config base = Config();
+    base.Dt = 0.1;
+    base.N_uav = 2;
+    base.X0 = 0.0;
+    base.Y0 = 0.0;
+    base.Z0 = 100.0;
+    base.V0 = 1.0;
+    base.R = 1.0;
+    base.Az = 0.0;
+    base.TimeLim = 5.0;
+    Command command;
+    command.time = 1.0;
+    command.num = 1;
+    command.x = 500.0;
+    command.y = 0.0;
+    std::vector<std::vector<Command>> commandSets = { { command }, {} };
+
+    SweepRunner runner(base, spec, commandSets);
+    CHECK_EQUAL(runner.getRunCount(), 16u);
+    CHECK(runner.run((directory / "Summary.csv").string()));
+
+    std::vector<std::vector<std::string>> rows = readCsv(directory / "Summary.csv");
+    CHECK_EQUAL(rows.size(), 33u);
+    if (rows.size() == 33) {
+        std::vector<std::string> header = { "run", "V0", "R", "Az", "commands", "num", "time_to_standby",
+                                            "path_length", "final_x", "final_y", "final_azimuth" };
+        CHECK(rows[0] == header);
+    }
+    std::vector<double> draws;
+    for (std::size_t row = 1; row < rows.size(); ++row) {
+        const std::vector<std::string>& fields = rows[row];
+        CHECK_EQUAL(fields.size(), 11u);
+        if (fields.size() != 11) {
+            continue;
+        }
+        std::size_t run = (row - 1) / 2;
+        CHECK_EQUAL(fields[0], std::to_string(run));
+        CHECK_EQUAL(fields[5], std::to_string((row - 1) % 2 + 1));
+        std::size_t gridPoint = run / 4;
+        double v0 = gridPoint / 2 == 0 ? 20.0 : 30.0;
+        CHECK_EQUAL(std::stod(fields[1]), v0);
+        CHECK_EQUAL(std::stod(fields[2]), gridPoint % 2 == 0 ? 50.0 : 100.0);
+        CHECK_EQUAL(fields[4], std::to_string(run / 2 % 2));
+        double az = std::stod(fields[3]);
+        CHECK(az >= 0.0 && az < 1.0);
+        if ((row - 1) % 2 == 0) {
+            draws.push_back(az);
+        }
+        // Every UAV flies at V0 the whole run, straight or towards the target
+        CHECK_NEAR(std::stod(fields[7]), v0 * base.TimeLim, 0.01);
+    }
+    for (std::size_t run = 1; run < draws.size(); ++run) {
+        CHECK(draws[run] != draws[run - 1]);
+    }
+
+    // The draws belong to the run, not to the thread that executes it
+    spec.threads = 3;
+    SweepRunner parallel(base, spec, commandSets);
+    CHECK(parallel.run((directory / "Parallel.csv").string()));
+    CHECK(readFile(directory / "Parallel.csv") == readFile(directory / "Summary.csv"));
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,68 @@
+#include "TestHarness.h"
+
+#include <fstream>
+#include <limits>
+#include "TelemetryRecorder.h"
+
+namespace {
+    TrajectorySample sampleAt(double time, double x) {
+        return { time, x, 2.0, 0.5, 100.0, TrajectorySample::StandbyMode };
+    }
+
+    std::vector<std::string> readLines(const std::filesystem::path& filename) {
+        std::vector<std::string> lines;
+        std::ifstream file(filename);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+// A dump holds the last `capacity` samples of every UAV, oldest first, and is written at the
+// synchronization point after the request. A trigger dump waits for the post-trigger time.
+TEST_CASE(telemetry, dumps_the_last_samples_of_every_uav) {
+    std::filesystem::path directory = testDirectory("telemetry");
+    std::filesystem::path previousDirectory = std::filesystem::current_path();
+    std::filesystem::current_path(directory);
+    {
+        TelemetryRecorder recorder({ 3, 7 }, 4, 1.0);
+        CHECK_EQUAL(TelemetryRecorder::capacityFor(1.0, 0.5), 3u);
+        for (int k = 0; k < 6; ++k) {
+            recorder.record(0, sampleAt(k, 10.0 * k));
+        }
+        recorder.record(1, sampleAt(0.0, -1.0));
+        recorder.record(1, sampleAt(1.0, -2.0));
+
+        recorder.requestDump();
+        CHECK(!std::filesystem::exists(directory / "UAVRecorder_1_demand.txt"));
+        recorder.synchronize(5.0);
+        std::vector<std::string> lines = readLines(directory / "UAVRecorder_1_demand.txt");
+        std::vector<std::string> expected = {
+            "# reason=demand time=5.00 capacity=4",
+            "# num time x y z azimuth mode",
+            "3 2.00 20.00 2.00 100.00 0.50 1",
+            "3 3.00 30.00 2.00 100.00 0.50 1",
+            "3 4.00 40.00 2.00 100.00 0.50 1",
+            "3 5.00 50.00 2.00 100.00 0.50 1",
+            "7 0.00 -1.00 2.00 100.00 0.50 1",
+            "7 1.00 -2.00 2.00 100.00 0.50 1"
+        };
+        CHECK(lines == expected);
+        CHECK_EQUAL(recorder.bytesWritten(), static_cast<std::uint64_t>(std::filesystem::file_size(directory / "UAVRecorder_1_demand.txt")));
+
+        recorder.record(0, sampleAt(6.0, std::numeric_limits<double>::quiet_NaN()));
+        recorder.synchronize(6.5);
+        CHECK(!std::filesystem::exists(directory / "UAVRecorder_2_trigger.txt"));
+        recorder.synchronize(7.0);
+        lines = readLines(directory / "UAVRecorder_2_trigger.txt");
+        CHECK_EQUAL(lines.size(), 8u);
+        if (lines.size() == 8) {
+            CHECK_EQUAL(lines[0], std::string("# reason=trigger time=7.00 capacity=4"));
+            CHECK_EQUAL(lines[5].substr(0, 7), std::string("3 6.00 "));
+        }
+    }
+    std::filesystem::current_path(previousDirectory);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef TESTHARNESS_H
+#define TESTHARNESS_H
+
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal test registry for the ctest suites.
+// Every TEST_CASE(suite, name) registers a function; `UAVSimTests <suite>` runs the cases of one
+// suite (every suite without argument) and exits with 1 if a check failed. A failed check is
+// reported with its file and line and the case goes on, so one run shows every failure.
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*function)();
+};
+
+std::vector<TestCase>& testCases();
+
+struct TestRegistration {
+    TestRegistration(const char* suite, const char* name, void (*function)());
+};
+
+/**
+* Records a failed check of the running case.
+*/
+void reportFailure(const char* file, int line, const std::string& message);
+
+/**
+* Returns an empty scratch directory for the running case, under the system temporary directory.
+*
+* @param name A name unique among the cases.
+*/
+std::filesystem::path testDirectory(const std::string& name);
+
+#define TEST_CASE(suite, name) \
+    static void suite##_##name(); \
+    static const TestRegistration suite##_##name##_registration(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            reportFailure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        const auto& checkActual = (actual); \
+        const auto& checkExpected = (expected); \
+        if (!(checkActual == checkExpected)) { \
+            std::ostringstream checkMessage; \
+            checkMessage << #actual << " == " << #expected << " (" << checkActual << " vs " << checkExpected << ")"; \
+            reportFailure(__FILE__, __LINE__, checkMessage.str()); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const double checkActual = (actual); \
+        const double checkExpected = (expected); \
+        if (!(std::abs(checkActual - checkExpected) <= (tolerance))) { \
+            std::ostringstream checkMessage; \
+            checkMessage.precision(17); \
+            checkMessage << #actual << " ~ " << #expected << " (" << checkActual << " vs " << checkExpected \
+                << ", tolerance " << (tolerance) << ")"; \
+            reportFailure(__FILE__, __LINE__, checkMessage.str()); \
+        } \
+    } while (0)
+
+#endif // TESTHARNESS_H
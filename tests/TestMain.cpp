@@ -0,0 +1,58 @@
+#include "TestHarness.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const TestCase* runningCase = nullptr;
+    int failedChecks = 0;
+}
+
+std::vector<TestCase>& testCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+TestRegistration::TestRegistration(const char* suite, const char* name, void (*function)()) {
+    testCases().push_back({ suite, name, function });
+}
+
+// Records a failed check of the running case.
+void reportFailure(const char* file, int line, const std::string& message) {
+    ++failedChecks;
+    std::cerr << file << ":" << line << ": " << runningCase->suite << "." << runningCase->name
+        << ": check failed: " << message << std::endl;
+}
+
+// Returns an empty scratch directory for the running case.
+std::filesystem::path testDirectory(const std::string& name) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("uavsim_tests_" + name);
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+// Usage: UAVSimTests [<suite>]
+int main(int argc, char* argv[]) {
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    int ran = 0;
+    int failedCases = 0;
+    for (const TestCase& test : testCases()) {
+        if (suite != nullptr && std::strcmp(test.suite, suite) != 0) {
+            continue;
+        }
+        runningCase = &test;
+        int failedBefore = failedChecks;
+        test.function();
+        ++ran;
+        bool passed = failedChecks == failedBefore;
+        failedCases += passed ? 0 : 1;
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << test.suite << "." << test.name << std::endl;
+    }
+    if (ran == 0) {
+        std::cerr << "Error: No test case in suite " << (suite != nullptr ? suite : "(all)") << std::endl;
+        return 1;
+    }
+    std::cout << ran - failedCases << " of " << ran << " test cases passed" << std::endl;
+    return failedCases == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "TestHarness.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include "BinaryTrajectoryWriter.h"
+#include "TextTrajectoryWriter.h"
+
+namespace {
+    std::string readFile(const std::filesystem::path& filename) {
+        std::ifstream file(filename, std::ios_base::binary);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    // Samples with rounding cases, negative values that round to "-0.00" and large coordinates.
+    std::vector<TrajectorySample> testSamples(std::uint64_t seed) {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> coordinate(-5000.0, 5000.0);
+        std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+        std::vector<TrajectorySample> samples;
+        for (int k = 0; k < 200; ++k) {
+            double time = 0.01 * (k + 1);
+            samples.push_back({ time, coordinate(random), coordinate(random), angle(random), coordinate(random) + 5000.0, 0 });
+        }
+        samples[3].x = -0.004;
+        samples[4].x = 0.125;
+        samples[5].y = 2.675;
+        samples[6].y = 1e9 + 0.005;
+        samples[7].azimuth = 0.0;
+        return samples;
+    }
+
+    // The text of a UAV file as the original writer produced it, through a stream in fixed notation.
+    std::string streamedText(const std::vector<TrajectorySample>& samples, bool altitude) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2);
+        for (const TrajectorySample& sample : samples) {
+            text << sample.time << " " << sample.x << " " << sample.y << " " << sample.azimuth;
+            if (altitude) {
+                text << " " << sample.z;
+            }
+            text << "\n";
+        }
+        return text.str();
+    }
+}
+
+// The buffered writer produces byte for byte the text of the original stream output, whatever the
+// buffer size and the time threshold, with and without the altitude column.
+TEST_CASE(writer, text_matches_stream_output) {
+    std::filesystem::path directory = testDirectory("writer_text");
+    std::vector<TrajectorySample> first = testSamples(1);
+    std::vector<TrajectorySample> second = testSamples(2);
+    for (bool altitude : { false, true }) {
+        for (std::size_t flushBytes : { std::size_t(1), std::size_t(100), std::size_t(65536) }) {
+            std::vector<std::string> filenames = { (directory / "UAV1.txt").string(), (directory / "UAV2.txt").string() };
+            {
+                TextTrajectoryWriter writer(flushBytes, 0.3, altitude);
+                CHECK(writer.open(filenames));
+                for (std::size_t k = 0; k < first.size(); ++k) {
+                    writer.record(0, first[k]);
+                    writer.record(1, second[k]);
+                }
+                writer.close();
+                CHECK_EQUAL(writer.bytesWritten(), static_cast<std::uint64_t>(
+                    std::filesystem::file_size(filenames[0]) + std::filesystem::file_size(filenames[1])));
+            }
+            CHECK(readFile(filenames[0]) == streamedText(first, altitude));
+            CHECK(readFile(filenames[1]) == streamedText(second, altitude));
+        }
+    }
+    std::filesystem::remove_all(directory);
+}
+
+// The binary file holds the documented header, the record count of every UAV and the records at
+// the start of every UAV block, in float64 or float32.
+TEST_CASE(writer, binary_layout) {
+    std::filesystem::path directory = testDirectory("writer_binary");
+    std::vector<TrajectorySample> first = testSamples(3);
+    std::vector<TrajectorySample> second = testSamples(4);
+    second.resize(50);
+    for (int precision : { 64, 32 }) {
+        std::string filename = (directory / "UAVTrajectories.bin").string();
+        const std::size_t capacity = BinaryTrajectoryWriter::recordsForDuration(2.0, 0.01);
+        CHECK_EQUAL(capacity, 203u);
+        {
+            BinaryTrajectoryWriter writer(precision);
+            CHECK(writer.open(filename, 2, 0.01, capacity));
+            for (std::size_t k = 0; k < first.size(); ++k) {
+                writer.record(0, first[k]);
+                if (k < second.size()) {
+                    writer.record(1, second[k]);
+                }
+            }
+            writer.close();
+        }
+
+        std::string content = readFile(filename);
+        const std::size_t valueSize = precision == 32 ? sizeof(float) : sizeof(double);
+        const std::size_t recordSize = sizeof(double) + 3 * valueSize;
+        CHECK_EQUAL(content.size(), 4096 + 2 * capacity * recordSize);
+        if (content.size() != 4096 + 2 * capacity * recordSize) {
+            continue;
+        }
+        BinaryTrajectoryHeader header;
+        std::memcpy(&header, content.data(), sizeof(header));
+        CHECK(std::memcmp(header.magic, "UAVTRAJ", 8) == 0);
+        CHECK_EQUAL(header.version, 1u);
+        CHECK_EQUAL(header.nUav, 2u);
+        CHECK_EQUAL(header.recordSize, recordSize);
+        CHECK_EQUAL(header.fieldCount, 4u);
+        CHECK_EQUAL(header.dt, 0.01);
+        CHECK_EQUAL(header.capacity, capacity);
+        CHECK_EQUAL(header.countsOffset, sizeof(header));
+        CHECK_EQUAL(header.dataOffset, 4096u);
+        CHECK_EQUAL(std::string(header.fields),
+            std::string(precision == 32 ? "time:<f8,x:<f4,y:<f4,azimuth:<f4" : "time:<f8,x:<f8,y:<f8,azimuth:<f8"));
+
+        std::uint64_t counts[2];
+        std::memcpy(counts, content.data() + header.countsOffset, sizeof(counts));
+        CHECK_EQUAL(counts[0], first.size());
+        CHECK_EQUAL(counts[1], second.size());
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < 2; ++i) {
+            const std::vector<TrajectorySample>& samples = i == 0 ? first : second;
+            for (std::size_t k = 0; k < samples.size(); ++k) {
+                const char* record = content.data() + header.dataOffset + (i * capacity + k) * recordSize;
+                const TrajectorySample& sample = samples[k];
+                double time;
+                std::memcpy(&time, record, sizeof(time));
+                bool same = time == sample.time;
+                if (precision == 32) {
+                    float values[3];
+                    std::memcpy(values, record + sizeof(double), sizeof(values));
+                    same = same && values[0] == static_cast<float>(sample.x) && values[1] == static_cast<float>(sample.y) &&
+                        values[2] == static_cast<float>(sample.azimuth);
+                }
+                else {
+                    double values[3];
+                    std::memcpy(values, record + sizeof(double), sizeof(values));
+                    same = same && values[0] == sample.x && values[1] == sample.y && values[2] == sample.azimuth;
+                }
+                mismatches += same ? 0 : 1;
+            }
+        }
+        CHECK_EQUAL(mismatches, 0u);
+    }
+    std::filesystem::remove_all(directory);
+}